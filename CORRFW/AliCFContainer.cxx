@@ -123,6 +123,31 @@ void AliCFContainer::Fill(const Double_t *var, Int_t istep, Double_t weight)
   fGrid[istep]->Fill(var,weight);
 }
 
+//____________________________________________________________________
+void AliCFContainer::FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weights)
+{
+  //
+  // Fills the grid at selection step istep with n entries,
+  // var contains the GetNVar() values of the input variables of each entry
+  // and weights the weight of each entry (by default w=1)
+  //
+  if(istep >= fNStep || istep < 0){
+    AliError("Non-existent selection step, grid was not filled");
+    return;
+  }
+  fGrid[istep]->FillN(n,var,weights);
+}
+
+//____________________________________________________________________
+void AliCFContainer::SetStorage(Int_t storage, Double_t occupancy)
+{
+  //
+  // Sets the storage of the filled entries of all the steps
+  // (see AliCFGridSparse::SetStorage())
+  //
+  for (Int_t istep=0; istep<fNStep; istep++) fGrid[istep]->SetStorage(storage,occupancy);
+}
+
 //____________________________________________________________________
 TH1* AliCFContainer::Project(Int_t istep, Int_t ivar1, Int_t ivar2, Int_t ivar3) const
 {
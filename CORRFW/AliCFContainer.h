@@ -62,6 +62,8 @@ class AliCFContainer : public AliCFFrame
   virtual Int_t GetNStep() const {return fNStep;};
   virtual void  SetNStep(Int_t nStep) {fNStep=nStep;}
   virtual void  Fill(const Double_t *var, Int_t istep, Double_t weight=1.) ;
+  virtual void  FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weights=0x0) ;
+  virtual void  SetStorage(Int_t storage, Double_t occupancy=0.2) ; // see AliCFGridSparse::EStorage
 
   virtual Float_t  GetOverFlows (Int_t var,Int_t istep,Bool_t excl=kFALSE) const;
   virtual Float_t  GetUnderFlows(Int_t var,Int_t istep,Bool_t excl=kFALSE) const ;
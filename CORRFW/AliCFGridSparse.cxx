@@ -33,8 +33,14 @@
 #include "TH2D.h"
 #include "TH3D.h"
 #include "TAxis.h"
+#include "TBuffer.h"
 #include "AliCFUnfolding.h"
 
+namespace {
+  // the dense array is not used for grids with more bins (including under- and overflows)
+  const Long64_t kMaxDenseBins = 5000000;
+}
+
 //____________________________________________________________________
 ClassImp(AliCFGridSparse)
 
@@ -42,7 +48,23 @@ ClassImp(AliCFGridSparse)
 AliCFGridSparse::AliCFGridSparse() : 
   AliCFFrame(),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fStorage(kSparse),
+  fDenseOccupancy(0.2),
+  fDenseActive(kFALSE),
+  fDenseFloat(kFALSE),
+  fDenseErrors(kFALSE),
+  fDenseEntries(0.),
+  fDenseValues(),
+  fDenseSumw2(),
+  fDenseFilled(),
+  fDenseFillOrder(),
+  fKernelNBinsTotal(0),
+  fKernelAxis(),
+  fKernelNBins(),
+  fKernelFixed(),
+  fKernelMin(),
+  fKernelMax()
 {
   // default constructor
 }
@@ -50,7 +72,23 @@ AliCFGridSparse::AliCFGridSparse() :
 AliCFGridSparse::AliCFGridSparse(const Char_t* name, const Char_t* title) : 
   AliCFFrame(name,title),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fStorage(kSparse),
+  fDenseOccupancy(0.2),
+  fDenseActive(kFALSE),
+  fDenseFloat(kFALSE),
+  fDenseErrors(kFALSE),
+  fDenseEntries(0.),
+  fDenseValues(),
+  fDenseSumw2(),
+  fDenseFilled(),
+  fDenseFillOrder(),
+  fKernelNBinsTotal(0),
+  fKernelAxis(),
+  fKernelNBins(),
+  fKernelFixed(),
+  fKernelMin(),
+  fKernelMax()
 {
   // default constructor
 }
@@ -58,7 +96,23 @@ AliCFGridSparse::AliCFGridSparse(const Char_t* name, const Char_t* title) :
 AliCFGridSparse::AliCFGridSparse(const Char_t* name, const Char_t* title, Int_t nVarIn, const Int_t * nBinIn) :  
   AliCFFrame(name,title),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fStorage(kSparse),
+  fDenseOccupancy(0.2),
+  fDenseActive(kFALSE),
+  fDenseFloat(kFALSE),
+  fDenseErrors(kFALSE),
+  fDenseEntries(0.),
+  fDenseValues(),
+  fDenseSumw2(),
+  fDenseFilled(),
+  fDenseFillOrder(),
+  fKernelNBinsTotal(0),
+  fKernelAxis(),
+  fKernelNBins(),
+  fKernelFixed(),
+  fKernelMin(),
+  fKernelMax()
 {
   //
   // main constructor
@@ -80,7 +134,23 @@ AliCFGridSparse::~AliCFGridSparse()
 AliCFGridSparse::AliCFGridSparse(const AliCFGridSparse& c) :
   AliCFFrame(c),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fStorage(kSparse),
+  fDenseOccupancy(0.2),
+  fDenseActive(kFALSE),
+  fDenseFloat(kFALSE),
+  fDenseErrors(kFALSE),
+  fDenseEntries(0.),
+  fDenseValues(),
+  fDenseSumw2(),
+  fDenseFilled(),
+  fDenseFillOrder(),
+  fKernelNBinsTotal(0),
+  fKernelAxis(),
+  fKernelNBins(),
+  fKernelFixed(),
+  fKernelMin(),
+  fKernelMax()
 {
   //
   // copy constructor
@@ -104,6 +174,7 @@ void AliCFGridSparse::SetBinLimits(Int_t ivar, Double_t min, Double_t max)
   //
   // set a uniform binning for variable ivar
   //
+  FlushDense();
   Int_t nBins = GetNBins(ivar);
   Double_t * array = new Double_t[nBins+1];
   for (Int_t iEdge=0; iEdge<=nBins; iEdge++) array[iEdge] = min + iEdge * (max-min)/nBins ;
@@ -117,6 +188,7 @@ void AliCFGridSparse::SetBinLimits(Int_t ivar, const Double_t *array)
   //
   // setting the arrays containing the bin limits 
   //
+  FlushDense();
   fData->SetBinEdges(ivar, array);
 } 
 
@@ -128,7 +200,196 @@ void AliCFGridSparse::Fill(const Double_t *var, Double_t weight)
   // given a set of values of the input variable, 
   // with weight (by default w=1)
   //
-  fData->Fill(var,weight);
+  if (fStorage!=kSparse && !fDenseActive) {
+    if (fStorage==kDense) MakeDense();
+    else if (BuildKernel() && fData->GetNbins() >= fDenseOccupancy*fKernelNBinsTotal) MakeDense();
+  }
+  if (fDenseActive) FillDense(var,weight);
+  else fData->Fill(var,weight);
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::FillN(Int_t n, const Double_t *var, const Double_t *weights)
+{
+  //
+  // Fill the grid with n entries,
+  // var contains the GetNVar() values of the input variables of each entry,
+  // weights the weight of each entry (by default w=1)
+  //
+  const Int_t nVar = GetNVar();
+  for (Int_t i=0; i<n; i++) Fill(var+i*nVar, weights ? weights[i] : 1.);
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::SetStorage(Int_t storage, Double_t occupancy)
+{
+  //
+  // Sets the storage of the filled entries (see EStorage):
+  // kSparse fills the THnSparse, kDense fills a dense array of all the bins,
+  // kAuto fills the THnSparse until the fraction of filled bins exceeds occupancy
+  // and the dense array afterwards.
+  // The entries of the dense array are copied into the THnSparse (FlushDense())
+  // before any other use of the grid: projections, efficiencies, merging and
+  // output are computed from the THnSparse. The bin contents, errors, entries and
+  // bin allocation order are the ones of a filled THnSparse; the sums of the weights
+  // and weighted values of the THnSparse are not updated.
+  //
+  FlushDense();
+  if (storage<kSparse || storage>kAuto) {
+    AliError(Form("Unknown storage %d, using the THnSparse",storage));
+    storage=kSparse;
+  }
+  fStorage=storage;
+  fDenseOccupancy=occupancy;
+}
+
+//____________________________________________________________________
+Bool_t AliCFGridSparse::BuildKernel() const
+{
+  //
+  // Caches the binning of the axes used to compute the index in the dense array.
+  // Returns false if the grid has too many bins for a dense array
+  //
+  if (fKernelNBinsTotal>0) return fKernelNBinsTotal<=kMaxDenseBins;
+  const Int_t nVar = GetNVar();
+  fKernelAxis .resize(nVar);
+  fKernelNBins.resize(nVar);
+  fKernelFixed.resize(nVar);
+  fKernelMin  .resize(nVar);
+  fKernelMax  .resize(nVar);
+  fKernelNBinsTotal=1;
+  for (Int_t iVar=0; iVar<nVar; iVar++) {
+    TAxis* axis = fData->GetAxis(iVar);
+    fKernelAxis [iVar] = axis;
+    fKernelNBins[iVar] = axis->GetNbins();
+    fKernelFixed[iVar] = (axis->GetXbins()->GetSize()==0);
+    fKernelMin  [iVar] = axis->GetXmin();
+    fKernelMax  [iVar] = axis->GetXmax();
+    if (fKernelNBinsTotal<=kMaxDenseBins) fKernelNBinsTotal *= fKernelNBins[iVar]+2;
+  }
+  return fKernelNBinsTotal<=kMaxDenseBins;
+}
+
+//____________________________________________________________________
+Long64_t AliCFGridSparse::GetDenseIndex(const Double_t *var) const
+{
+  //
+  // Index in the dense array of the bin containing var,
+  // each axis has GetNBins()+2 bins (under- and overflow included).
+  // The bin of each variable is the one of TAxis::FindFixBin()
+  //
+  Long64_t index=0;
+  for (UInt_t iVar=0; iVar<fKernelAxis.size(); iVar++) {
+    const Int_t nBins = fKernelNBins[iVar];
+    const Double_t x = var[iVar];
+    Int_t bin;
+    if (!fKernelFixed[iVar]) bin = fKernelAxis[iVar]->FindFixBin(x);
+    else if (x < fKernelMin[iVar]) bin = 0;
+    else if (!(x < fKernelMax[iVar])) bin = nBins+1;
+    else bin = 1 + int(nBins*(x-fKernelMin[iVar])/(fKernelMax[iVar]-fKernelMin[iVar]));
+    index = index*(nBins+2) + bin;
+  }
+  return index;
+}
+
+//____________________________________________________________________
+Bool_t AliCFGridSparse::MakeDense()
+{
+  //
+  // Creates the dense array from the content of the THnSparse
+  //
+  if (!BuildKernel()) {
+    AliError(Form("%s: %lld bins are too many for the dense storage, using the THnSparse",GetName(),fKernelNBinsTotal));
+    fStorage=kSparse;
+    return kFALSE;
+  }
+  fDenseFloat  = (dynamic_cast<THnSparseF*>(fData)!=0x0);
+  fDenseErrors = fData->GetCalculateErrors();
+  fDenseEntries= 0.;
+  fDenseValues.assign(fKernelNBinsTotal,0.);
+  if (fDenseErrors) fDenseSumw2.assign(fKernelNBinsTotal,0.);
+  fDenseFilled.assign(fKernelNBinsTotal,0);
+  fDenseFillOrder.clear();
+
+  const Int_t nVar = GetNVar();
+  Int_t* bin = new Int_t[nVar];
+  for (Long64_t i=0; i<fData->GetNbins(); i++) {
+    Double_t v = fData->GetBinContent(i,bin);
+    Long64_t index=0;
+    for (Int_t iVar=0; iVar<nVar; iVar++) index = index*(fKernelNBins[iVar]+2) + bin[iVar];
+    fDenseValues[index] = v;
+    if (fDenseErrors) fDenseSumw2[index] = fData->GetBinError2(i);
+  }
+  delete [] bin;
+  fDenseActive=kTRUE;
+  return kTRUE;
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::FillDense(const Double_t *var, Double_t weight)
+{
+  //
+  // Fills the dense array with the arithmetic of THnSparse::Fill()
+  //
+  const Long64_t index = GetDenseIndex(var);
+  if (!fDenseFilled[index]) {
+    fDenseFilled[index]=1;
+    fDenseFillOrder.push_back(index);
+  }
+  if (fDenseFloat) fDenseValues[index] = (Float_t)(fDenseValues[index] + weight);
+  else fDenseValues[index] += weight;
+  if (fDenseErrors) fDenseSumw2[index] += weight*weight;
+  fDenseEntries++;
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::FlushDense() const
+{
+  //
+  // Copies the bins filled in the dense array into the THnSparse
+  // and releases the dense array (recreated by the next Fill())
+  //
+  fKernelNBinsTotal=0;
+  if (!fDenseActive) return;
+  fDenseActive=kFALSE;
+
+  const Int_t nVar = GetNVar();
+  Int_t* bin = new Int_t[nVar];
+  const Double_t entries = fData->GetEntries();
+  for (UInt_t i=0; i<fDenseFillOrder.size(); i++) {
+    const Long64_t index = fDenseFillOrder[i];
+    Long64_t rest = index;
+    for (Int_t iVar=nVar-1; iVar>=0; iVar--) {
+      bin[iVar] = rest % (fKernelNBins[iVar]+2);
+      rest /= fKernelNBins[iVar]+2;
+    }
+    Long64_t sparseBin = fData->GetBin(bin,kTRUE);
+    fData->SetBinContent(sparseBin,fDenseValues[index]);
+    if (fDenseErrors) fData->SetBinError2(sparseBin,fDenseSumw2[index]);
+  }
+  fData->SetEntries(entries+fDenseEntries);
+  delete [] bin;
+
+  std::vector<Double_t>().swap(fDenseValues);
+  std::vector<Double_t>().swap(fDenseSumw2);
+  std::vector<Char_t>  ().swap(fDenseFilled);
+  std::vector<Long64_t>().swap(fDenseFillOrder);
+  fDenseEntries=0.;
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::Streamer(TBuffer &R__b)
+{
+  //
+  // Stream an object of class AliCFGridSparse,
+  // the entries of the dense array are copied into the THnSparse before writing
+  //
+  if (R__b.IsReading()) {
+    R__b.ReadClassBuffer(AliCFGridSparse::Class(),this);
+  } else {
+    FlushDense();
+    R__b.WriteClassBuffer(AliCFGridSparse::Class(),this);
+  }
 }
 
 //___________________________________________________________________
@@ -139,6 +400,7 @@ AliCFGridSparse* AliCFGridSparse::MakeSlice(Int_t nVars, const Int_t* vars, cons
   // axis ranges can be defined in arrays varMin, varMax
   // If useBins=true, varMin and varMax are taken as bin numbers
   //
+  FlushDense();
 
   // binning for new grid
   Int_t* bins = new Int_t[nVars];
@@ -192,6 +454,7 @@ Float_t AliCFGridSparse::GetEntries() const
   // total entries (including overflows and underflows)
   //
 
+  FlushDense();
   return fData->GetEntries();
 }
 
@@ -202,6 +465,7 @@ Float_t AliCFGridSparse::GetElement(Long_t index) const
   // Returns content of grid element index 
   //
   
+  FlushDense();
   return fData->GetBinContent(index);
 }
 //____________________________________________________________________
@@ -210,6 +474,7 @@ Float_t AliCFGridSparse::GetElement(const Int_t *bin) const
   //
   // Get the content in a bin corresponding to a set of bin indexes
   //
+  FlushDense();
   return fData->GetBinContent(bin);
 
 }  
@@ -220,6 +485,7 @@ Float_t AliCFGridSparse::GetElement(const Double_t *var) const
   // Get the content in a bin corresponding to a set of input variables
   //
 
+  FlushDense();
   Long_t index = fData->GetBin(var,kFALSE);
   if (index<0) return 0.;
   return fData->GetBinContent(index);
@@ -232,6 +498,7 @@ Float_t AliCFGridSparse::GetElementError(Long_t index) const
   // Returns the error on the content 
   //
 
+  FlushDense();
   return fData->GetBinError(index);
 }
 //____________________________________________________________________
@@ -240,6 +507,7 @@ Float_t AliCFGridSparse::GetElementError(const Int_t *bin) const
  //
   // Get the error in a bin corresponding to a set of bin indexes
   //
+  FlushDense();
   return fData->GetBinError(bin);
 
 }  
@@ -250,6 +518,7 @@ Float_t AliCFGridSparse::GetElementError(const Double_t *var) const
   // Get the error in a bin corresponding to a set of input variables
   //
 
+  FlushDense();
   Long_t index=fData->GetBin(var,kFALSE); //this is the THnSparse index (do not allocate new cells if content is empy)
   if (index<0) return 0.;
   return fData->GetBinError(index);
@@ -261,6 +530,7 @@ void AliCFGridSparse::SetElement(Long_t index, Float_t val)
   //
   // Sets grid element value
   //
+  FlushDense();
   Int_t* bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin); //affects the bin coordinates
   SetElement(bin,val);
@@ -273,6 +543,7 @@ void AliCFGridSparse::SetElement(const Int_t *bin, Float_t val)
   //
   // Sets grid element of bin indeces bin to val
   //
+  FlushDense();
   fData->SetBinContent(bin,val);
 }
 //____________________________________________________________________
@@ -281,6 +552,7 @@ void AliCFGridSparse::SetElement(const Double_t *var, Float_t val)
   //
   // Set the content in a bin to value val corresponding to a set of input variables
   //
+  FlushDense();
   Long_t index=fData->GetBin(var,kTRUE); //THnSparse index: allocate the cell
   Int_t *bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin); //trick to access the array of bins
@@ -294,6 +566,7 @@ void AliCFGridSparse::SetElementError(Long_t index, Float_t val)
   //
   // Sets grid element iel error to val (linear indexing) in AliCFFrame
   //
+  FlushDense();
   Int_t *bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin);
   SetElementError(bin,val);
@@ -306,6 +579,7 @@ void AliCFGridSparse::SetElementError(const Int_t *bin, Float_t val)
   //
   // Sets grid element error of bin indeces bin to val
   //
+  FlushDense();
   fData->SetBinError(bin,val);
 }
 //____________________________________________________________________
@@ -314,6 +588,7 @@ void AliCFGridSparse::SetElementError(const Double_t *var, Float_t val)
   //
   // Set the error in a bin to value val corresponding to a set of input variables
   //
+  FlushDense();
   Long_t index=fData->GetBin(var); //THnSparse index
   Int_t *bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin); //trick to access the array of bins
@@ -327,6 +602,7 @@ void AliCFGridSparse::SumW2()
   //
   //set calculation of the squared sum of the weighted entries
   //
+  FlushDense();
   if(!fSumW2){
     fData->CalculateErrors(kTRUE); 
   }
@@ -340,6 +616,7 @@ void AliCFGridSparse::Add(const AliCFGridSparse* aGrid, Double_t c)
   //add aGrid to the current one
   //
 
+  FlushDense();
   if (aGrid->GetNVar() != GetNVar()){
     AliError("Different number of variables, cannot add the grids");
     return;
@@ -356,6 +633,7 @@ void AliCFGridSparse::Add(const AliCFGridSparse* aGrid1, const AliCFGridSparse*
   //Add aGrid1 and aGrid2 and deposit the result into the current one
   //
 
+  FlushDense();
   if (GetNVar() != aGrid1->GetNVar() || GetNVar() != aGrid2->GetNVar()) {
     AliInfo("Different number of variables, cannot add the grids");
     return;
@@ -375,6 +653,7 @@ void AliCFGridSparse::Multiply(const AliCFGridSparse* aGrid, Double_t c)
   // Multiply aGrid to the current one
   //
 
+  FlushDense();
   if (aGrid->GetNVar() != GetNVar()) {
     AliError("Different number of variables, cannot multiply the grids");
     return;
@@ -393,6 +672,7 @@ void AliCFGridSparse::Multiply(const AliCFGridSparse* aGrid1, const AliCFGridSpa
   //Multiply aGrid1 and aGrid2 and deposit the result into the current one
   //
 
+  FlushDense();
   if (GetNVar() != aGrid1->GetNVar() || GetNVar() != aGrid2->GetNVar()) {
     AliError("Different number of variables, cannot multiply the grids");
     return;
@@ -415,6 +695,7 @@ void AliCFGridSparse::Divide(const AliCFGridSparse* aGrid, Double_t c)
   // Divide aGrid to the current one
   //
 
+  FlushDense();
   if (aGrid->GetNVar() != GetNVar()) {
     AliError("Different number of variables, cannot divide the grids");
     return;
@@ -436,6 +717,7 @@ void AliCFGridSparse::Divide(const AliCFGridSparse* aGrid1, const AliCFGridSpars
   //binomial errors are supported
   //
 
+  FlushDense();
   if (GetNVar() != aGrid1->GetNVar() || GetNVar() != aGrid2->GetNVar()) {
     AliError("Different number of variables, cannot divide the grids");
     return;
@@ -458,6 +740,7 @@ void AliCFGridSparse::Rebin(const Int_t* group)
   // a given axis has to be divisible by the rebin group.
   //
 
+  FlushDense();
   for(Int_t i=0;i<GetNVar();i++){
     if (group[i]!=1) AliInfo(Form(" merging bins along dimension %i in groups of %i bins", i,group[i]));
   }
@@ -553,6 +836,7 @@ Double_t AliCFGridSparse::GetIntegral() const
   //
   // Get full Integral
   //
+  FlushDense();
   return fData->ComputeIntegral();  
 } 
 
@@ -564,6 +848,7 @@ Long64_t AliCFGridSparse::Merge(TCollection* list)
   // Returns the number of merged objects (including this).
   //
 
+  FlushDense();
   if (!list)
     return 0;
   
@@ -603,9 +888,14 @@ void AliCFGridSparse::Copy(TObject& c) const
   //
   // copy function
   //
+  FlushDense();
   AliCFFrame::Copy(c);
   AliCFGridSparse& target = (AliCFGridSparse &) c;
   target.fSumW2 = fSumW2 ;
+  target.fStorage = fStorage ;
+  target.fDenseOccupancy = fDenseOccupancy ;
+  target.fDenseActive = kFALSE ;
+  target.fKernelNBinsTotal = 0 ;
   if (fData) {
     target.fData = (THnSparse*)fData->Clone();
   }
@@ -621,6 +911,7 @@ TH1* AliCFGridSparse::Slice(Int_t iVar1, Int_t iVar2, Int_t iVar3, const Double_
   // If useBins=true, varMin and varMax are taken as bin numbers
   // if varmin or varmax point to null, all the range is taken, including over- and underflows
 
+  FlushDense();
   THnSparse* clone = (THnSparse*)fData->Clone();
   if (varMin != 0x0 && varMax != 0x0) {
     for (Int_t iAxis=0; iAxis<GetNVar(); iAxis++) SetAxisRange(clone->GetAxis(iAxis),varMin[iAxis],varMax[iAxis],useBins);
@@ -746,6 +1037,7 @@ Float_t AliCFGridSparse::GetOverFlows(Int_t ivar, Bool_t exclusive) const
   // Returns overflows in variable ivar
   // Set 'exclusive' to true for an exclusive check on variable ivar
   //
+  FlushDense();
   Int_t* bin = new Int_t[GetNVar()];
   memset(bin, 0, sizeof(Int_t) * GetNVar());
   Float_t ovfl=0.;
@@ -772,6 +1064,7 @@ Float_t AliCFGridSparse::GetUnderFlows(Int_t ivar, Bool_t exclusive) const
   // Returns exclusive overflows in variable ivar
   // Set 'exclusive' to true for an exclusive check on variable ivar
   //
+  FlushDense();
   Int_t* bin = new Int_t[GetNVar()];
   memset(bin, 0, sizeof(Int_t) * GetNVar());
   Float_t unfl=0.;
@@ -798,6 +1091,7 @@ void AliCFGridSparse::Smooth() {
   // smoothing function: TO USE WITH CARE
   //
 
+  FlushDense();
   AliInfo("Your GridSparse is going to be smoothed");
   AliInfo(Form("N TOTAL  BINS : %li",GetNBinsTotal()));
   AliInfo(Form("N FILLED BINS : %li",GetNFilledBins()));
@@ -5,9 +5,11 @@
 // AliCFGridSparse.cxx Class                                          //
 // Class to handle N-dim maps for the correction Framework            // 
 // uses a THnSparse to store the grid                                 //
+// (optionally filled through a dense array, see SetStorage())        //
 // Author:S.Arcelli, silvia.arcelli@cern.ch
 //--------------------------------------------------------------------//
 
+#include <vector>
 #include "AliCFFrame.h"
 #include "THnSparse.h"
 #include "AliLog.h"
@@ -20,6 +22,11 @@ class TH3D;
 class AliCFGridSparse : public AliCFFrame
 {
  public:
+  // storage of the filled entries: the THnSparse, a dense array of all the bins (including
+  // under- and overflows) which is copied into the THnSparse before the grid is used, or
+  // the THnSparse until the fraction of filled bins exceeds a threshold and the dense array afterwards
+  enum EStorage {kSparse=0, kDense, kAuto};
+
   AliCFGridSparse();
   AliCFGridSparse(const Char_t* name, const Char_t* title);
   AliCFGridSparse(const Char_t* name, const Char_t* title, Int_t nVarIn, const Int_t* nBinIn);
@@ -37,7 +44,7 @@ class AliCFGridSparse : public AliCFFrame
   virtual void       GetBinLimits(Int_t ivar, Double_t * array) const ;
   virtual Double_t * GetBinLimits(Int_t ivar) const ;
   virtual Long_t     GetNBinsTotal() const ;
-  virtual Long_t     GetNFilledBins() const {return fData->GetNbins();}
+  virtual Long_t     GetNFilledBins() const {FlushDense(); return fData->GetNbins();}
   virtual Int_t      GetNBins(Int_t ivar) const {return fData->GetAxis(ivar)->GetNbins();}
   virtual Int_t *    GetNBins() const ;
   virtual Float_t    GetBinCenter(Int_t ivar,Int_t ibin) const ;
@@ -56,6 +63,7 @@ class AliCFGridSparse : public AliCFFrame
   //virtual Int_t      GetBinIndex(Int_t ivar, Int_t ind) const ;
 
   virtual void    Fill(const Double_t *var, Double_t weight=1.);
+  virtual void    FillN(Int_t n, const Double_t *var, const Double_t *weights=0x0);
   virtual Float_t GetEntries()const;
   virtual Float_t GetElement(Long_t iel)               const; 
   virtual Float_t GetElement(const Int_t *bin)         const; 
@@ -99,8 +107,13 @@ class AliCFGridSparse : public AliCFFrame
   //virtual Double_t GetIntegral(const Double_t *varMin, const Double_t *varMax) const;
   virtual Long64_t Merge(TCollection* list);
 
-  virtual void     SetGrid(THnSparse* grid) {if (fData) delete fData ; fData=grid;}
-  THnSparse   *    GetGrid() const {return fData;}
+  virtual void     SetGrid(THnSparse* grid) {FlushDense(); if (fData) delete fData ; fData=grid;}
+  THnSparse   *    GetGrid() const {FlushDense(); return fData;}
+
+  virtual void     SetStorage(Int_t storage, Double_t occupancy=0.2);
+  Int_t            GetStorage() const {return fStorage;}
+  Bool_t           IsDense() const {return fDenseActive;}
+  void             FlushDense() const;
 
   virtual Float_t GetOverFlows (Int_t var, Bool_t excl=kFALSE) const;
   virtual Float_t GetUnderFlows(Int_t var, Bool_t excl=kFALSE) const;
@@ -118,12 +131,36 @@ class AliCFGridSparse : public AliCFFrame
   void     SetAxisRange(TAxis* axis, Double_t min, Double_t max, Bool_t useBins) const;
   void     GetProjectionName (TString& s,Int_t var0, Int_t var1=-1, Int_t var2=-1) const;
   void     GetProjectionTitle(TString& s,Int_t var0, Int_t var1=-1, Int_t var2=-1) const;
+  Bool_t   BuildKernel() const;
+  Bool_t   MakeDense();
+  Long64_t GetDenseIndex(const Double_t *var) const;
+  void     FillDense(const Double_t *var, Double_t weight);
 
   // data members:
   Bool_t      fSumW2    ; // Flag to check if calculation of squared weights enabled
   THnSparse  *fData     ; // The data Container: a THnSparse  
-
-  ClassDef(AliCFGridSparse,3);
+  Int_t       fStorage  ; // Storage of the filled entries (EStorage)
+  Double_t    fDenseOccupancy ; // Fraction of filled bins above which kAuto switches to the dense array
+
+  // dense array, the entries filled in it are copied into fData by FlushDense()
+  mutable Bool_t   fDenseActive ; //! Entries are filled into the dense array
+  mutable Bool_t   fDenseFloat  ; //! Contents are rounded to single precision as in a THnSparseF
+  mutable Bool_t   fDenseErrors ; //! Squared weights are summed
+  mutable Double_t fDenseEntries; //! Number of entries filled into the dense array
+  mutable std::vector<Double_t> fDenseValues   ; //! Bin contents
+  mutable std::vector<Double_t> fDenseSumw2    ; //! Sums of squared weights
+  mutable std::vector<Char_t>   fDenseFilled   ; //! Bins filled since the array was created
+  mutable std::vector<Long64_t> fDenseFillOrder; //! Filled bins, in the order of their first entry (allocation order of the THnSparse)
+
+  // bin-index kernel of each axis
+  mutable Long64_t fKernelNBinsTotal ; //! Number of bins of the dense array (0 if not computed)
+  mutable std::vector<TAxis*>   fKernelAxis  ; //! Axes
+  mutable std::vector<Int_t>    fKernelNBins ; //! Number of bins
+  mutable std::vector<Char_t>   fKernelFixed ; //! Uniform binning
+  mutable std::vector<Double_t> fKernelMin   ; //! Lower edge
+  mutable std::vector<Double_t> fKernelMax   ; //! Upper edge
+
+  ClassDef(AliCFGridSparse,4);
 };
 
 
@@ -13,9 +13,22 @@
 #include "AliExternalBDT.h"
 
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 namespace {
   inline bool checkFile (const std::string name) {
@@ -27,6 +40,76 @@ namespace {
       return false;
     }
   }
+
+  /// mkdir -p
+  bool makeDirectory(const std::string &path) {
+    for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+      const std::string dir = path.substr(0, pos);
+      if (mkdir(dir.data(), 0777) != 0 && errno != EEXIST) return false;
+      if (pos == std::string::npos) return true;
+    }
+  }
+
+  void removeDirectory(const std::string &path) {
+    DIR *dir = opendir(path.data());
+    if (!dir) return;
+    while (dirent *entry = readdir(dir)) {
+      const std::string name = entry->d_name;
+      if (name != "." && name != "..") unlink((path + "/" + name).data());
+    }
+    closedir(dir);
+    rmdir(path.data());
+  }
+
+  /// run a program without a shell, returns true if it exits with status 0
+  bool runProgram(const std::vector<std::string> &args) {
+    std::vector<char *> argv;
+    for (const std::string &arg : args) argv.push_back(const_cast<char *>(arg.data()));
+    argv.push_back(nullptr);
+    const pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+      execvp(argv[0], argv.data());
+      _exit(127);
+    }
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+      if (errno != EINTR) return false;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+
+  /// split the compiler flags into arguments, only optimisation, machine, code generation,
+  /// warning, debug and macro options made of plain characters are accepted
+  bool splitCompilerFlags(const std::string &flags, std::vector<std::string> &args) {
+    static const char *allowed[] = {"-O", "-m", "-f", "-g", "-W", "-D", "-U", "-std=", "-pipe"};
+    std::istringstream stream(flags);
+    std::string flag;
+    while (stream >> flag) {
+      bool isAllowed = false;
+      for (const char *prefix : allowed) {
+        if (flag.compare(0, strlen(prefix), prefix) == 0) isAllowed = true;
+      }
+      if (flag.compare(0, 8, "-fplugin") == 0) isAllowed = false;
+      for (const char c : flag) {
+        if (!isalnum(static_cast<unsigned char>(c)) && !strchr("-_=.,+:", c)) isAllowed = false;
+      }
+      if (!isAllowed) {
+        std::cerr << "Compiler flag not allowed: " << flag << std::endl;
+        return false;
+      }
+      args.push_back(flag);
+    }
+    return true;
+  }
+
+  /// 64-bit FNV-1a
+  void hashBytes(unsigned long long &hash, const char *data, size_t size) {
+    for (size_t iByte = 0; iByte < size; ++iByte) {
+      hash ^= static_cast<unsigned char>(data[iByte]);
+      hash *= 1099511628211ull;
+    }
+  }
 }
 
 AliExternalBDT::AliExternalBDT(std::string name) :
@@ -35,49 +118,128 @@ AliExternalBDT::AliExternalBDT(std::string name) :
   fModelPath{""},
   fModelName{""},
   fCompiler{},
-  fPredictor{}
+  fPredictor{},
+  fCompilerFlags{"-O1"},
+  fCacheDir{getenv("ALIEXTERNALBDT_CACHE") ? getenv("ALIEXTERNALBDT_CACHE") : "/tmp/aliexternalbdt-cache"},
+  fBackgroundCompilation{false},
+  fBuildThread{},
+  fLibraryReady{false},
+  fEnsemble{},
+  fEntries{},
+  fBatchFeatures{},
+  fBatchScores{}
+{
+}
+
+AliExternalBDT::AliExternalBDT(const AliExternalBDT &source) :
+  fBDTname{source.fBDTname},
+  fModel{source.fModel},
+  fModelPath{source.fModelPath},
+  fModelName{source.fModelName},
+  fCompiler{source.fCompiler},
+  fPredictor{},
+  fCompilerFlags{source.fCompilerFlags},
+  fCacheDir{source.fCacheDir},
+  fBackgroundCompilation{source.fBackgroundCompilation},
+  fBuildThread{},
+  fLibraryReady{false},
+  fEnsemble{source.fEnsemble},
+  fEntries{},
+  fBatchFeatures{},
+  fBatchScores{}
 {
+  /// the copy shares the predictor, so a pending compilation has to be finished first
+  source.WaitForLibrary();
+  fPredictor = source.fPredictor;
+  fLibraryReady.store(source.IsLibraryReady(), std::memory_order_release);
 }
 
+AliExternalBDT &AliExternalBDT::operator=(const AliExternalBDT &source) {
+  if (&source == this) return *this;
+  WaitForLibrary();
+  source.WaitForLibrary();
+  fBDTname = source.fBDTname;
+  fModel = source.fModel;
+  fModelPath = source.fModelPath;
+  fModelName = source.fModelName;
+  fCompiler = source.fCompiler;
+  fPredictor = source.fPredictor;
+  fCompilerFlags = source.fCompilerFlags;
+  fCacheDir = source.fCacheDir;
+  fBackgroundCompilation = source.fBackgroundCompilation;
+  fEnsemble = source.fEnsemble;
+  fLibraryReady.store(source.IsLibraryReady(), std::memory_order_release);
+  return *this;
+}
 
-bool AliExternalBDT::CompileAndLoadModelLibrary() {
-  std::string path = GetUniquePath();
-  if (checkFile(path + "/main.so")) {
-    std::cout << "Library found: " << path.data() << "/main.so . Loading it!" << std::endl;
+AliExternalBDT::~AliExternalBDT() {
+  /// the build thread uses the members, it is joined before any of them is destroyed
+  WaitForLibrary();
+}
+
+bool AliExternalBDT::WaitForLibrary() const {
+  if (fBuildThread.joinable()) fBuildThread.join();
+  return IsLibraryReady();
+}
+
+bool AliExternalBDT::BuildLibrary(const std::string &workDir, const std::string &libPath) {
+  /// the lock serialises the builds of the same model among all the processes of the node
+  const std::string keyDir = libPath.substr(0, libPath.find_last_of('/'));
+  const int lock = open((keyDir + ".lock").data(), O_CREAT | O_RDWR, 0666);
+  if (lock < 0 || flock(lock, LOCK_EX) != 0) {
+    std::cerr << "Cannot lock the model cache entry " << keyDir << std::endl;
+    if (lock >= 0) close(lock);
+    removeDirectory(workDir);
+    return false;
+  }
+  bool status = true;
+  if (checkFile(libPath)) {
+    std::cout << "Library built by another process: " << libPath.data() << " . Loading it!" << std::endl;
   } else {
     std::cout << "Starting the model compilation, depending on the model size it can take a while..." << std::endl;
-    system((std::string("gcc -c -O1 -fPIC ") + path + "/main.c -o " + path + "/main.o && gcc -shared " + path + \
-          "/main.o -o " + path + "/main.so").data());
+    /// the compiler is run without a shell, the flags are passed as separate arguments
+    std::vector<std::string> compile{"gcc", "-c"};
+    status = splitCompilerFlags(fCompilerFlags, compile);
+    compile.insert(compile.end(), {"-fPIC", workDir + "/main.c", "-o", workDir + "/main.o"});
+    const std::vector<std::string> link{"gcc", "-shared", workDir + "/main.o", "-o", workDir + "/main.so"};
+    /// the library is moved into place only once complete, so it is never seen half-written
+    status = status && runProgram(compile) && runProgram(link) && makeDirectory(keyDir) &&
+      rename((workDir + "/main.so").data(), libPath.data()) == 0;
+    if (!status) std::cerr << "Model compilation failed." << std::endl;
   }
-  return LoadModelLibrary(path + "/main.so");
+  flock(lock, LOCK_UN);
+  close(lock);
+  removeDirectory(workDir);
+  return status;
 }
 
-bool AliExternalBDT::CreateModelCode() {
-  std::string path = GetUniquePath();
-  if (checkFile(path + "/main.c")) {
-    std::cout << "Code found: " << path.data() << "/main.c . \
-      Remove it or unset/change the AliExternalBDT name to force its regeneration." << std::endl;
-  } else {
-    const int status_comp = TreeliteCompilerCreate("ast_native", &fCompiler);
-    if (status_comp != 0) {
-      std::cerr << "Compiler creation failed." << std::endl;
-      return false;
-    }
-    const int status_gen = TreeliteCompilerGenerateCode(fCompiler, fModel, 1, path.data());
-    if (status_gen != 0) {
-      std::cerr << "Code generation failed." << std::endl;
-      return false;
-    }
+bool AliExternalBDT::CreateModelCode(const std::string &workDir) {
+  const int status_comp = TreeliteCompilerCreate("ast_native", &fCompiler);
+  if (status_comp != 0) {
+    std::cerr << "Compiler creation failed." << std::endl;
+    return false;
+  }
+  const int status_gen = TreeliteCompilerGenerateCode(fCompiler, fModel, 1, workDir.data());
+  if (status_gen != 0) {
+    std::cerr << "Code generation failed." << std::endl;
+    return false;
   }
   return true;
 }
 
-std::string AliExternalBDT::GetUniquePath() {
-  if (fBDTname.empty()) {
-    return fModelName + std::to_string((unsigned long)this);
-  } else {
-    return fBDTname + "_" + fModelName;
+std::string AliExternalBDT::GetCacheKey(int type) const {
+  std::ifstream model(fModelPath.data(), std::ios::binary);
+  if (!model.is_open()) return "";
+  unsigned long long hash = 14695981039346656037ull;
+  char buffer[1 << 16];
+  while (model.read(buffer, sizeof(buffer)) || model.gcount() > 0) {
+    hashBytes(hash, buffer, model.gcount());
   }
+  const std::string settings = std::to_string(type) + "|gcc|" + fCompilerFlags;
+  hashBytes(hash, settings.data(), settings.size());
+  std::stringstream key;
+  key << fModelName << "-" << std::hex << hash;
+  return key.str();
 }
 
 bool AliExternalBDT::LoadModel(const std::string &path, int type) {
@@ -85,6 +247,9 @@ bool AliExternalBDT::LoadModel(const std::string &path, int type) {
     std::cout << "Invalid empty model path string" << std::endl;
     return false;
   }
+  /// a pending build of a previous model uses the members replaced below
+  WaitForLibrary();
+  fLibraryReady.store(false, std::memory_order_release);
   fModelPath = path;
   fModelName = fModelPath.substr(fModelPath.find_last_of("\\/")+1,fModelPath.size());
   int status = 0;
@@ -103,9 +268,30 @@ bool AliExternalBDT::LoadModel(const std::string &path, int type) {
     std::cerr << "Model loading failed" << std::endl;
     return false;
   }
-  if (!CreateModelCode()) return false;
-  if (!CompileAndLoadModelLibrary()) return false;
-  return true;
+
+  const std::string key = GetCacheKey(type);
+  if (key.empty() || !makeDirectory(fCacheDir)) {
+    std::cerr << "Cannot set up the model cache in " << fCacheDir << std::endl;
+    return false;
+  }
+  const std::string libPath = fCacheDir + "/" + key + "/main.so";
+  if (checkFile(libPath)) {
+    std::cout << "Library found: " << libPath.data() << " . Loading it!" << std::endl;
+    return LoadModelLibrary(libPath);
+  }
+
+  std::stringstream workDir;
+  workDir << fCacheDir << "/" << key << ".tmp." << getpid() << "." << this;
+  if (!CreateModelCode(workDir.str())) return false;
+  if (fBackgroundCompilation && fEnsemble.LoadTreeliteCode(workDir.str() + "/main.c")) {
+    std::cout << "Evaluating the model in memory (" << fEnsemble.GetNTrees() << " trees) until the library is compiled" << std::endl;
+    const std::string dir = workDir.str();
+    fBuildThread = std::thread([this, dir, libPath]() {
+      if (BuildLibrary(dir, libPath)) LoadModelLibrary(libPath);
+    });
+    return true;
+  }
+  return BuildLibrary(workDir.str(), libPath) && LoadModelLibrary(libPath);
 }
 
 bool AliExternalBDT::LoadXGBoostModel(std::string path) {
@@ -118,26 +304,92 @@ bool AliExternalBDT::LoadLightGBMModel(std::string path) {
   return true;
 }
 
+bool AliExternalBDT::LoadTMVAModel(std::string path) {
+  fModelPath = path;
+  fModelName = fModelPath.substr(fModelPath.find_last_of("\\/")+1,fModelPath.size());
+  const bool isClass = fModelPath.size() > 4 && fModelPath.compare(fModelPath.size() - 4, 4, ".cxx") == 0;
+  if (!(isClass ? fEnsemble.LoadTMVAClass(fModelPath) : fEnsemble.LoadTMVAWeights(fModelPath))) {
+    std::cerr << "TMVA model loading failed" << std::endl;
+    return false;
+  }
+  return true;
+}
+
 bool AliExternalBDT::LoadModelLibrary(std::string path) {
   const int status = TreelitePredictorLoad(path.data(), 1, &fPredictor);
   if (status != 0) {
     std::cerr << "Library loading failed" << std::endl;
     return false;
   }
+  fLibraryReady.store(true, std::memory_order_release);
   return true;
 }
 
 double AliExternalBDT::Predict(double *features, int size, bool useRawScore) {
-  std::vector<TreelitePredictorEntry> entries(size);
-  for (size_t iEntry = 0; iEntry < entries.size(); ++iEntry) {
-    entries[iEntry].fvalue = static_cast<float>(features[iEntry]);
+  if (!IsLibraryReady()) {
+    if (fEnsemble.IsLoaded()) return fEnsemble.Predict(features, size, useRawScore);
+    if (!WaitForLibrary()) {
+      std::cerr << "No model loaded" << std::endl;
+      return -999.;
+    }
+  }
+  fEntries.resize(size);
+  for (size_t iEntry = 0; iEntry < fEntries.size(); ++iEntry) {
+    fEntries[iEntry].fvalue = static_cast<float>(features[iEntry]);
   }
   size_t out_size{0u};
   TreelitePredictorQueryResultSizeSingleInst(fPredictor, &out_size);
   assert(out_size == 1);
   float output = 0.f;
-  TreelitePredictorPredictInst(fPredictor, entries.data(),
+  TreelitePredictorPredictInst(fPredictor, fEntries.data(),
       static_cast<int>(useRawScore), &output,
       &out_size);
   return output;
 }
+
+bool AliExternalBDT::PredictBatch(const double *features, int nCandidates, int nFeatures, double *scores, bool useRawScore) {
+  if (nCandidates <= 0) return true;
+  const size_t nRows = static_cast<size_t>(nCandidates);
+  const size_t nCols = static_cast<size_t>(nFeatures);
+
+  if (!IsLibraryReady()) {
+    if (fEnsemble.IsLoaded()) {
+      fEnsemble.PredictBatch(features, nCandidates, nFeatures, scores, useRawScore);
+      return true;
+    }
+    if (!WaitForLibrary()) {
+      std::cerr << "No model loaded" << std::endl;
+      return false;
+    }
+  }
+
+  /// treelite dense batches are row-major: transpose once into the reused buffer
+  fBatchFeatures.resize(nRows * nCols);
+  for (size_t iCol = 0; iCol < nCols; ++iCol) {
+    const double *column = features + iCol * nRows;
+    for (size_t iRow = 0; iRow < nRows; ++iRow) {
+      fBatchFeatures[iRow * nCols + iCol] = static_cast<float>(column[iRow]);
+    }
+  }
+
+  DenseBatchHandle batch;
+  if (TreeliteAssembleDenseBatch(fBatchFeatures.data(), std::numeric_limits<float>::quiet_NaN(), nRows, nCols, &batch) != 0) {
+    std::cerr << "Dense batch assembly failed" << std::endl;
+    return false;
+  }
+  size_t out_size{0u};
+  TreelitePredictorQueryResultSize(fPredictor, batch, 0, &out_size);
+  assert(out_size == nRows);
+  fBatchScores.resize(out_size);
+  const int status = TreelitePredictorPredictBatch(fPredictor, batch, 0, 0, static_cast<int>(useRawScore),
+      fBatchScores.data(), &out_size);
+  TreeliteDeleteDenseBatch(batch);
+  if (status != 0) {
+    std::cerr << "Batch prediction failed" << std::endl;
+    return false;
+  }
+  for (size_t iRow = 0; iRow < nRows; ++iRow) {
+    scores[iRow] = fBatchScores[iRow];
+  }
+  return true;
+}
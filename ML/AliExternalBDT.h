@@ -17,24 +17,51 @@
 
 #include "treelite/c_api.h"
 #include "treelite/c_api_runtime.h"
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "AliMLTreeEnsemble.h"
+
 class AliExternalBDT {
 public:
   AliExternalBDT(std::string name = "");
-  virtual ~AliExternalBDT(){};
+  AliExternalBDT(const AliExternalBDT &source);
+  AliExternalBDT &operator=(const AliExternalBDT &source);
+  virtual ~AliExternalBDT();
 
   bool LoadLightGBMModel(std::string path);
   bool LoadModelLibrary(std::string path);
   bool LoadXGBoostModel(std::string path);
+  /// TMVA BDTs are evaluated in memory, from the weight file (*.weights.xml) or
+  /// from the source of the class generated by TMVA (*.class.cxx)
+  bool LoadTMVAModel(std::string path);
+
+  /// Flags used to compile the model library (default "-O1"), e.g. "-O2 -march=native".
+  /// They are part of the cache key, so different flags give different libraries.
+  /// The compiler is run without a shell; only -O, -m, -f (except -fplugin), -g, -W, -D, -U,
+  /// -std= and -pipe options made of plain characters are accepted.
+  void SetCompilerFlags(std::string flags) { fCompilerFlags = flags; }
+  /// Directory of the compiled model cache, shared by all the jobs running on a node.
+  /// Defaults to $ALIEXTERNALBDT_CACHE or /tmp/aliexternalbdt-cache.
+  void SetCacheDirectory(std::string path) { fCacheDir = path; }
+  /// If enabled, a missing library is compiled in a background thread and the model is
+  /// evaluated in memory until the library is ready.
+  void SetBackgroundCompilation(bool background = true) { fBackgroundCompilation = background; }
+  bool IsLibraryReady() const { return fLibraryReady.load(std::memory_order_acquire); }
+  /// block until a pending background compilation is done, returns true if the library is loaded
+  bool WaitForLibrary() const;
 
   double Predict(double *features, int size, bool useRaw = false);
+  /// Score nCandidates in one treelite batch call. Features are column-major:
+  /// features[iFeature * nCandidates + iCandidate]. Returns false on failure.
+  bool PredictBatch(const double *features, int nCandidates, int nFeatures, double *scores, bool useRaw = false);
 
 private:
-  bool CompileAndLoadModelLibrary();
-  bool CreateModelCode();
-  std::string GetUniquePath();
+  bool BuildLibrary(const std::string &workDir, const std::string &libPath);
+  bool CreateModelCode(const std::string &workDir);
+  std::string GetCacheKey(int type) const;
   bool LoadModel(const std::string &path, int type);
 
   std::string fBDTname;       /// Unique name of this external BDT handler
@@ -43,6 +70,17 @@ private:
   std::string fModelName;
   CompilerHandle fCompiler;
   PredictorHandle fPredictor;
+
+  std::string fCompilerFlags;        /// flags passed to the compiler of the model library
+  std::string fCacheDir;             /// directory of the compiled model cache
+  bool fBackgroundCompilation;       /// compile the library in a background thread
+  mutable std::thread fBuildThread;  /// background compilation of the model library
+  std::atomic<bool> fLibraryReady;   /// set once fPredictor can be used
+  AliMLTreeEnsemble fEnsemble;       /// in-memory evaluator (TMVA models, or treelite models while the library is compiled)
+
+  std::vector<TreelitePredictorEntry> fEntries;  /// buffer reused by Predict
+  std::vector<float> fBatchFeatures;             /// row-major buffer reused by PredictBatch
+  std::vector<float> fBatchScores;               /// output buffer reused by PredictBatch
 };
 
 #endif
@@ -84,7 +84,8 @@ bool AliMLModelHandler::CompileModel() {
 
   std::map<std::string, int> libraryMap = {{"kXGBoost", AliMLModelHandler::kXGBoost}, 
                                            {"kLightGBM", AliMLModelHandler::kLightGBM},
-                                           {"kModelLibrary", AliMLModelHandler::kModelLibrary}};
+                                           {"kModelLibrary", AliMLModelHandler::kModelLibrary},
+                                           {"kTMVA", AliMLModelHandler::kTMVA}};
 
   std::string localpath = ImportFile(fPath);
 
@@ -101,6 +102,10 @@ bool AliMLModelHandler::CompileModel() {
       return fModel->LoadModelLibrary(localpath.data());
       break;
     }
+    case kTMVA: {
+      return fModel->LoadTMVAModel(localpath.data());
+      break;
+    }
     default: {
       return fModel->LoadXGBoostModel(localpath.data());
       break;
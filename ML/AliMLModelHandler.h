@@ -25,7 +25,7 @@ class AliExternalBDT;
 
 class AliMLModelHandler : public TNamed {
 public:
-  enum {kXGBoost, kLightGBM, kModelLibrary};
+  enum {kXGBoost, kLightGBM, kModelLibrary, kTMVA};
 
   AliMLModelHandler();
   AliMLModelHandler(const YAML::Node &node);
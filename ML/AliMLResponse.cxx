@@ -29,7 +29,8 @@ ClassImp(AliMLResponse);
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse()
     : TNamed(), fConfigFilePath{}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{}, fNVariables{},
-      fBinsBegin{}, fRaw{} {
+      fBinsBegin{}, fRaw{}, fVariableIndex{}, fFeatures{}, fBatchBinOffsets{}, fBatchBin{}, fBatchOrder{},
+      fBatchFeatures{}, fBatchScores{} {
   //
   // Default constructor
   //
@@ -38,7 +39,8 @@ AliMLResponse::AliMLResponse()
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse(const Char_t *name, const Char_t *title)
     : TNamed(name, title), fConfigFilePath{""}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{},
-      fNVariables{}, fBinsBegin{}, fRaw{} {
+      fNVariables{}, fBinsBegin{}, fRaw{}, fVariableIndex{}, fFeatures{}, fBatchBinOffsets{}, fBatchBin{},
+      fBatchOrder{}, fBatchFeatures{}, fBatchScores{} {
   //
   // Standard constructor
   //
@@ -55,7 +57,9 @@ AliMLResponse::~AliMLResponse() {
 AliMLResponse::AliMLResponse(const AliMLResponse &source)
     : TNamed(source.GetName(), source.GetTitle()), fConfigFilePath{source.fConfigFilePath}, fModels{source.fModels},
       fCentClasses{source.fCentClasses}, fBins{source.fBins}, fVariableNames{source.fVariableNames},
-      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw} {
+      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{fBins.begin()}, fRaw{source.fRaw},
+      fVariableIndex{source.fVariableIndex}, fFeatures{}, fBatchBinOffsets{}, fBatchBin{}, fBatchOrder{},
+      fBatchFeatures{}, fBatchScores{} {
   //
   // Copy constructor
   //
@@ -76,8 +80,9 @@ AliMLResponse &AliMLResponse::operator=(const AliMLResponse &source) {
   fVariableNames  = source.fVariableNames;
   fNBins          = source.fNBins;
   fNVariables     = source.fNVariables;
-  fBinsBegin      = source.fBinsBegin;
+  fBinsBegin      = fBins.begin();
   fRaw            = source.fRaw;
+  fVariableIndex  = source.fVariableIndex;
 
   return *this;
 }
@@ -120,11 +125,24 @@ void AliMLResponse::CompileModels(std::string configLocalPath) {
 
   fBinsBegin = fBins.begin();
 
+  fVariableIndex.clear();
+  for (int iVar = 0; iVar < (int)fVariableNames.size(); ++iVar) {
+    fVariableIndex[fVariableNames[iVar]] = iVar;
+  }
+  fFeatures.resize(fVariableNames.size());
+
   for (const auto &model : nodeList["MODELS"]) {
     fModels.push_back(AliMLModelHandler{model});
   }
 
   for (auto &model : fModels) {
+    /// optional settings of the compiled model cache
+    if (nodeList["COMPILER_FLAGS"]) {
+      model.GetModel()->SetCompilerFlags(nodeList["COMPILER_FLAGS"].as<string>());
+    }
+    if (nodeList["BACKGROUND_COMPILATION"]) {
+      model.GetModel()->SetBackgroundCompilation(nodeList["BACKGROUND_COMPILATION"].as<bool>());
+    }
     bool comp = model.CompileModel();
     if (!comp) {
       AliFatal("Error in model compilation! Exit");
@@ -151,24 +169,34 @@ int AliMLResponse::FindBin(double binvar) {
 }
 
 //_______________________________________________________________________________
-double AliMLResponse::Predict(double binvar, map<string, double> varmap) {
+int AliMLResponse::FindBinNoWarning(double binvar) const {
+  int bin = std::lower_bound(fBins.begin(), fBins.end(), binvar) - fBins.begin();
+  if (bin == 0 || bin == fNBins) {
+    return -1;
+  }
+  return bin;
+}
+
+//_______________________________________________________________________________
+double AliMLResponse::Predict(double binvar, const map<string, double> &varmap) {
   if ((int)varmap.size() < fNVariables) {
     AliFatal("The variable map you provided to the predictor has a size smaller than the variable list size! Exit");
   }
 
-  vector<double> features;
-  for (const auto &varname : fVariableNames) {
-    if (varmap.find(varname) == varmap.end()) {
-      AliFatal(Form("Variable |%s| not found in variable list provided in config! Exit", varname.data()));
+  fFeatures.resize(fVariableNames.size());
+  for (size_t iVar = 0; iVar < fVariableNames.size(); ++iVar) {
+    auto var = varmap.find(fVariableNames[iVar]);
+    if (var == varmap.end()) {
+      AliFatal(Form("Variable |%s| not found in variable list provided in config! Exit", fVariableNames[iVar].data()));
     }
-    features.push_back(varmap[varname]);
+    fFeatures[iVar] = var->second;
   }
 
   int bin = FindBin(binvar);
   if (bin < 0)
     return -999.;
 
-  return fModels.at(bin - 1).GetModel()->Predict(&features[0], fNVariables, fRaw);
+  return fModels.at(bin - 1).GetModel()->Predict(&fFeatures[0], fNVariables, fRaw);
 }
 
 //_______________________________________________________________________________
@@ -186,7 +214,7 @@ double AliMLResponse::Predict(double binvar, vector<double> variables) {
 }
 
 //_______________________________________________________________________________
-bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap) {
+bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap) {
   double score{0.};
   return IsSelected(binvar, varmap, score);
 }
@@ -195,4 +223,78 @@ bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varm
 bool AliMLResponse::IsSelected(double binvar, std::vector<double> variables) {
   double score{0.};
   return IsSelected(binvar, variables, score);
-}
\ No newline at end of file
+}
+
+//_______________________________________________________________________________
+int AliMLResponse::GetVariableIndex(const std::string &varname) const {
+  auto var = fVariableIndex.find(varname);
+  return var == fVariableIndex.end() ? -1 : var->second;
+}
+
+//_______________________________________________________________________________
+int AliMLResponse::PredictBatch(const double *binvars, const double *features, int nCandidates, double *scores) {
+  if (nCandidates <= 0)
+    return 0;
+
+  /// group the candidates by bin (counting sort), so that each model is called once
+  fBatchBin.resize(nCandidates);
+  fBatchOrder.resize(nCandidates);
+  fBatchBinOffsets.assign(fNBins + 1, 0);
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    int bin = FindBinNoWarning(binvars[iCand]);
+    fBatchBin[iCand] = bin;
+    if (bin < 0) {
+      scores[iCand] = -999.;
+      continue;
+    }
+    fBatchBinOffsets[bin]++;
+  }
+  int nScored = 0;
+  for (int iBin = 0; iBin <= fNBins; ++iBin) {
+    int nInBin = fBatchBinOffsets[iBin];
+    fBatchBinOffsets[iBin] = nScored;
+    nScored += nInBin;
+  }
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    if (fBatchBin[iCand] >= 0)
+      fBatchOrder[fBatchBinOffsets[fBatchBin[iCand]]++] = iCand;
+  }
+
+  /// after the scatter each offset points to the end of its bin
+  int binStart = 0;
+  for (int iBin = 1; iBin < fNBins; ++iBin) {
+    int binEnd = fBatchBinOffsets[iBin];
+    int nInBin = binEnd - binStart;
+    if (nInBin > 0) {
+      fBatchFeatures.resize((size_t)nInBin * fNVariables);
+      fBatchScores.resize(nInBin);
+      for (int iVar = 0; iVar < fNVariables; ++iVar) {
+        const double *column = features + (size_t)iVar * nCandidates;
+        double *binColumn = &fBatchFeatures[(size_t)iVar * nInBin];
+        for (int iCand = 0; iCand < nInBin; ++iCand) {
+          binColumn[iCand] = column[fBatchOrder[binStart + iCand]];
+        }
+      }
+      if (!fModels.at(iBin - 1).GetModel()->PredictBatch(fBatchFeatures.data(), nInBin, fNVariables,
+                                                          fBatchScores.data(), fRaw)) {
+        AliFatal("Error in batch prediction! Exit");
+      }
+      for (int iCand = 0; iCand < nInBin; ++iCand) {
+        scores[fBatchOrder[binStart + iCand]] = fBatchScores[iCand];
+      }
+    }
+    binStart = binEnd;
+  }
+  return nScored;
+}
+
+//_______________________________________________________________________________
+int AliMLResponse::IsSelectedBatch(const double *binvars, const double *features, int nCandidates, double *scores,
+                                   bool *selected) {
+  int nScored = PredictBatch(binvars, features, nCandidates, scores);
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    int bin = fBatchBin[iCand];
+    selected[iCand] = bin >= 0 && scores[iCand] >= fModels.at(bin - 1).GetScoreCut();
+  }
+  return nScored;
+}
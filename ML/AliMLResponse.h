@@ -49,19 +49,31 @@ public:
   /// return the bin index
   int FindBin(double binvar);
   /// return the ML model predicted score (raw or proba, depending on useraw)
-  double Predict(double binvar, std::map<std::string, double> varmap);
+  double Predict(double binvar, const std::map<std::string, double> &varmap);
   /// overload to pass directly a vector of variables
   double Predict(double binvar, std::vector<double> variables);
   /// return true if predicted score for map is above the threshold given in the config
-  bool IsSelected(double binvar, std::map<std::string, double> varmap);
+  bool IsSelected(double binvar, const std::map<std::string, double> &varmap);
   /// overload for getting the model score too
-  template <typename F> bool IsSelected(double binvar, std::map<std::string, double> varmap, F &score);
+  template <typename F> bool IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score);
   /// overload to pass directly a vector of variables
   bool IsSelected(double binvar, std::vector<double> variables);
   /// overload for getting the model score too
   template <typename F> bool IsSelected(double binvar, std::vector<double> variables, F &score);
 
+  /// return the column of a variable in the feature matrix passed to PredictBatch (-1 if not used by the models)
+  int GetVariableIndex(const std::string &varname) const;
+  /// score nCandidates at once, with one treelite call per bin. Features are column-major, with the
+  /// columns ordered as in the config (see GetVariableIndex): features[iVar * nCandidates + iCand].
+  /// Candidates outside the bin range get a score of -999. Returns the number of scored candidates
+  int PredictBatch(const double *binvars, const double *features, int nCandidates, double *scores);
+  /// batch version of IsSelected, fills both the scores and the selection flags
+  int IsSelectedBatch(const double *binvars, const double *features, int nCandidates, double *scores, bool *selected);
+
 protected:
+  /// quiet version of FindBin used by the batch methods
+  int FindBinNoWarning(double binvar) const;
+
   std::string fConfigFilePath;    /// path of the config file
 
   std::vector<AliMLModelHandler> fModels;     //!<! vector of models
@@ -76,12 +88,20 @@ protected:
 
   bool fRaw;    /// set to true to use raw score instead of probability
 
+  std::map<std::string, int> fVariableIndex;    //!<! variable name -> feature index, resolved once at init
+  std::vector<double> fFeatures;                //!<! feature buffer reused by Predict
+  std::vector<int> fBatchBinOffsets;            //!<! first candidate of each bin in fBatchOrder
+  std::vector<int> fBatchBin;                   //!<! bin of each candidate of the current batch
+  std::vector<int> fBatchOrder;                 //!<! candidate indices grouped by bin
+  std::vector<double> fBatchFeatures;           //!<! column-major features of the candidates of one bin
+  std::vector<double> fBatchScores;             //!<! scores of the candidates of one bin
+
   /// \cond CLASSIMP
   ClassDef(AliMLResponse, 2);    ///
   /// \endcond
 };
 
-template <typename F> bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap, F &score) {
+template <typename F> bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score) {
   int bin = FindBin(binvar);
   if (bin < 0)
     return false;
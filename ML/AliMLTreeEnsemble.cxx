@@ -0,0 +1,592 @@
+// Copyright CERN. This software is distributed under the terms of the GNU
+// General Public License v3 (GPL Version 3).
+//
+// See http://www.gnu.org/licenses/ for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file AliMLTreeEnsemble.cxx
+
+#include "AliMLTreeEnsemble.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+
+/// minimal scanner for the C code emitted by the treelite ast_native compiler
+class AliMLTreeEnsemble::CodeScanner {
+public:
+  CodeScanner(const std::string &code, size_t pos) : fCode(code), fPos(pos) {}
+
+  void SkipBlanks() {
+    while (fPos < fCode.size()) {
+      if (std::isspace(static_cast<unsigned char>(fCode[fPos]))) {
+        ++fPos;
+      } else if (fCode.compare(fPos, 2, "/*") == 0) {
+        size_t end = fCode.find("*/", fPos + 2);
+        fPos = end == std::string::npos ? fCode.size() : end + 2;
+      } else if (fCode.compare(fPos, 2, "//") == 0) {
+        size_t end = fCode.find('\n', fPos);
+        fPos = end == std::string::npos ? fCode.size() : end + 1;
+      } else {
+        break;
+      }
+    }
+  }
+
+  bool Peek(const char *token) {
+    SkipBlanks();
+    return fCode.compare(fPos, std::strlen(token), token) == 0;
+  }
+
+  bool Accept(const char *token) {
+    if (!Peek(token)) return false;
+    fPos += std::strlen(token);
+    return true;
+  }
+
+  /// read the content of a parenthesised expression starting at the current position
+  bool ReadParenthesised(std::string &content) {
+    if (!Peek("(")) return false;
+    int depth = 0;
+    for (size_t iChar = fPos; iChar < fCode.size(); ++iChar) {
+      if (fCode[iChar] == '(') {
+        ++depth;
+      } else if (fCode[iChar] == ')' && --depth == 0) {
+        content = fCode.substr(fPos + 1, iChar - fPos - 1);
+        fPos = iChar + 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadNumber(double &value) {
+    SkipBlanks();
+    const char *begin = fCode.c_str() + fPos;
+    char *end = nullptr;
+    value = std::strtod(begin, &end);
+    if (end == begin) return false;
+    fPos += end - begin;
+    return true;
+  }
+
+  size_t Find(const char *token) {
+    const size_t found = fCode.find(token, fPos);
+    return found;
+  }
+
+  void MoveTo(size_t pos) { fPos = pos; }
+
+  bool ReadStatement(std::string &content) {
+    SkipBlanks();
+    size_t end = fCode.find(';', fPos);
+    if (end == std::string::npos) return false;
+    content = fCode.substr(fPos, end - fPos);
+    fPos = end + 1;
+    return true;
+  }
+
+private:
+  const std::string &fCode;
+  size_t fPos;
+};
+
+namespace {
+  bool ParseFloat(const std::string &text, float &value) {
+    const char *begin = text.c_str();
+    while (*begin == ' ' || *begin == '(') ++begin;
+    char *end = nullptr;
+    value = std::strtof(begin, &end);
+    return end != begin;
+  }
+
+  bool ReadFile(const std::string &path, std::string &content) {
+    std::ifstream file(path.data());
+    if (!file.is_open()) {
+      std::cerr << "Cannot open the model file " << path << std::endl;
+      return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    content = buffer.str();
+    return true;
+  }
+
+  /// value of the attribute name="..." of an XML tag
+  bool GetAttribute(const std::string &tag, const char *name, std::string &value) {
+    const std::string key = std::string(" ") + name + "=\"";
+    const size_t begin = tag.find(key);
+    if (begin == std::string::npos) return false;
+    const size_t end = tag.find('"', begin + key.size());
+    value = tag.substr(begin + key.size(), end - begin - key.size());
+    return true;
+  }
+
+  bool GetAttribute(const std::string &tag, const char *name, double &value) {
+    std::string text;
+    if (!GetAttribute(tag, name, text)) return false;
+    char *end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end != text.c_str();
+  }
+
+  /// value of <Option name="...">value</Option> in a TMVA weight file
+  std::string GetTMVAOption(const std::string &xml, const std::string &name) {
+    const size_t option = xml.find("<Option name=\"" + name + "\"");
+    if (option == std::string::npos) return "";
+    const size_t begin = xml.find('>', option) + 1;
+    return xml.substr(begin, xml.find('<', begin) - begin);
+  }
+
+  template <int kCut, typename T> inline bool PassCut(T value, T threshold) {
+    switch (kCut) {
+      case AliMLTreeEnsemble::kLess: return value < threshold;
+      case AliMLTreeEnsemble::kLessEqual: return value <= threshold;
+      case AliMLTreeEnsemble::kGreater: return value > threshold;
+      case AliMLTreeEnsemble::kGreaterEqual: return value >= threshold;
+      default: return value == threshold;
+    }
+  }
+
+  template <typename T> inline bool PassCut(int cut, T value, T threshold) {
+    switch (cut) {
+      case AliMLTreeEnsemble::kLess: return PassCut<AliMLTreeEnsemble::kLess>(value, threshold);
+      case AliMLTreeEnsemble::kLessEqual: return PassCut<AliMLTreeEnsemble::kLessEqual>(value, threshold);
+      case AliMLTreeEnsemble::kGreater: return PassCut<AliMLTreeEnsemble::kGreater>(value, threshold);
+      case AliMLTreeEnsemble::kGreaterEqual: return PassCut<AliMLTreeEnsemble::kGreaterEqual>(value, threshold);
+      default: return PassCut<AliMLTreeEnsemble::kEqual>(value, threshold);
+    }
+  }
+}
+
+AliMLTreeEnsemble::AliMLTreeEnsemble() :
+  fRoots{},
+  fDepth{},
+  fFeature{},
+  fValue{},
+  fLeft{},
+  fRight{},
+  fCut{},
+  fDefaultLeft{},
+  fUniformCut{-1},
+  fSinglePrecision{true},
+  fBaseScore{0.},
+  fNorm{0.},
+  fTransform{kIdentity},
+  fSigmoidAlpha{1.f},
+  fVariableNames{}
+{
+}
+
+void AliMLTreeEnsemble::Clear() {
+  fRoots.clear();
+  fDepth.clear();
+  fFeature.clear();
+  fValue.clear();
+  fLeft.clear();
+  fRight.clear();
+  fCut.clear();
+  fDefaultLeft.clear();
+  fUniformCut = -1;
+  fSinglePrecision = true;
+  fBaseScore = 0.;
+  fNorm = 0.;
+  fTransform = kIdentity;
+  fSigmoidAlpha = 1.f;
+  fVariableNames.clear();
+}
+
+int AliMLTreeEnsemble::AddNode() {
+  fFeature.push_back(-1);
+  fValue.push_back(0.);
+  fLeft.push_back(-1);
+  fRight.push_back(-1);
+  fCut.push_back(kLess);
+  fDefaultLeft.push_back(1);
+  return fFeature.size() - 1;
+}
+
+void AliMLTreeEnsemble::Finalize() {
+  /// leaves point to themselves, so that a fixed number of steps can be taken for each tree
+  for (size_t iNode = 0; iNode < fFeature.size(); ++iNode) {
+    if (fFeature[iNode] < 0) fLeft[iNode] = fRight[iNode] = iNode;
+  }
+  fUniformCut = fCut.empty() ? -1 : fCut[0];
+  for (size_t iNode = 0; iNode < fFeature.size(); ++iNode) {
+    if (fFeature[iNode] >= 0 && fCut[iNode] != fUniformCut) fUniformCut = -1;
+  }
+  fDepth.assign(fRoots.size(), 0);
+  std::vector<std::pair<int, int>> stack;
+  for (size_t iTree = 0; iTree < fRoots.size(); ++iTree) {
+    stack.assign(1, std::make_pair(fRoots[iTree], 0));
+    while (!stack.empty()) {
+      const int node = stack.back().first;
+      const int depth = stack.back().second;
+      stack.pop_back();
+      if (fFeature[node] < 0) {
+        if (depth > fDepth[iTree]) fDepth[iTree] = depth;
+      } else {
+        stack.push_back(std::make_pair(fLeft[node], depth + 1));
+        stack.push_back(std::make_pair(fRight[node], depth + 1));
+      }
+    }
+  }
+}
+
+/// parse one statement of a tree (nested if/else or leaf) into the node table, -1 on failure
+int AliMLTreeEnsemble::ParseTreeliteNode(CodeScanner &scanner) {
+  static const std::regex cutRegex("data\\[(\\d+)\\]\\.fvalue\\s*(<=|>=|==|<|>)\\s*\\(float\\)\\s*\\(?\\s*([-+0-9.eE]+)");
+  static const std::regex missingLeftRegex("^\\s*!\\s*\\(\\s*data\\[\\d+\\]\\.missing\\s*!=\\s*-1\\s*\\)\\s*\\|\\|");
+  if (scanner.Accept("if")) {
+    std::string condition;
+    if (!scanner.ReadParenthesised(condition)) return -1;
+    std::smatch match;
+    if (!std::regex_search(condition, match, cutRegex)) return -1;
+    const int node = AddNode();
+    fFeature[node] = std::atoi(match[1].str().c_str());
+    const std::string op = match[2].str();
+    fCut[node] = op == "<" ? kLess : op == "<=" ? kLessEqual : op == ">" ? kGreater : op == ">=" ? kGreaterEqual : kEqual;
+    float threshold = 0.f;
+    if (!ParseFloat(match[3].str(), threshold)) return -1;
+    fValue[node] = threshold;
+    fDefaultLeft[node] = std::regex_search(condition, missingLeftRegex) ? 1 : 0;
+    if (!scanner.Accept("{")) return -1;
+    const int left = ParseTreeliteNode(scanner);
+    if (left < 0 || !scanner.Accept("}") || !scanner.Accept("else") || !scanner.Accept("{")) return -1;
+    const int right = ParseTreeliteNode(scanner);
+    if (right < 0 || !scanner.Accept("}")) return -1;
+    fLeft[node] = left;
+    fRight[node] = right;
+    return node;
+  }
+  if (scanner.Accept("sum") && scanner.Accept("+=")) {
+    std::string statement;
+    if (!scanner.ReadStatement(statement)) return -1;
+    const size_t cast = statement.find("(float)");
+    const int node = AddNode();
+    float leaf = 0.f;
+    if (!ParseFloat(cast == std::string::npos ? statement : statement.substr(cast + 7), leaf)) return -1;
+    fValue[node] = leaf;
+    return node;
+  }
+  return -1;
+}
+
+bool AliMLTreeEnsemble::LoadTreeliteCode(const std::string &path) {
+  Clear();
+  std::string code;
+  if (!ReadFile(path, code)) return false;
+
+  /// multi-class models and averaged forests are not supported
+  const size_t predict = code.find("float predict(");
+  if (predict == std::string::npos || code.find("sum /") != std::string::npos) return false;
+
+  const size_t transform = code.find("pred_transform(float margin)");
+  if (transform != std::string::npos && transform < predict) {
+    const size_t bodyEnd = code.find('}', transform);
+    const std::string body = code.substr(transform, bodyEnd - transform);
+    if (body.find("expf") != std::string::npos) {
+      fTransform = kSigmoid;
+      const size_t alpha = body.find("alpha = (float)");
+      if (alpha != std::string::npos && !ParseFloat(body.substr(alpha + 15), fSigmoidAlpha)) return false;
+    } else if (body.find("return margin") == std::string::npos) {
+      return false;
+    }
+  }
+
+  CodeScanner scanner(code, code.find('{', predict) + 1);
+  while (true) {
+    if (scanner.Peek("if (!pred_margin)")) {
+      break;
+    } else if (scanner.Peek("if") || scanner.Peek("sum +=")) {
+      const int root = ParseTreeliteNode(scanner);
+      if (root < 0) {
+        Clear();
+        return false;
+      }
+      fRoots.push_back(root);
+    } else {
+      std::string statement;
+      if (scanner.Peek("return") || !scanner.ReadStatement(statement)) break;
+      const size_t bias = statement.find("sum = sum + (float)");
+      if (bias != std::string::npos) {
+        float baseScore = 0.f;
+        if (!ParseFloat(statement.substr(bias + 19), baseScore)) {
+          Clear();
+          return false;
+        }
+        fBaseScore = baseScore;
+        break;
+      }
+    }
+  }
+  Finalize();
+  return IsLoaded();
+}
+
+bool AliMLTreeEnsemble::LoadTMVAWeights(const std::string &path) {
+  Clear();
+  std::string xml;
+  if (!ReadFile(path, xml)) return false;
+
+  if (GetTMVAOption(xml, "BoostType") == "Grad" || GetTMVAOption(xml, "UseYesNoLeaf") == "False" ||
+      GetTMVAOption(xml, "UseFisherCuts") == "True") {
+    std::cerr << "Only AdaBoost BDTs with yes/no leaves and rectangular cuts are supported" << std::endl;
+    return false;
+  }
+  const size_t transformations = xml.find("<Transformations NTransformations=\"");
+  if (transformations != std::string::npos && xml.compare(transformations + 35, 2, "0\"") != 0) {
+    std::cerr << "Input variable transformations are not supported" << std::endl;
+    return false;
+  }
+
+  fSinglePrecision = false;
+  std::vector<int> tmvaLeft, tmvaRight, stack;
+  std::vector<unsigned char> cutType;
+  double boostWeight = 0.;
+  size_t pos = xml.find("<Variables");
+  while ((pos = xml.find('<', pos)) != std::string::npos) {
+    const size_t end = xml.find('>', pos);
+    const std::string tag = xml.substr(pos, end - pos + 1);
+    pos = end;
+    if (tag.compare(0, 9, "<Variable") == 0 && tag.compare(0, 10, "<Variables") != 0) {
+      std::string expression;
+      GetAttribute(tag, "Expression", expression);
+      fVariableNames.push_back(expression);
+    } else if (tag.compare(0, 11, "<BinaryTree") == 0) {
+      if (!GetAttribute(tag, "boostWeight", boostWeight)) break;
+      stack.clear();
+    } else if (tag.compare(0, 5, "<Node") == 0) {
+      double selector = -1., cut = 0., type = 0., nodeType = 0., nCoef = 0.;
+      if (!GetAttribute(tag, "IVar", selector) || !GetAttribute(tag, "Cut", cut) ||
+          !GetAttribute(tag, "cType", type) || !GetAttribute(tag, "nType", nodeType)) {
+        Clear();
+        return false;
+      }
+      if (GetAttribute(tag, "NCoef", nCoef) && nCoef > 0) {
+        Clear();
+        return false;
+      }
+      const int node = AddNode();
+      tmvaLeft.push_back(-1);
+      tmvaRight.push_back(-1);
+      cutType.push_back(type > 0.5);
+      if (nodeType == 0) {
+        fFeature[node] = static_cast<int>(selector);
+        fValue[node] = cut;
+      } else {
+        fValue[node] = boostWeight * static_cast<int>(nodeType);
+      }
+      if (stack.empty()) {
+        fRoots.push_back(node);
+        fNorm += boostWeight;
+      } else {
+        std::string position;
+        GetAttribute(tag, "pos", position);
+        (position == "l" ? tmvaLeft : tmvaRight)[stack.back()] = node;
+      }
+      if (tag.compare(tag.size() - 2, 2, "/>") != 0) stack.push_back(node);
+    } else if (tag.compare(0, 7, "</Node>") == 0) {
+      if (!stack.empty()) stack.pop_back();
+    } else if (tag.compare(0, 10, "</Weights>") == 0) {
+      break;
+    }
+  }
+
+  /// x > cut goes right for cType = 1, left for cType = 0: in both cases the node passes
+  /// (<=, NaN included) towards the TMVA daughter selected by !(x > cut)
+  for (size_t iNode = 0; iNode < fFeature.size(); ++iNode) {
+    if (fFeature[iNode] < 0) continue;
+    if (tmvaLeft[iNode] < 0 || tmvaRight[iNode] < 0) {
+      Clear();
+      return false;
+    }
+    fCut[iNode] = kLessEqual;
+    fDefaultLeft[iNode] = 1;
+    fLeft[iNode] = cutType[iNode] ? tmvaLeft[iNode] : tmvaRight[iNode];
+    fRight[iNode] = cutType[iNode] ? tmvaRight[iNode] : tmvaLeft[iNode];
+  }
+  Finalize();
+  return IsLoaded();
+}
+
+/// NN(left, right, selector, cutValue, cutType, nodeType, purity, response), see BDTNode.h
+int AliMLTreeEnsemble::ParseTMVAClassNode(CodeScanner &scanner, double boostWeight) {
+  if (!scanner.Accept("NN(")) return -1;
+  int daughters[2] = {-1, -1};
+  for (int iDaughter = 0; iDaughter < 2; ++iDaughter) {
+    if (scanner.Peek("NN(")) {
+      daughters[iDaughter] = ParseTMVAClassNode(scanner, boostWeight);
+      if (daughters[iDaughter] < 0) return -1;
+    } else {
+      double null = 1.;
+      if (!scanner.ReadNumber(null) || null != 0.) return -1;
+    }
+    if (!scanner.Accept(",")) return -1;
+  }
+  double fields[6] = {0., 0., 0., 0., 0., 0.};
+  for (int iField = 0; iField < 6; ++iField) {
+    if (!scanner.ReadNumber(fields[iField]) || !scanner.Accept(iField < 5 ? "," : ")")) return -1;
+  }
+  const int node = AddNode();
+  const int nodeType = static_cast<int>(fields[3]);
+  if (nodeType == 0) {
+    if (daughters[0] < 0 || daughters[1] < 0) return -1;
+    const bool cutType = fields[2] != 0.;
+    fFeature[node] = static_cast<int>(fields[0]);
+    fValue[node] = fields[1];
+    fCut[node] = kLessEqual;
+    fDefaultLeft[node] = 1;
+    fLeft[node] = cutType ? daughters[0] : daughters[1];
+    fRight[node] = cutType ? daughters[1] : daughters[0];
+  } else {
+    /// same product as in GetMvaValue__ of the generated class
+    fValue[node] = boostWeight * nodeType;
+  }
+  return node;
+}
+
+bool AliMLTreeEnsemble::LoadTMVAClass(const std::string &path) {
+  Clear();
+  std::string code;
+  if (!ReadFile(path, code)) return false;
+  if (code.find("myMVA += fBoostWeights[itree] *  current->GetNodeType()") == std::string::npos) {
+    std::cerr << "Only AdaBoost BDT classes with yes/no leaves are supported" << std::endl;
+    return false;
+  }
+
+  fSinglePrecision = false;
+  CodeScanner scanner(code, code.find("::Initialize()"));
+  size_t weight;
+  while ((weight = scanner.Find("fBoostWeights.push_back(")) != std::string::npos) {
+    scanner.MoveTo(weight + 24);
+    double boostWeight = 0.;
+    if (!scanner.ReadNumber(boostWeight) || !scanner.Accept(")") || !scanner.Accept(";") ||
+        !scanner.Accept("fForest.push_back(")) {
+      Clear();
+      return false;
+    }
+    const int root = ParseTMVAClassNode(scanner, boostWeight);
+    if (root < 0) {
+      Clear();
+      return false;
+    }
+    fRoots.push_back(root);
+    fNorm += boostWeight;
+  }
+  Finalize();
+  return IsLoaded();
+}
+
+double AliMLTreeEnsemble::Transform(double margin) const {
+  if (fTransform == kSigmoid) {
+    const float floatMargin = static_cast<float>(margin);
+    return 1.0f / (1 + std::exp(-fSigmoidAlpha * floatMargin));
+  }
+  return margin;
+}
+
+/// T is the precision of the cuts and of the sum: float for treelite models, double for TMVA
+template <typename T> double AliMLTreeEnsemble::PredictSingle(const double *features, int size, bool useRaw) const {
+  T sum = 0;
+  for (size_t iTree = 0; iTree < fRoots.size(); ++iTree) {
+    int node = fRoots[iTree];
+    while (fFeature[node] >= 0) {
+      const int iFeature = fFeature[node];
+      const T value = iFeature < size ? static_cast<T>(features[iFeature]) : static_cast<T>(NAN);
+      const bool goLeft = std::isnan(value) ? fDefaultLeft[node] : PassCut(fCut[node], value, static_cast<T>(fValue[node]));
+      node = goLeft ? fLeft[node] : fRight[node];
+    }
+    sum += static_cast<T>(fValue[node]);
+  }
+  if (fNorm != 0.) return sum / fNorm;
+  sum = sum + static_cast<T>(fBaseScore);
+  return useRaw ? sum : Transform(sum);
+}
+
+double AliMLTreeEnsemble::Predict(const double *features, int size, bool useRaw) const {
+  return fSinglePrecision ? PredictSingle<float>(features, size, useRaw) : PredictSingle<double>(features, size, useRaw);
+}
+
+/// Branch-free kernel: all the candidates of the block take depth steps in each tree,
+/// leaves pointing to themselves. Per candidate the operations are the same, and in
+/// the same order, as in PredictSingle.
+template <typename T, int kCut>
+void AliMLTreeEnsemble::PredictBlock(const double *features, int nCandidates, int nFeatures, int first, int nBlock,
+                                     double *scores, bool useRaw) const {
+  const int kBlock = 64;
+  int node[kBlock];
+  T sum[kBlock];
+  for (int iCand = 0; iCand < nBlock; ++iCand) sum[iCand] = 0;
+  const int *feature = fFeature.data();
+  const double *value = fValue.data();
+  const int *left = fLeft.data();
+  const int *right = fRight.data();
+  const unsigned char *defaultLeft = fDefaultLeft.data();
+  const double *block = features + first;
+
+  for (size_t iTree = 0; iTree < fRoots.size(); ++iTree) {
+    for (int iCand = 0; iCand < nBlock; ++iCand) node[iCand] = fRoots[iTree];
+    for (int iStep = 0; iStep < fDepth[iTree]; ++iStep) {
+      for (int iCand = 0; iCand < nBlock; ++iCand) {
+        const int current = node[iCand];
+        const int iFeature = feature[current];
+        const bool valid = iFeature >= 0 && iFeature < nFeatures;
+        const T x = valid ? static_cast<T>(block[static_cast<size_t>(iFeature) * nCandidates + iCand]) : static_cast<T>(NAN);
+        const bool goLeft = (x == x) ? PassCut<kCut>(x, static_cast<T>(value[current])) : defaultLeft[current] != 0;
+        node[iCand] = goLeft ? left[current] : right[current];
+      }
+    }
+    for (int iCand = 0; iCand < nBlock; ++iCand) sum[iCand] += static_cast<T>(value[node[iCand]]);
+  }
+  for (int iCand = 0; iCand < nBlock; ++iCand) {
+    if (fNorm != 0.) {
+      scores[first + iCand] = sum[iCand] / fNorm;
+    } else {
+      const T margin = sum[iCand] + static_cast<T>(fBaseScore);
+      scores[first + iCand] = useRaw ? margin : Transform(margin);
+    }
+  }
+}
+
+void AliMLTreeEnsemble::PredictBatch(const double *features, int nCandidates, int nFeatures, double *scores,
+                                     bool useRaw) const {
+  const int kBlock = 64;
+  if (fUniformCut < 0) {
+    /// mixed comparisons: fall back to one candidate at a time
+    std::vector<double> row(nFeatures);
+    for (int iCand = 0; iCand < nCandidates; ++iCand) {
+      for (int iFeature = 0; iFeature < nFeatures; ++iFeature) row[iFeature] = features[static_cast<size_t>(iFeature) * nCandidates + iCand];
+      scores[iCand] = Predict(row.data(), nFeatures, useRaw);
+    }
+    return;
+  }
+  for (int first = 0; first < nCandidates; first += kBlock) {
+    const int nBlock = nCandidates - first < kBlock ? nCandidates - first : kBlock;
+    if (fSinglePrecision) {
+      switch (fUniformCut) {
+        case kLess: PredictBlock<float, kLess>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+        case kLessEqual: PredictBlock<float, kLessEqual>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+        case kGreater: PredictBlock<float, kGreater>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+        case kGreaterEqual: PredictBlock<float, kGreaterEqual>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+        default: PredictBlock<float, kEqual>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+      }
+    } else {
+      switch (fUniformCut) {
+        case kLess: PredictBlock<double, kLess>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+        case kLessEqual: PredictBlock<double, kLessEqual>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+        case kGreater: PredictBlock<double, kGreater>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+        case kGreaterEqual: PredictBlock<double, kGreaterEqual>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+        default: PredictBlock<double, kEqual>(features, nCandidates, nFeatures, first, nBlock, scores, useRaw); break;
+      }
+    }
+  }
+}
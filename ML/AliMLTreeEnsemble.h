@@ -0,0 +1,81 @@
+// Copyright CERN. This software is distributed under the terms of the GNU
+// General Public License v3 (GPL Version 3).
+//
+// See http://www.gnu.org/licenses/ for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file AliMLTreeEnsemble.h
+/// \brief In-memory evaluator for tree ensembles, stored as a flat
+///        structure-of-arrays node table. Models can be read from the C code
+///        generated by treelite or from TMVA BDTs (weight XML or the
+///        class generated by MethodBase::MakeClass).
+
+#ifndef ALIMLTREEENSEMBLE_H
+#define ALIMLTREEENSEMBLE_H
+
+#include <string>
+#include <vector>
+
+class AliMLTreeEnsemble {
+public:
+  enum ECut { kLess, kLessEqual, kGreater, kGreaterEqual, kEqual };
+  enum ETransform { kIdentity, kSigmoid };
+
+  AliMLTreeEnsemble();
+  virtual ~AliMLTreeEnsemble(){};
+
+  /// build the node table from the C code generated by the treelite ast_native
+  /// compiler (main.c). Returns false if the code uses unsupported constructs.
+  bool LoadTreeliteCode(const std::string &path);
+  /// build the node table from a TMVA BDT weight file (AdaBoost with yes/no leaves).
+  /// Cuts follow the convention of the classes generated by TMVA (x > cut goes right).
+  bool LoadTMVAWeights(const std::string &path);
+  /// build the node table from the source of a class generated by TMVA MakeClass
+  /// (*.class.cxx). The output is bitwise identical to the one of the class.
+  bool LoadTMVAClass(const std::string &path);
+
+  void Clear();
+  bool IsLoaded() const { return !fRoots.empty(); }
+  int GetNTrees() const { return fRoots.size(); }
+  int GetNNodes() const { return fFeature.size(); }
+  const std::vector<std::string> &GetVariableNames() const { return fVariableNames; }
+
+  double Predict(const double *features, int size, bool useRaw = false) const;
+  /// score nCandidates at once. Features are column-major:
+  /// features[iFeature * nCandidates + iCandidate]
+  void PredictBatch(const double *features, int nCandidates, int nFeatures, double *scores, bool useRaw = false) const;
+
+protected:
+  class CodeScanner;
+
+  int AddNode();
+  void Finalize();
+  int ParseTreeliteNode(CodeScanner &scanner);
+  int ParseTMVAClassNode(CodeScanner &scanner, double boostWeight);
+  double Transform(double margin) const;
+  template <typename T> double PredictSingle(const double *features, int size, bool useRaw) const;
+  template <typename T, int kCut> void PredictBlock(const double *features, int nCandidates, int nFeatures,
+                                                   int first, int nBlock, double *scores, bool useRaw) const;
+
+  std::vector<int> fRoots;              /// index of the root node of each tree
+  std::vector<int> fDepth;              /// depth of each tree
+  std::vector<int> fFeature;            /// feature index of the cut, -1 for leaves
+  std::vector<double> fValue;           /// cut threshold or leaf value
+  std::vector<int> fLeft;               /// node taken when the cut is fulfilled (the leaf itself for leaves)
+  std::vector<int> fRight;              /// node taken when the cut is not fulfilled (the leaf itself for leaves)
+  std::vector<unsigned char> fCut;      /// ECut comparison of the node
+  std::vector<unsigned char> fDefaultLeft;  /// direction taken for missing (NaN) features
+
+  int fUniformCut;           /// ECut shared by all the nodes, -1 if they differ
+  bool fSinglePrecision;     /// cuts and sums in float (treelite) instead of double (TMVA)
+  double fBaseScore;         /// global bias added to the sum of the trees
+  double fNorm;              /// normalisation of the sum of the trees (sum of the boost weights), 0 if none
+  int fTransform;            /// ETransform applied to the margin
+  float fSigmoidAlpha;       /// slope of the sigmoid transformation
+  std::vector<std::string> fVariableNames;  /// names of the input variables, if stored in the model
+};
+
+#endif
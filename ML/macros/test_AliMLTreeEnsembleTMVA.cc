@@ -0,0 +1,69 @@
+#include <TRandom3.h>
+#include <TSystem.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AliMLTreeEnsemble.h"
+#include "IClassifierReader.h"
+
+extern "C" IClassifierReader *ReadBDT_maker_LHC19c2a_2_4_noP(std::vector<std::string> theInpVar);
+
+// Checks that the in-memory evaluator reproduces bit by bit the generated TMVA class reader
+int test_AliMLTreeEnsembleTMVA(string path = "") {
+
+  string class_path;
+
+  if (path == "") {
+    class_path = string(gSystem->Getenv("ALICE_PHYSICS")) + "/PWGHF/vertexingHF/TMVA/LHC19c2a_TMVAClassification_BDT_2_4_noP.class.cxx";
+  } else {
+    class_path = path + "/" + "LHC19c2a_TMVAClassification_BDT_2_4_noP.class.cxx";
+  }
+
+  if (gSystem->Load("libvertexingHFTMVA") < 0) {
+    std::cout << "TEST: Fail! Cannot load the TMVA class readers" << std::endl;
+    return 1;
+  }
+
+  const int nVars = 11;
+  std::vector<std::string> names = {"massK0S", "tImpParBach", "tImpParV0", "DecayLengthK0S*0.497/v0P", "cosPAK0S",
+                                    "CosThetaStar", "signd0", "nSigmaTOFpr", "nSigmaTPCpr", "nSigmaTPCpi", "nSigmaTPCka"};
+  const double varMin[nVars] = {0.487, -0.5, -1.5, 0.1, 0.99, -1., 0., -5., -3., -6., -4.};
+  const double varMax[nVars] = {0.508, 0.5, 1.5, 80., 1., 1., 0.5, 3., 3., 2., 4.};
+
+  IClassifierReader *reader = ReadBDT_maker_LHC19c2a_2_4_noP(names);
+
+  AliMLTreeEnsemble ensemble;
+  if (!ensemble.LoadTMVAClass(class_path)) {
+    std::cout << "TEST: Fail! Cannot load " << class_path << std::endl;
+    return 1;
+  }
+
+  const int nCand = 100000;
+  TRandom3 rnd(42);
+  std::vector<double> features(nVars * nCand), scores(nCand), row(nVars);
+  for (int iCand = 0; iCand < nCand; ++iCand) {
+    for (int iVar = 0; iVar < nVars; ++iVar) {
+      features[iVar * nCand + iCand] = rnd.Uniform(varMin[iVar], varMax[iVar]);
+    }
+  }
+  ensemble.PredictBatch(features.data(), nCand, nVars, scores.data());
+
+  for (int iCand = 0; iCand < nCand; ++iCand) {
+    for (int iVar = 0; iVar < nVars; ++iVar) {
+      row[iVar] = features[iVar * nCand + iCand];
+    }
+    const double ref = reader->GetMvaValue(row);
+    if (ref != scores[iCand] || ref != ensemble.Predict(row.data(), nVars)) {
+      std::cout << Form("Candidate %d: class %.17g, ensemble %.17g", iCand, ref, scores[iCand]) << std::endl;
+      std::cout << "TEST: Fail!" << std::endl;
+      delete reader;
+      return 1;
+    }
+  }
+  delete reader;
+
+  std::cout << "TEST: Success!" << std::endl;
+  return 0;
+}
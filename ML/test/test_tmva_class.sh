@@ -0,0 +1,3 @@
+#!/bin/bash
+
+root -q -b -l ../macros/test_AliMLTreeEnsembleTMVA.cc\(\"${ALICE_PHYSICS}/PWGHF/vertexingHF/TMVA\"\)
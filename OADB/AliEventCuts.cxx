@@ -3,10 +3,12 @@
 #include <algorithm>
 #include <array>
 using std::array;
+#include <map>
 #include <memory>
 using std::string;
 using std::vector;
 
+#include <TBufferFile.h>
 #include <TClonesArray.h>
 #include <TH1D.h>
 #include <TH1I.h>
@@ -37,6 +39,45 @@ using std::vector;
 ClassImp(AliEventCutsContainer);
 ClassImp(AliEventCuts);
 
+bool AliEventCuts::fgUseSharedSelection = false;
+
+namespace {
+  /// Selection of the last event evaluated by the AliEventCuts instances sharing the same configuration
+  struct SharedSelection {
+    const AliVEvent* fEvent = nullptr;           ///< Event pointer, entry, identifier and run of the stored selection
+    Long64_t fEntry = -1;
+    unsigned long fEventId = 0u;
+    int fRun = -1;
+    unsigned long fFlag = 0u;                    ///< Selection flag
+    AliVVertex* fPrimaryVertex = nullptr;
+    float fCentPercentiles[2] = {-1.f,-1.f};
+    int fSPDpileupMinContributors = 0;
+    AliEventCutsContainer fContainer;            ///< Track multiplicities (only if computed by the configuration)
+    int fNtrkl = 0;                              ///< Number of tracklets (QA)
+    double fDz = 0.;                             ///< Distance between track and SPD vertices (QA)
+    std::string fName;                           ///< Name of the first instance using the configuration
+    unsigned long fEvaluated = 0u;               ///< Number of evaluated selections
+    unsigned long fSaved = 0u;                   ///< Number of selections taken from the shared result
+  };
+
+  std::map<unsigned long long, SharedSelection>& SharedSelections() {
+    static std::map<unsigned long long, SharedSelection> selections;
+    return selections;
+  }
+
+  /// FNV-1a hash
+  const unsigned long long kHashOffset = 14695981039346656037ull;
+  void Hash(unsigned long long &h, const void* data, size_t n) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < n; ++i) {
+      h ^= bytes[i];
+      h *= 1099511628211ull;
+    }
+  }
+  template<typename T> void Hash(unsigned long long &h, const T& value) { Hash(h, &value, sizeof(T)); }
+  void Hash(unsigned long long &h, const std::string& str) { Hash(h, str.size()); Hash(h, str.data(), str.size()); }
+}
+
 
 
 /// Standard constructor with null selection
@@ -98,6 +139,8 @@ AliEventCuts::AliEventCuts(bool saveplots) : TList(),
   fCentPercentiles{-1.f},
   fPrimaryVertex{nullptr},
   fNewEvent{true},
+  fConfigurationHash{0ull},
+  fUtilsHash{0ull},
   fOverrideAutoTriggerMask{false},
   fOverrideAutoPileUpCuts{false},
   fMultSelectionEvCuts{false},  
@@ -149,12 +192,128 @@ bool AliEventCuts::AcceptEvent(AliVEvent *ev) {
     if (fUseTimeRangeCut) {
       fTimeRangeCut.InitFromRunNumber(fCurrentRun);
     }
+    /// The pile-up settings of the analysis utils have no getters: their streamed content enters the configuration hash
+    TBufferFile buf(TBuffer::kWrite);
+    fUtils.Streamer(buf);
+    fUtilsHash = kHashOffset;
+    Hash(fUtilsHash, buf.Buffer(), buf.Length());
   }
 
   if (fSavePlots && !this->Last()) {
     AddQAplotsToList();
   }
 
+  /// Instances with the same configuration share the selection of the current event: only the first one evaluates it.
+  /// The EMCal LED cut and the QA histograms are always handled by each instance.
+  int ntrkl = 0;
+  double dz = 0.;
+  const bool computeMult = fUseVariablesCorrelationCuts || fTOFvsFB32[0] || fUseStrongVarCorrelationCut || fUseTPCTracklCorrelationCut;
+  if (fgUseSharedSelection) {
+    fConfigurationHash = ComputeConfigurationHash(computeMult);
+    SharedSelection &shared = SharedSelections()[fConfigurationHash];
+    const Long64_t entry = AliAnalysisManager::GetAnalysisManager()->GetCurrentEntry();
+    const unsigned long evid = ((unsigned long)(ev->GetBunchCrossNumber()) << 32) + ev->GetTimeStamp();
+    if (shared.fEvent == ev && shared.fEntry == entry && shared.fEventId == evid && shared.fRun == fCurrentRun) {
+      fFlag = shared.fFlag;
+      fPrimaryVertex = shared.fPrimaryVertex;
+      if (TESTBIT(fFlag,kINELgt0) || fCentralityFramework) {
+        fCentPercentiles[0] = shared.fCentPercentiles[0];
+        fCentPercentiles[1] = shared.fCentPercentiles[1];
+      }
+      if (fUseMultiplicityDependentPileUpCuts) fSPDpileupMinContributors = shared.fSPDpileupMinContributors;
+      if (computeMult) {
+        fContainer = shared.fContainer;
+        fNewEvent = false;
+      }
+      ntrkl = shared.fNtrkl;
+      dz = shared.fDz;
+      shared.fSaved++;
+    } else {
+      SelectEvent(ev,ntrkl,dz);
+      shared.fEvent = ev;
+      shared.fEntry = entry;
+      shared.fEventId = evid;
+      shared.fRun = fCurrentRun;
+      shared.fFlag = fFlag;
+      shared.fPrimaryVertex = fPrimaryVertex;
+      shared.fCentPercentiles[0] = fCentPercentiles[0];
+      shared.fCentPercentiles[1] = fCentPercentiles[1];
+      shared.fSPDpileupMinContributors = fSPDpileupMinContributors;
+      if (computeMult) shared.fContainer = fContainer;
+      shared.fNtrkl = ntrkl;
+      shared.fDz = dz;
+      if (shared.fName.empty()) shared.fName = GetName();
+      shared.fEvaluated++;
+    }
+  } else
+    SelectEvent(ev,ntrkl,dz);
+
+  //
+  /// Check if the EMCal event is bad due to LED system flashes
+  //
+  if ( fUseEMCALLEDEventsCut )
+  {
+    if ( !fEMCALLEDEventsCut.IsEMCALLEDEvent(ev,fCurrentRun) ) 
+      fFlag |= BIT(kEMCALEDCut); // accept event
+  }
+  else 
+    fFlag |= BIT(kEMCALEDCut); // accept event
+  //
+  
+  /// Ignore SPD/tracks vertex position and reconstruction individual flags
+  bool allcuts = CheckNormalisationMask(kPassesAllCuts);
+  if (allcuts) {
+    fFlag |= BIT(kAllCuts);
+  }
+  if (fCutStats) {
+    for (int iCut = kNoCuts; iCut <= kAllCuts; ++iCut) {
+      if (TESTBIT(fFlag,iCut)) {
+        fCutStats->Fill(iCut);
+        if (TESTBIT(fFlag,kTrigger)) {
+          fCutStatsAfterTrigger->Fill(iCut);
+        }
+        if (TESTBIT(fFlag,kMultiplicity)) {
+          fCutStatsAfterMultSelection->Fill(iCut);
+        }
+      }
+    }
+  }
+
+  /// Filling normalisation histogram
+  array <NormMask,5> norm_masks {
+    kAnyEvent,
+    kTriggeredEvent,
+    kPassesNonVertexRelatedSelections,
+    kHasReconstructedVertex,
+    kPassesAllCuts
+  };
+  for (int iC = 0; iC < 5; ++iC) {
+    if (CheckNormalisationMask(norm_masks[iC])) {
+      if (fNormalisationHist) {
+        fNormalisationHist->Fill(iC);
+      }
+    }
+  }
+
+  /// Filling the monitoring histograms (first iteration always filled, second iteration only for selected events.
+  for (int befaft = 0; befaft < 2; ++befaft) {
+    if (fCentrality[befaft]) fCentrality[befaft]->Fill(fCentPercentiles[0]);
+    if (fEstimCorrelation[befaft]) fEstimCorrelation[befaft]->Fill(fCentPercentiles[1],fCentPercentiles[0]);
+    if (fMultCentCorrelation[befaft]) fMultCentCorrelation[befaft]->Fill(fCentPercentiles[0],ntrkl);
+    if (fVtz[befaft]) fVtz[befaft]->Fill(fPrimaryVertex->GetZ());
+    if (fDeltaTrackSPDvtz[befaft]) fDeltaTrackSPDvtz[befaft]->Fill(dz);
+    if (fTOFvsFB32[befaft]) fTOFvsFB32[befaft]->Fill(fContainer.fMultTrkFB32,fContainer.fMultTrkFB32TOF);
+    if (fTPCvsAll[befaft])  fTPCvsAll[befaft]->Fill(fContainer.fMultTrkTPC,float(fContainer.fMultESD) - fESDvsTPConlyLinearCut[1] * fContainer.fMultTrkTPC);
+    if (fMultvsV0M[befaft]) fMultvsV0M[befaft]->Fill(GetCentrality(),fContainer.fMultTrkFB32Acc);
+    if (fTPCvsTrkl[befaft]) fTPCvsTrkl[befaft]->Fill(ntrkl,fContainer.fMultTrkTPC);
+    if (fVZEROvsTPCout[befaft]) fVZEROvsTPCout[befaft]->Fill(fContainer.fMultTrkTPCout,fContainer.fMultVZERO);
+    if (!allcuts) return false; /// Do not fill the "after" histograms if the event does not pass the cuts.
+  }
+
+  return true;
+}
+
+void AliEventCuts::SelectEvent(AliVEvent *ev, int &ntrkl, double &dz) {
   /// Event selection flag, as soon as the event does not pass one cut this becomes false.
   fFlag = BIT(kNoCuts);
 
@@ -210,7 +369,7 @@ bool AliEventCuts::AcceptEvent(AliVEvent *ev) {
   double covTrc[6],covSPD[6];
   vtTrc->GetCovarianceMatrix(covTrc);
   vtSPD->GetCovarianceMatrix(covSPD);
-  double dz = bool(fFlag & kVertexSPD) && bool(fFlag & kVertexTracks) ? vtTrc->GetZ() - vtSPD->GetZ() : 0.; /// If one of the two vertices is not available this cut is always passed.
+  dz = bool(fFlag & kVertexSPD) && bool(fFlag & kVertexTracks) ? vtTrc->GetZ() - vtSPD->GetZ() : 0.; /// If one of the two vertices is not available this cut is always passed.
   double errTot = TMath::Sqrt(covTrc[5]+covSPD[5]);
   double errTrc = bool(fFlag & kVertexTracks) ? TMath::Sqrt(covTrc[5]) : 1.;
   double nsigTot = TMath::Abs(dz) / errTot, nsigTrc = TMath::Abs(dz) / errTrc;
@@ -228,7 +387,7 @@ bool AliEventCuts::AcceptEvent(AliVEvent *ev) {
   bool usePileUpMV = (fUseCombinedMVSPDcut && vtx != vtSPD) || fPileUpCutMV;
   bool usePileUpSPD = (fUseCombinedMVSPDcut && vtx == vtSPD) || fUseSPDpileUpCut;
   AliVMultiplicity* mult = ev->GetMultiplicity();
-  const int ntrkl = mult->GetNumberOfTracklets();
+  ntrkl = mult->GetNumberOfTracklets();
 
   if (fUseMultiplicityDependentPileUpCuts) {
     if (ntrkl < 20) fSPDpileupMinContributors = 3;
@@ -324,70 +483,83 @@ bool AliEventCuts::AcceptEvent(AliVEvent *ev) {
   } else {
     fFlag |= BIT(kTimeRangeCut);
   }
+}
 
-  //
-  /// Check if the EMCal event is bad due to LED system flashes
-  //
-  if ( fUseEMCALLEDEventsCut )
-  {
-    if ( !fEMCALLEDEventsCut.IsEMCALLEDEvent(ev,fCurrentRun) ) 
-      fFlag |= BIT(kEMCALEDCut); // accept event
-  }
-  else 
-    fFlag |= BIT(kEMCALEDCut); // accept event
-  //
-  
-  /// Ignore SPD/tracks vertex position and reconstruction individual flags
-  bool allcuts = CheckNormalisationMask(kPassesAllCuts);
-  if (allcuts) {
-    fFlag |= BIT(kAllCuts);
-  }
-  if (fCutStats) {
-    for (int iCut = kNoCuts; iCut <= kAllCuts; ++iCut) {
-      if (TESTBIT(fFlag,iCut)) {
-        fCutStats->Fill(iCut);
-        if (TESTBIT(fFlag,kTrigger)) {
-          fCutStatsAfterTrigger->Fill(iCut);
-        }
-        if (TESTBIT(fFlag,kMultiplicity)) {
-          fCutStatsAfterMultSelection->Fill(iCut);
-        }
-      }
-    }
+unsigned long long AliEventCuts::ComputeConfigurationHash(bool computeMult) {
+  unsigned long long h = kHashOffset;
+  Hash(h, computeMult);
+  Hash(h, fMC);
+  Hash(h, fRequireTrackVertex);
+  Hash(h, fMinVtz);
+  Hash(h, fMaxVtz);
+  Hash(h, fMaxDeltaSpdTrackAbsolute);
+  Hash(h, fMaxDeltaSpdTrackNsigmaSPD);
+  Hash(h, fMaxDeltaSpdTrackNsigmaTrack);
+  Hash(h, fMaxResolutionSPDvertex);
+  Hash(h, fMaxDispersionSPDvertex);
+  Hash(h, fCheckAODvertex);
+  Hash(h, fRejectDAQincomplete);
+  Hash(h, fRequiredSolenoidPolarity);
+  Hash(h, fUseCombinedMVSPDcut);
+  Hash(h, fUseMultiplicityDependentPileUpCuts);
+  Hash(h, fUseSPDpileUpCut);
+  /// With the multiplicity dependent pile-up cuts the minimum number of contributors is set event by event
+  if (!fUseMultiplicityDependentPileUpCuts) Hash(h, fSPDpileupMinContributors);
+  Hash(h, fSPDpileupMinZdist);
+  Hash(h, fSPDpileupNsigmaZdist);
+  Hash(h, fSPDpileupNsigmaDiamXY);
+  Hash(h, fSPDpileupNsigmaDiamZ);
+  Hash(h, fTrackletBGcut);
+  Hash(h, fPileUpCutMV);
+  Hash(h, fUtilsHash);
+  Hash(h, fCentralityFramework);
+  Hash(h, fMinCentrality);
+  Hash(h, fMaxCentrality);
+  Hash(h, fCentEstimators[0]);
+  Hash(h, fCentEstimators[1]);
+  Hash(h, fMultSelectionEvCuts);
+  Hash(h, fSelectInelGt0);
+  Hash(h, fUseVariablesCorrelationCuts);
+  Hash(h, fUseEstimatorsCorrelationCut);
+  Hash(h, fUseStrongVarCorrelationCut);
+  Hash(h, fUseITSTPCCluCorrelationCut);
+  Hash(h, fUseTPCTracklCorrelationCut);
+  Hash(h, fEstimatorsCorrelationCoef);
+  Hash(h, fEstimatorsSigmaPars);
+  Hash(h, fDeltaEstimatorNsigma);
+  Hash(h, fTOFvsFB32correlationPars);
+  Hash(h, fTOFvsFB32sigmaPars);
+  Hash(h, fTOFvsFB32nSigmaCut);
+  Hash(h, fESDvsTPConlyLinearCut);
+  Hash(h, fFB128vsTrklLinearCut);
+  Hash(h, fVZEROvsTPCoutPolCut);
+  Hash(h, fITSvsTPCcluPolCut);
+  if (fMultiplicityV0McorrCut) {
+    Hash(h, std::string(fMultiplicityV0McorrCut->GetTitle()));
+    for (int iP = 0; iP < fMultiplicityV0McorrCut->GetNpar(); ++iP)
+      Hash(h, fMultiplicityV0McorrCut->GetParameter(iP));
   }
+  Hash(h, fRequireExactTriggerMask);
+  Hash(h, fTriggerMask);
+  Hash(h, fTriggerClasses.size());
+  for (const std::string& myClass : fTriggerClasses)
+    Hash(h, myClass);
+  Hash(h, fUseTimeRangeCut);
+  Hash(h, std::string(fTimeRangeCut.GetOADPath().Data()));
+  return h;
+}
 
-  /// Filling normalisation histogram
-  array <NormMask,5> norm_masks {
-    kAnyEvent,
-    kTriggeredEvent,
-    kPassesNonVertexRelatedSelections,
-    kHasReconstructedVertex,
-    kPassesAllCuts
-  };
-  for (int iC = 0; iC < 5; ++iC) {
-    if (CheckNormalisationMask(norm_masks[iC])) {
-      if (fNormalisationHist) {
-        fNormalisationHist->Fill(iC);
-      }
-    }
-  }
+unsigned long AliEventCuts::GetNumberOfSavedEvaluations() const {
+  auto shared = SharedSelections().find(fConfigurationHash);
+  return shared == SharedSelections().end() ? 0u : shared->second.fSaved;
+}
 
-  /// Filling the monitoring histograms (first iteration always filled, second iteration only for selected events.
-  for (int befaft = 0; befaft < 2; ++befaft) {
-    if (fCentrality[befaft]) fCentrality[befaft]->Fill(fCentPercentiles[0]);
-    if (fEstimCorrelation[befaft]) fEstimCorrelation[befaft]->Fill(fCentPercentiles[1],fCentPercentiles[0]);
-    if (fMultCentCorrelation[befaft]) fMultCentCorrelation[befaft]->Fill(fCentPercentiles[0],ntrkl);
-    if (fVtz[befaft]) fVtz[befaft]->Fill(vtx->GetZ());
-    if (fDeltaTrackSPDvtz[befaft]) fDeltaTrackSPDvtz[befaft]->Fill(dz);
-    if (fTOFvsFB32[befaft]) fTOFvsFB32[befaft]->Fill(fContainer.fMultTrkFB32,fContainer.fMultTrkFB32TOF);
-    if (fTPCvsAll[befaft])  fTPCvsAll[befaft]->Fill(fContainer.fMultTrkTPC,float(fContainer.fMultESD) - fESDvsTPConlyLinearCut[1] * fContainer.fMultTrkTPC);
-    if (fMultvsV0M[befaft]) fMultvsV0M[befaft]->Fill(GetCentrality(),fContainer.fMultTrkFB32Acc);
-    if (fTPCvsTrkl[befaft]) fTPCvsTrkl[befaft]->Fill(ntrkl,fContainer.fMultTrkTPC);
-    if (fVZEROvsTPCout[befaft]) fVZEROvsTPCout[befaft]->Fill(fContainer.fMultTrkTPCout,fContainer.fMultVZERO);
-    if (!allcuts) return false; /// Do not fill the "after" histograms if the event does not pass the cuts.
+void AliEventCuts::PrintSharedSelectionStatistics() {
+  printf("AliEventCuts: %lu configurations sharing the event selection\n", (unsigned long)SharedSelections().size());
+  for (const auto& shared : SharedSelections()) {
+    printf("  %016llx %-40s evaluated %10lu saved %10lu\n", shared.first, shared.second.fName.data(),
+        shared.second.fEvaluated, shared.second.fSaved);
   }
-
-  return true;
 }
 
 void AliEventCuts::AddQAplotsToList(TList *qaList, bool addCorrelationPlots) {
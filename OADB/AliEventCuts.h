@@ -105,6 +105,13 @@ class AliEventCuts : public TList {
 
     static bool GoodPrimaryAODVertex(AliVEvent *ev);
 
+    /// The instances with the same configuration (e.g. the wagons of a train) share the selection of the current event:
+    /// only the first instance evaluates the cuts, the others reuse its selection flag and multiplicities.
+    /// Off by default, it has to be switched on (e.g. in the AddTask macro) to be used.
+    static void   SetUseSharedSelection(bool use = true) { fgUseSharedSelection = use; }
+    static void   PrintSharedSelectionStatistics();
+    unsigned long GetNumberOfSavedEvaluations() const;
+
     /// set up the usage of the time range cut
     void UseTimeRangeCut() { fUseTimeRangeCut = true;}
 
@@ -197,6 +204,8 @@ class AliEventCuts : public TList {
     AliEventCuts operator=(const AliEventCuts& copy);
     void          AutomaticSetup (AliVEvent *ev);
     void          ComputeTrackMultiplicity(AliVEvent *ev);
+    void          SelectEvent(AliVEvent *ev, int &ntrkl, double &dz);
+    unsigned long long ComputeConfigurationHash(bool computeMult);
     template<typename F> F PolN(F x, F* coef, int n);
 
     bool          fManualMode;                    ///< if true the cuts are not loaded automatically looking at the run number
@@ -210,6 +219,9 @@ class AliEventCuts : public TList {
 
     ///
     bool          fNewEvent;                      ///<  True if the AliVEvent identifier in the AcceptEvent and fIdentifier are different
+    unsigned long long fConfigurationHash;        //!<! Hash of the configuration used for the last event
+    unsigned long long fUtilsHash;                //!<! Hash of the analysis utils settings, updated at each run change
+    static bool   fgUseSharedSelection;           ///<  Share the event selection among the instances with the same configuration
     /// Overrides
     bool          fOverrideAutoTriggerMask;       ///<  If true the trigger mask chosen by the user is not overridden by the Automatic Setup
     bool          fOverrideAutoPileUpCuts;        ///<  If true the pile-up cuts are defined by the user.
@@ -245,7 +257,7 @@ class AliEventCuts : public TList {
     AliESDtrackCuts* fFB32trackCuts; //!<! Cuts corresponding to FB32 in the ESD (used only for correlations cuts in ESDs)
     AliESDtrackCuts* fTPConlyCuts;   //!<! Cuts corresponding to the standalone TPC cuts in the ESDs (used only for correlations cuts in ESDs)
 
-    ClassDef(AliEventCuts, 15)
+    ClassDef(AliEventCuts, 16)
 };
 
 template<typename F> F AliEventCuts::PolN(F x,F* coef, int n) {
@@ -20,11 +20,14 @@
 #include "TBrowser.h"
 #include "TFormula.h"
 #include "RVersion.h"
+#include <cctype>
+#include <cstdlib>
 
 ClassImp(AliMultEstimator);
 //________________________________________________________________
 AliMultEstimator::AliMultEstimator() :
   TNamed(), fDefinition(""), fIsInteger(kFALSE), fValue(0), fMean(0), fPercentile(0), fFormula(0),
+fProgramOp(), fProgramArg(), fStack(),
 fkUseAnchor(kFALSE), fAnchorPoint(0), fAnchorPercentile(100.0)
 {
   // Constructor
@@ -32,6 +35,7 @@ fkUseAnchor(kFALSE), fAnchorPoint(0), fAnchorPercentile(100.0)
 }
 AliMultEstimator::AliMultEstimator(const char * name, const char * title, TString lInitDef):
 TNamed(name,title), fDefinition(""), fIsInteger(kFALSE), fValue(0), fMean(0), fPercentile(0), fFormula(0),
+fProgramOp(), fProgramArg(), fStack(),
 fkUseAnchor(kFALSE), fAnchorPoint(0), fAnchorPercentile(100.0)
 {
     //Named, titled, definition constructor
@@ -46,6 +50,9 @@ fValue(e.fValue),
 fMean(e.fMean),
 fPercentile(e.fPercentile),
 fFormula(0),
+fProgramOp(e.fProgramOp),
+fProgramArg(e.fProgramArg),
+fStack(),
 fkUseAnchor(e.fkUseAnchor),
 fAnchorPoint(e.fAnchorPoint),
 fAnchorPercentile(e.fAnchorPercentile)
@@ -67,6 +74,8 @@ AliMultEstimator& AliMultEstimator::operator=(const AliMultEstimator& e)
     if (fFormula) delete fFormula;
     fFormula = 0;
     if (e.fFormula) fFormula = new TFormula(*e.fFormula);
+    fProgramOp   = e.fProgramOp;
+    fProgramArg  = e.fProgramArg;
     
     //Anchor point configs
     fkUseAnchor         = e.fkUseAnchor;
@@ -121,6 +130,22 @@ void AliMultEstimator::SetupFormula(const AliMultInput* lInput)
         lVarName.Prepend("(");
         expr.ReplaceAll(lVarName, repl);
     }
+    if (fFormula) delete fFormula;
+    fFormula = 0;
+    //Definitions made of variables, numbers, parentheses and + - * / !
+    //(all standard estimators) are compiled to a flat program, evaluated
+    //in double precision with the operator precedence of C++ like TFormula.
+    //Anything else (functions, comparisons, ...) is left to TFormula.
+    if ( CompileFormula(expr) ) {
+        for (size_t i = 0; i < fProgramOp.size(); i++) {
+            if (fProgramOp[i] == kPushVar && fProgramArg[i] >= nVar) {
+                fProgramOp.clear();
+                fProgramArg.clear();
+                break;
+            }
+        }
+        if (!fProgramOp.empty()) return;
+    }
     fFormula = new TFormula(Form("e%s", GetName()), expr);
 #if ROOT_VERSION_CODE < ROOT_VERSION(5,99,4)
     fFormula->Optimize();
@@ -129,6 +154,28 @@ void AliMultEstimator::SetupFormula(const AliMultInput* lInput)
 //________________________________________________________________
 Float_t AliMultEstimator::Evaluate(const AliMultInput* lInput)
 {
+    if (!fProgramOp.empty()) {
+        //Stack machine for the compiled definition
+        fStack.resize(fProgramOp.size());
+        Int_t lTop = -1;
+        for (size_t i = 0; i < fProgramOp.size(); i++) {
+            switch (fProgramOp[i]) {
+                case kPushConst: fStack[++lTop] = fProgramArg[i]; break;
+                case kPushVar: {
+                    AliMultVariable* v = lInput->GetVariable((Long_t)fProgramArg[i]);
+                    fStack[++lTop] = v->IsInteger() ? v->GetValueInteger() : v->GetValue();
+                    break;
+                }
+                case kNeg: fStack[lTop] = -fStack[lTop]; break;
+                case kNot: fStack[lTop] = !fStack[lTop]; break;
+                case kAdd: lTop--; fStack[lTop] = fStack[lTop] + fStack[lTop+1]; break;
+                case kSub: lTop--; fStack[lTop] = fStack[lTop] - fStack[lTop+1]; break;
+                case kMul: lTop--; fStack[lTop] = fStack[lTop] * fStack[lTop+1]; break;
+                case kDiv: lTop--; fStack[lTop] = fStack[lTop] / fStack[lTop+1]; break;
+            }
+        }
+        return fValue = fStack[0];
+    }
     if (!fFormula) return fValue = 0;
     for (Int_t i = 0; i < lInput->GetNVariables(); i++) {
         AliMultVariable* v = lInput->GetVariable(i);
@@ -138,3 +185,97 @@ Float_t AliMultEstimator::Evaluate(const AliMultInput* lInput)
     }
     return fValue = fFormula->Eval(0);
 }
+//________________________________________________________________
+Bool_t AliMultEstimator::CompileFormula(const TString& lExpr)
+{
+    fProgramOp.clear();
+    fProgramArg.clear();
+    const char* p = lExpr.Data();
+    Bool_t lIsInteger = kFALSE;
+    Bool_t lSuccess = CompileSum(p, lIsInteger);
+    while (lSuccess && isspace(*p)) p++;
+    if (!lSuccess || *p != '\0') {
+        fProgramOp.clear();
+        fProgramArg.clear();
+        return kFALSE;
+    }
+    return kTRUE;
+}
+//________________________________________________________________
+Bool_t AliMultEstimator::CompileSum(const char*& p, Bool_t& lIsInteger)
+{
+    if (!CompileProduct(p, lIsInteger)) return kFALSE;
+    while (kTRUE) {
+        while (isspace(*p)) p++;
+        if (*p != '+' && *p != '-') return kTRUE;
+        Int_t lOp = (*p == '+') ? kAdd : kSub;
+        p++;
+        Bool_t lIsIntegerRight = kFALSE;
+        if (!CompileProduct(p, lIsIntegerRight)) return kFALSE;
+        fProgramOp.push_back(lOp);
+        fProgramArg.push_back(0);
+        lIsInteger = lIsInteger && lIsIntegerRight;
+    }
+}
+//________________________________________________________________
+Bool_t AliMultEstimator::CompileProduct(const char*& p, Bool_t& lIsInteger)
+{
+    if (!CompileUnary(p, lIsInteger)) return kFALSE;
+    while (kTRUE) {
+        while (isspace(*p)) p++;
+        if (*p != '*' && *p != '/') return kTRUE;
+        Int_t lOp = (*p == '*') ? kMul : kDiv;
+        p++;
+        Bool_t lIsIntegerRight = kFALSE;
+        if (!CompileUnary(p, lIsIntegerRight)) return kFALSE;
+        //Integer division of constants: leave it to TFormula
+        if (lOp == kDiv && lIsInteger && lIsIntegerRight) return kFALSE;
+        fProgramOp.push_back(lOp);
+        fProgramArg.push_back(0);
+        lIsInteger = lIsInteger && lIsIntegerRight;
+    }
+}
+//________________________________________________________________
+Bool_t AliMultEstimator::CompileUnary(const char*& p, Bool_t& lIsInteger)
+{
+    while (isspace(*p)) p++;
+    lIsInteger = kFALSE;
+    if (*p == '-' || *p == '+' || *p == '!') {
+        char lOp = *p;
+        p++;
+        if (!CompileUnary(p, lIsInteger)) return kFALSE;
+        if (lOp == '-') { fProgramOp.push_back(kNeg); fProgramArg.push_back(0); }
+        if (lOp == '!') { fProgramOp.push_back(kNot); fProgramArg.push_back(0); lIsInteger = kTRUE; }
+        return kTRUE;
+    }
+    if (*p == '(') {
+        p++;
+        if (!CompileSum(p, lIsInteger)) return kFALSE;
+        while (isspace(*p)) p++;
+        if (*p != ')') return kFALSE;
+        p++;
+        return kTRUE;
+    }
+    if (*p == '[') {
+        char* lEnd = 0;
+        long lIndex = strtol(p+1, &lEnd, 10);
+        if (lEnd == p+1 || *lEnd != ']' || lIndex < 0) return kFALSE;
+        p = lEnd + 1;
+        fProgramOp.push_back(kPushVar);
+        fProgramArg.push_back(lIndex);
+        return kTRUE;
+    }
+    if (isdigit(*p) || *p == '.') {
+        char* lEnd = 0;
+        Double_t lValue = strtod(p, &lEnd);
+        if (lEnd == p) return kFALSE;
+        //Integer literals are integers in C++
+        lIsInteger = kTRUE;
+        for (const char* q = p; q < lEnd; q++) if (*q == '.' || *q == 'e' || *q == 'E') lIsInteger = kFALSE;
+        p = lEnd;
+        fProgramOp.push_back(kPushConst);
+        fProgramArg.push_back(lValue);
+        return kTRUE;
+    }
+    return kFALSE;
+}
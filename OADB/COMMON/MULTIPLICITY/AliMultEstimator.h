@@ -1,6 +1,7 @@
 #ifndef AliMultEstimator_H
 #define AliMultEstimator_H
 #include <TNamed.h>
+#include <vector>
 class AliMultInput;
 class TFormula;
 
@@ -43,8 +44,17 @@ public:
     //Pre-processing for speed
     void SetupFormula(const AliMultInput* lInput);
     Float_t Evaluate(const AliMultInput* lInput);
+    Bool_t IsCompiled() const { return !fProgramOp.empty(); }
     
 private:
+    //Compilation of simple definitions to a flat program (see SetupFormula)
+    enum EProgramOp { kPushConst, kPushVar, kNeg, kNot, kAdd, kSub, kMul, kDiv };
+    Bool_t CompileFormula(const TString& lExpr);
+    Bool_t CompileSum(const char*& p, Bool_t& lIsInteger);
+    Bool_t CompileProduct(const char*& p, Bool_t& lIsInteger);
+    Bool_t CompileUnary(const char*& p, Bool_t& lIsInteger);
+    
+
     TString fDefinition; //How to evaluate based on AliMultVariables
     Bool_t fIsInteger; //Requires special treatment when calibrating
     
@@ -52,6 +62,9 @@ private:
     Float_t fMean;   // estimator mean value
     Float_t fPercentile;   //Percentile
     TFormula* fFormula; //!
+    std::vector<Int_t>    fProgramOp;  //! operations of the compiled definition
+    std::vector<Double_t> fProgramArg; //! constant or variable index of each operation
+    std::vector<Double_t> fStack;      //! evaluation stack of the compiled definition
     
     //Anchor point definition
     Bool_t  fkUseAnchor;        //Use Anchor Logic (default: No)
@@ -202,6 +202,14 @@ AliMultEstimator* AliMultSelection::GetEstimator (Long_t lEstIdx) const
     return static_cast<AliMultEstimator*>(fEstimatorList->At(lEstIdx));
 }
 //________________________________________________________________
+Int_t AliMultSelection::GetEstimatorHandle (const TString& lName) const
+{
+    if (!fEstimatorList) return -1;
+    TObject *lThis = fEstimatorList->FindObject(lName);
+    if (!lThis) return -1;
+    return fEstimatorList->IndexOf(lThis);
+}
+//________________________________________________________________
 void AliMultSelection::PrintInfo()
 {
     cout<<"AliMultSelection Name..: "<<GetName()<<endl;
@@ -225,6 +233,20 @@ Float_t AliMultSelection::GetMultiplicityPercentile(TString lName, Bool_t lEmbed
     return lReturnValue;
 }
 
+//________________________________________________________________
+Float_t AliMultSelection::GetMultiplicityPercentile(Int_t lHandle, Bool_t lEmbedEvSel)
+{
+    //Same as above, without the look-up of the estimator by name
+    Float_t lReturnValue = AliMultSelectionCuts::kNoCalib;
+    AliMultEstimator *lThis = GetEstimator((Long_t)lHandle);
+    if( lThis ){
+        lReturnValue = lThis->GetPercentile();
+        //Bypass event selection if requested to do so 
+        if ( fEvSelCode > 0 && lEmbedEvSel ) lReturnValue = fEvSelCode;
+    }
+    return lReturnValue;
+}
+
 //________________________________________________________________
 Bool_t AliMultSelection::IsEventSelected()
 //Function to determine if event has been selected: simple boolean output 
@@ -28,8 +28,14 @@ public:
     AliMultEstimator* GetEstimator (Long_t lEstIdx) const;
     Long_t GetNEstimators () { return fNEsts; }
     
+    //Estimator handles: position of the estimator in the list, to be resolved
+    //once by name (e.g. GetEstimatorHandle("V0M")) and used for all events
+    //with the same multiplicity OADB set-up; -1 if the estimator does not exist
+    Int_t GetEstimatorHandle (const TString& lName) const;
+    
     //User Functions to get percentiles
     Float_t GetMultiplicityPercentile(TString lName, Bool_t lEmbedEvSel = kFALSE);
+    Float_t GetMultiplicityPercentile(Int_t lHandle, Bool_t lEmbedEvSel = kFALSE);
     Float_t GetZ(TString lName) { return GetEstimator(lName.Data())->GetZ(); }
     
     //Setter and Getter for Event Selection code
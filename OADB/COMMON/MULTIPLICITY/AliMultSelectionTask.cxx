@@ -1803,23 +1803,24 @@ void AliMultSelectionTask::UserExec(Option_t *)
         
         //Determine Quantiles from calibration histogram
         TH1F *lThisCalibHisto = 0x0;
-        TString lThisCalibHistoName;
         Float_t lThisQuantile = -1;
+        AliMultEstimator *lThisEstimator = 0x0;
+        TIter lNextEstimator(lSelection->GetEstimatorList());
         for(Long_t iEst=0; iEst<lSelection->GetNEstimators(); iEst++) {
+            lThisEstimator = static_cast<AliMultEstimator*>(lNextEstimator());
             //Changed: no need for run number, object already matches required one
-            lThisCalibHistoName = Form("hCalib_%s",lSelection->GetEstimator(iEst)->GetName());
-            lThisCalibHisto = 0x0;
-            lThisCalibHisto = fOadbMultSelection->GetCalibHisto( lThisCalibHistoName );
+            //Histogram "hCalib_<estimator name>", looked up once per run in Setup()
+            lThisCalibHisto = fOadbMultSelection->GetCalibHistoForEstimator( iEst );
             if ( ! lThisCalibHisto ) {
                 lThisQuantile = AliMultSelectionCuts::kNoCalib;
                 if( iEst < fNDebug ) fQuantiles[iEst] = lThisQuantile;
-                lSelection->GetEstimator(iEst)->SetPercentile(lThisQuantile);
+                lThisEstimator->SetPercentile(lThisQuantile);
             } else {
-                lThisQuantile = lThisCalibHisto->GetBinContent( lThisCalibHisto->FindBin( lSelection->GetEstimator(iEst)->GetValue() ));
+                lThisQuantile = lThisCalibHisto->GetBinContent( lThisCalibHisto->FindBin( lThisEstimator->GetValue() ));
                 if( iEst < fNDebug ) {
                     fQuantiles[iEst] = lThisQuantile; //Debug, please
                 }
-                lSelection->GetEstimator(iEst)->SetPercentile(lThisQuantile);
+                lThisEstimator->SetPercentile(lThisQuantile);
             }
         }
         
@@ -17,7 +17,7 @@ ClassImp(AliOADBMultSelection);
 //________________________________________________________________
 //Constructors/Destructor
 AliOADBMultSelection::AliOADBMultSelection() :
-TNamed("multSel",""), fCalibList(0), fEventCuts(0), fSelection(0), fMap(0)
+TNamed("multSel",""), fCalibList(0), fEventCuts(0), fSelection(0), fMap(0), fEstimatorHisto()
 {
     // constructor
     // fCalibList = new TList();
@@ -29,7 +29,7 @@ AliOADBMultSelection::AliOADBMultSelection(const AliOADBMultSelection& o)
 fCalibList(0),
 fEventCuts(0),
 fSelection(0),
-fMap(0)
+fMap(0), fEstimatorHisto()
 {
     fCalibList = new TList();
     fCalibList->SetOwner (kTRUE);
@@ -41,7 +41,7 @@ fMap(0)
 }
 //________________________________________________________________
 AliOADBMultSelection::AliOADBMultSelection(const char * name, const char * title) :
-TNamed(name, title), fCalibList(0), fEventCuts(0), fSelection(0), fMap(0)
+TNamed(name, title), fCalibList(0), fEventCuts(0), fSelection(0), fMap(0), fEstimatorHisto()
 {
     // constructor
     fCalibList = new TList();
@@ -61,6 +61,7 @@ AliOADBMultSelection& AliOADBMultSelection::operator=(const AliOADBMultSelection
         delete fMap;
         fMap = 0;
     }
+    fEstimatorHisto.clear();
     fCalibList = new TList();
     fCalibList->SetOwner (kTRUE);
     TIter next(o.fCalibList);
@@ -225,17 +226,32 @@ TH1F* AliOADBMultSelection::FindHisto(AliMultEstimator* e)
     return static_cast<TH1F*>(ret->Value());
 }
 //________________________________________________________________
+TH1F* AliOADBMultSelection::GetCalibHistoForEstimator(Long_t iEst) const
+{
+    //Calibration histogram "hCalib_<estimator name>" of the estimator at
+    //position iEst, from the table filled in Setup() if available
+    if (fSelection && (Long_t)fEstimatorHisto.size() == fSelection->GetNEstimators()) {
+        if (iEst < 0 || iEst >= (Long_t)fEstimatorHisto.size()) return 0;
+        return fEstimatorHisto[iEst];
+    }
+    AliMultEstimator* e = fSelection ? fSelection->GetEstimator(iEst) : 0;
+    if (!e) return 0;
+    return GetCalibHisto(TString(Form("hCalib_%s", e->GetName())));
+}
+//________________________________________________________________
 void AliOADBMultSelection::Setup()
 {
     if (fMap) {
         delete fMap;
         fMap = 0;
     }
+    fEstimatorHisto.clear();
     AliMultSelection* sel = GetMultSelection();
     if (!sel) return;
     
     fMap = new TMap;
     fMap->SetOwner(false);
+    fEstimatorHisto.resize(sel->GetNEstimators(), 0);
     
     for(Long_t iEst=0; iEst<sel->GetNEstimators(); iEst++) {
         AliMultEstimator* e = sel->GetEstimator(iEst);
@@ -246,6 +262,7 @@ void AliOADBMultSelection::Setup()
         if (!h) continue;
         
         fMap->Add(e, h);
+        fEstimatorHisto[iEst] = h;
     }
 }
 
@@ -2,6 +2,7 @@
 #define ALIOADBMULTSELECTION_H
 
 #include <TNamed.h>
+#include <vector>
 #include <AliMultSelection.h>
 class TBrowser;
 class TH1F;
@@ -39,6 +40,7 @@ public:
     //Use internal map
     void Setup();
     TH1F* FindHisto(AliMultEstimator* e);
+    TH1F* GetCalibHistoForEstimator(Long_t iEst) const;
     void Print(Option_t* option="") const;
     
 private:
@@ -46,6 +48,7 @@ private:
     AliMultSelectionCuts * fEventCuts; // EventCuts
     AliMultSelection     * fSelection; // Definition of Estimators
     TMap*                  fMap; //! Map estimator to histogram
+    std::vector<TH1F*>     fEstimatorHisto; //! Histogram of each estimator, by estimator index
     ClassDef(AliOADBMultSelection, 1)
     
     
@@ -3,8 +3,14 @@
 
 #include "AliEmcalCorrectionClusterTrackMatcher.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include <TH1.h>
 #include <TList.h>
+#include <TStopwatch.h>
+#include <TVector2.h>
+#include <TVector3.h>
 
 #include "AliClusterContainer.h"
 #include "AliParticleContainer.h"
@@ -38,14 +44,28 @@ AliEmcalCorrectionClusterTrackMatcher::AliEmcalCorrectionClusterTrackMatcher() :
   fUseOuterParamInESDs(kFALSE),
   fUpdateTracks(kTRUE),
   fUpdateClusters(kTRUE),
+  fUseMatchingGrid(kTRUE),
+  fBenchmarkMatching(kFALSE),
   fClusterContainerIndexMap(),
   fParticleContainerIndexMap(),
+  fMatches(),
+  fMatchesRef(),
+  fClusterEta(),
+  fClusterPhi(),
+  fGridStart(),
+  fGridClusters(),
+  fUnbinnedClusters(),
+  fCandidates(),
   fEmcalTracks(0),
   fEmcalClusters(0),
   fNEmcalTracks(0),
   fNEmcalClusters(0),
   fHistMatchEtaAll(0),
   fHistMatchPhiAll(0),
+  fHistMatchingTimeBruteForce(0),
+  fHistMatchingTimeGrid(0),
+  fHistMatchingMismatch(0),
+  fMatchingTimer(0),
   fNMCGenerToAccept(0),
   fMCGenerToAcceptForTrack(1)
 {
@@ -66,6 +86,7 @@ AliEmcalCorrectionClusterTrackMatcher::AliEmcalCorrectionClusterTrackMatcher() :
  */
 AliEmcalCorrectionClusterTrackMatcher::~AliEmcalCorrectionClusterTrackMatcher()
 {
+  delete fMatchingTimer;
 }
 
 /**
@@ -82,6 +103,8 @@ Bool_t AliEmcalCorrectionClusterTrackMatcher::Initialize()
   GetProperty("maxDist", fMaxDistance);
   GetProperty("updateClusters", fUpdateClusters);
   GetProperty("updateTracks", fUpdateTracks);
+  GetProperty("useMatchingGrid", fUseMatchingGrid);
+  GetProperty("benchmarkMatching", fBenchmarkMatching);
   fDoPropagation = fEsdMode;
   
   Bool_t enableFracEMCRecalc = kFALSE;
@@ -174,6 +197,20 @@ void AliEmcalCorrectionClusterTrackMatcher::UserCreateOutputObjects()
     }
     fOutput->SetOwner(kTRUE);
   }
+
+  if (fBenchmarkMatching) {
+    fHistMatchingTimeBruteForce = new TH1F("hMatchingTimeBruteForce", "hMatchingTimeBruteForce;Real Time (#mus)", 5000, 0, 50000);
+    fOutput->Add(fHistMatchingTimeBruteForce);
+    fHistMatchingTimeGrid = new TH1F("hMatchingTimeGrid", "hMatchingTimeGrid;Real Time (#mus)", 5000, 0, 50000);
+    fOutput->Add(fHistMatchingTimeGrid);
+    fHistMatchingMismatch = new TH1F("hMatchingMismatch", "hMatchingMismatch;Results of the two strategies;Events", 2, 0, 2);
+    fHistMatchingMismatch->GetXaxis()->SetBinLabel(1, "identical");
+    fHistMatchingMismatch->GetXaxis()->SetBinLabel(2, "different");
+    fOutput->Add(fHistMatchingMismatch);
+    fOutput->SetOwner(kTRUE);
+
+    fMatchingTimer = new TStopwatch();
+  }
 }
 
 /**
@@ -367,9 +404,43 @@ void AliEmcalCorrectionClusterTrackMatcher::GenerateEmcalParticles()
  * Set the links between tracks and clusters.
  */
 void AliEmcalCorrectionClusterTrackMatcher::DoMatching()
+{
+  if (fBenchmarkMatching) {
+    fMatchingTimer->Start(kTRUE);
+    FindMatchesBruteForce(fMatchesRef);
+    fMatchingTimer->Stop();
+    fHistMatchingTimeBruteForce->Fill(fMatchingTimer->RealTime() * 1e6);
+
+    fMatchingTimer->Start(kTRUE);
+    Bool_t grid = FindMatchesGrid(fMatches);
+    fMatchingTimer->Stop();
+    if (grid) {
+      fHistMatchingTimeGrid->Fill(fMatchingTimer->RealTime() * 1e6);
+      if (fMatches == fMatchesRef) {
+        fHistMatchingMismatch->Fill(0.5);
+      }
+      else {
+        fHistMatchingMismatch->Fill(1.5);
+        AliError(Form("Grid matching found %lu pairs, brute force matching %lu pairs", fMatches.size(), fMatchesRef.size()));
+      }
+    }
+  }
+  else if (!fUseMatchingGrid || !FindMatchesGrid(fMatches)) {
+    FindMatchesBruteForce(fMatches);
+  }
+
+  ApplyMatches(fBenchmarkMatching ? fMatchesRef : fMatches);
+}
+
+/**
+ * Compare every track with every cluster.
+ * @param[out] matches Pairs within the maximum distance, ordered by track and then by cluster index
+ */
+void AliEmcalCorrectionClusterTrackMatcher::FindMatchesBruteForce(std::vector<MatchCandidate> &matches)
 {
   const Double_t maxd2 = fMaxDistance*fMaxDistance;
 
+  matches.clear();
   for (Int_t itrack = 0; itrack < fNEmcalTracks; itrack++) {
     AliEmcalParticle* emcalTrack = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack));
     AliVTrack* track = emcalTrack->GetTrack();
@@ -384,30 +455,190 @@ void AliEmcalCorrectionClusterTrackMatcher::DoMatching()
       Double_t d2 = deta * deta + dphi * dphi;
 
       if (d2 > maxd2) continue;
-      
-      Double_t d = TMath::Sqrt(d2);
-      emcalCluster->AddMatchedObj(itrack, d);
-      emcalTrack->AddMatchedObj(icluster, d);
-      AliDebug(2, Form("Now matching cluster E = %.3f, pT = %.3f, eta = %.3f, phi = %.3f "
-                       "with track pT = %.3f, eta = %.3f, phi = %.3f"
-                       "Track eta, phi on EMCal = %.3f, %.3f, d = %.3f",
-                       cluster->GetNonLinCorrEnergy(), emcalCluster->Pt(), emcalCluster->Eta(), emcalCluster->Phi(),
-                       emcalTrack->Pt(), emcalTrack->Eta(), emcalTrack->Phi(),
-                       track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), d));
-      
-      if (fCreateHisto) {
-        Int_t mombin = GetMomBin(track->P());
-        Int_t centbinch = fCentBin;
-        if (track->Charge() < 0) centbinch += fNcentBins;
-        Int_t etabin = 0;
-        if(track->Eta() > 0) etabin = 1;
-
-        fHistMatchEta[centbinch][mombin][etabin]->Fill(deta);
-        fHistMatchPhi[centbinch][mombin][etabin]->Fill(dphi);
-        fHistMatchEtaAll->Fill(deta);
-        fHistMatchPhiAll->Fill(dphi);
+
+      MatchCandidate match = {itrack, icluster, deta, dphi};
+      matches.push_back(match);
+    }
+  }
+}
+
+/**
+ * Compare each track only with the clusters in the 3x3 cells of an eta-phi grid around
+ * its position on the EMCal surface. The cells are at least fMaxDistance wide, hence no
+ * pair within the maximum distance is missed; the candidates are tested in increasing
+ * cluster index with the same arithmetic as GetEtaPhiDiff, so the result is identical
+ * to the one of FindMatchesBruteForce.
+ * @param[out] matches Pairs within the maximum distance, ordered by track and then by cluster index
+ * @return kFALSE if the grid cannot be used for the configured maximum distance
+ */
+Bool_t AliEmcalCorrectionClusterTrackMatcher::FindMatchesGrid(std::vector<MatchCandidate> &matches)
+{
+  const Double_t maxd2 = fMaxDistance*fMaxDistance;
+  // Margin on the cell size against rounding at the cell edges
+  const Double_t width = fMaxDistance * (1 + 1e-6);
+  const Int_t maxCells = 100000;
+
+  if (!(fMaxDistance > 0)) return kFALSE;
+  const Int_t nPhi = static_cast<Int_t>(TMath::TwoPi() / width);
+  if (nPhi < 3) return kFALSE;
+  const Double_t phiScale = nPhi / TMath::TwoPi();
+
+  matches.clear();
+
+  // Cluster positions, computed once per event
+  fClusterEta.resize(fNEmcalClusters);
+  fClusterPhi.resize(fNEmcalClusters);
+  fUnbinnedClusters.clear();
+  Double_t etaMin = 0, etaMax = 0;
+  Bool_t first = kTRUE;
+  for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
+    Float_t pos[3] = {0};
+    emcalCluster->GetCluster()->GetPosition(pos);
+    TVector3 cpos(pos);
+    fClusterEta[icluster] = cpos.Eta();
+    fClusterPhi[icluster] = cpos.Phi();
+    if (!std::isfinite(fClusterEta[icluster]) || !std::isfinite(fClusterPhi[icluster])) {
+      fUnbinnedClusters.push_back(icluster);
+      continue;
+    }
+    if (first || fClusterEta[icluster] < etaMin) etaMin = fClusterEta[icluster];
+    if (first || fClusterEta[icluster] > etaMax) etaMax = fClusterEta[icluster];
+    first = kFALSE;
+  }
+
+  const Double_t nEtaD = first ? 0 : (etaMax - etaMin) / width + 1;
+  if (nEtaD * nPhi > maxCells) return kFALSE;
+  const Int_t nEta = static_cast<Int_t>(nEtaD);
+
+  // Fill the cells (counting sort, which keeps the clusters ascending within a cell)
+  fGridStart.assign(nEta * nPhi + 1, 0);
+  fGridClusters.resize(fNEmcalClusters - fUnbinnedClusters.size());
+  std::vector<Int_t>::const_iterator unbinned = fUnbinnedClusters.begin();
+  for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    if (unbinned != fUnbinnedClusters.end() && *unbinned == icluster) {
+      ++unbinned;
+      continue;
+    }
+    Int_t ieta = std::min(static_cast<Int_t>((fClusterEta[icluster] - etaMin) / width), nEta - 1);
+    Int_t iphi = std::min(static_cast<Int_t>((fClusterPhi[icluster] + TMath::Pi()) * phiScale), nPhi - 1);
+    fGridStart[ieta * nPhi + iphi + 1]++;
+  }
+  for (Int_t icell = 0; icell < nEta * nPhi; icell++) fGridStart[icell + 1] += fGridStart[icell];
+  std::vector<Int_t> cellFill(fGridStart.begin(), fGridStart.end() - 1);
+  unbinned = fUnbinnedClusters.begin();
+  for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    if (unbinned != fUnbinnedClusters.end() && *unbinned == icluster) {
+      ++unbinned;
+      continue;
+    }
+    Int_t ieta = std::min(static_cast<Int_t>((fClusterEta[icluster] - etaMin) / width), nEta - 1);
+    Int_t iphi = std::min(static_cast<Int_t>((fClusterPhi[icluster] + TMath::Pi()) * phiScale), nPhi - 1);
+    fGridClusters[cellFill[ieta * nPhi + iphi]++] = icluster;
+  }
+
+  for (Int_t itrack = 0; itrack < fNEmcalTracks; itrack++) {
+    AliEmcalParticle* emcalTrack = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack));
+    AliVTrack* track = emcalTrack->GetTrack();
+
+    Double_t veta = track->GetTrackEtaOnEMCal();
+    Double_t vphi = track->GetTrackPhiOnEMCal();
+
+    fCandidates.assign(fUnbinnedClusters.begin(), fUnbinnedClusters.end());
+    if (!std::isfinite(veta) || !std::isfinite(vphi)) {
+      // No position to look up: test all the clusters, as the brute force matching does
+      fCandidates.resize(fNEmcalClusters);
+      for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) fCandidates[icluster] = icluster;
+    }
+    else if (nEta > 0) {
+      Double_t x = (veta - etaMin) / width;
+      if (x > -1 && x < nEta + 1) {
+        Int_t ieta = static_cast<Int_t>(TMath::Floor(x));
+        Int_t iphi = std::min(static_cast<Int_t>((TVector2::Phi_mpi_pi(vphi) + TMath::Pi()) * phiScale), nPhi - 1);
+        for (Int_t jeta = std::max(ieta - 1, 0); jeta <= std::min(ieta + 1, nEta - 1); jeta++) {
+          for (Int_t dphiBin = -1; dphiBin <= 1; dphiBin++) {
+            Int_t icell = jeta * nPhi + (iphi + dphiBin + nPhi) % nPhi;
+            fCandidates.insert(fCandidates.end(), fGridClusters.begin() + fGridStart[icell], fGridClusters.begin() + fGridStart[icell + 1]);
+          }
+        }
+        std::sort(fCandidates.begin(), fCandidates.end());
       }
     }
+
+    for (std::vector<Int_t>::const_iterator it = fCandidates.begin(); it != fCandidates.end(); ++it) {
+      Int_t icluster = *it;
+      Double_t deta = veta - fClusterEta[icluster];
+      Double_t dphi = TVector2::Phi_mpi_pi(vphi - fClusterPhi[icluster]);
+      Double_t d2 = deta * deta + dphi * dphi;
+
+      if (d2 > maxd2) continue;
+
+      MatchCandidate match = {itrack, icluster, deta, dphi};
+      matches.push_back(match);
+    }
+  }
+
+  return kTRUE;
+}
+
+/**
+ * Same track and cluster, residuals equal within a small tolerance. A NaN residual
+ * only compares equal to a NaN residual, so that the benchmark does not report a
+ * mismatch when both matchers get NaN for the same pair.
+ * @param[in] o Other pair
+ * @return kTRUE if the two pairs are the same
+ */
+bool AliEmcalCorrectionClusterTrackMatcher::MatchCandidate::operator==(const MatchCandidate &o) const
+{
+  if (fTrack != o.fTrack || fCluster != o.fCluster) return false;
+
+  const Double_t tolerance = 1e-9;
+  const Double_t mine[2] = {fDeta, fDphi};
+  const Double_t other[2] = {o.fDeta, o.fDphi};
+  for (Int_t i = 0; i < 2; i++) {
+    Bool_t nan = TMath::IsNaN(mine[i]);
+    if (nan != TMath::IsNaN(other[i])) return false;
+    if (!nan && TMath::Abs(mine[i] - other[i]) > tolerance) return false;
+  }
+  return true;
+}
+
+/**
+ * Register the matched pairs in the AliEmcalParticle objects and fill the histograms.
+ * @param[in] matches Pairs within the maximum distance, ordered by track and then by cluster index
+ */
+void AliEmcalCorrectionClusterTrackMatcher::ApplyMatches(const std::vector<MatchCandidate> &matches)
+{
+  for (std::vector<MatchCandidate>::const_iterator it = matches.begin(); it != matches.end(); ++it) {
+    AliEmcalParticle* emcalTrack = static_cast<AliEmcalParticle*>(fEmcalTracks->At(it->fTrack));
+    AliVTrack* track = emcalTrack->GetTrack();
+    AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(it->fCluster));
+    AliVCluster* cluster = emcalCluster->GetCluster();
+
+    Double_t deta = it->fDeta;
+    Double_t dphi = it->fDphi;
+    Double_t d = TMath::Sqrt(deta * deta + dphi * dphi);
+    emcalCluster->AddMatchedObj(it->fTrack, d);
+    emcalTrack->AddMatchedObj(it->fCluster, d);
+    AliDebug(2, Form("Now matching cluster E = %.3f, pT = %.3f, eta = %.3f, phi = %.3f "
+                     "with track pT = %.3f, eta = %.3f, phi = %.3f"
+                     "Track eta, phi on EMCal = %.3f, %.3f, d = %.3f",
+                     cluster->GetNonLinCorrEnergy(), emcalCluster->Pt(), emcalCluster->Eta(), emcalCluster->Phi(),
+                     emcalTrack->Pt(), emcalTrack->Eta(), emcalTrack->Phi(),
+                     track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), d));
+    
+    if (fCreateHisto) {
+      Int_t mombin = GetMomBin(track->P());
+      Int_t centbinch = fCentBin;
+      if (track->Charge() < 0) centbinch += fNcentBins;
+      Int_t etabin = 0;
+      if(track->Eta() > 0) etabin = 1;
+
+      fHistMatchEta[centbinch][mombin][etabin]->Fill(deta);
+      fHistMatchPhi[centbinch][mombin][etabin]->Fill(dphi);
+      fHistMatchEtaAll->Fill(deta);
+      fHistMatchPhiAll->Fill(dphi);
+    }
   }
 }
 
@@ -4,11 +4,13 @@
 #include "AliEmcalCorrectionComponent.h"
 
 #if !(defined(__CINT__) || defined(__MAKECINT__))
+#include <vector>
 #include "AliEmcalContainerIndexMap.h"
 #endif
 
 class TH1;
 class TClonesArray;
+class TStopwatch;
 
 class AliVParticle;
 
@@ -45,6 +47,13 @@ class AliVParticle;
  ~~~
  (again assuming that the task is derived from AliAnalysisTaskEmcal or AliAnalysisTaskEmcalJet).
  *
+ * By default the candidate clusters of each track are looked up in an \f$\eta\f$-\f$\phi\f$ grid of
+ * cells at least `maxDist` wide, so that only the clusters in the 3x3 cells around the track position
+ * on the EMCal surface are compared to it. The result is identical to the comparison of every track
+ * with every cluster, which can still be selected with `useMatchingGrid: false`. With
+ * `benchmarkMatching: true` both strategies are run in each event, their timing is histogrammed
+ * and the events in which the results differ are counted (see PWG/EMCAL/macros/benchmarkClusterTrackMatching.C).
+ *
  * Based on code in AliEmcalClusTrackMatcherTask. 
  *
  * @author Constantin Loizides, LBNL, AliEmcalClusTrackMatcherTask
@@ -69,6 +78,19 @@ class AliEmcalCorrectionClusterTrackMatcher : public AliEmcalCorrectionComponent
   Int_t         GetMomBin(Double_t p) const;
   void          GenerateEmcalParticles();
   void          DoMatching();
+#if !(defined(__CINT__) || defined(__MAKECINT__))
+  /// Track-cluster pair found within the maximum distance
+  struct MatchCandidate {
+    Int_t       fTrack;                 ///< index of the track in fEmcalTracks
+    Int_t       fCluster;               ///< index of the cluster in fEmcalClusters
+    Double_t    fDeta;                  ///< eta difference track - cluster
+    Double_t    fDphi;                  ///< phi difference track - cluster
+    bool operator==(const MatchCandidate &o) const;
+  };
+  void          FindMatchesBruteForce(std::vector<MatchCandidate> &matches);
+  Bool_t        FindMatchesGrid(std::vector<MatchCandidate> &matches);
+  void          ApplyMatches(const std::vector<MatchCandidate> &matches);
+#endif
   void          UpdateTracks();
   void          UpdateClusters();
   Bool_t        IsTrackInEmcalAcceptance(AliVParticle* part, Double_t edges=0.9) const;
@@ -88,11 +110,22 @@ class AliEmcalCorrectionClusterTrackMatcher : public AliEmcalCorrectionComponent
   Bool_t        fUseOuterParamInESDs;   ///< Use TPC outer parameters instead of inner parameters for track propagation, ESDs only
   Bool_t        fUpdateTracks;          ///< update tracks with matching info
   Bool_t        fUpdateClusters;        ///< update clusters with matching info
+  Bool_t        fUseMatchingGrid;       ///< look up the candidate clusters in an eta-phi grid instead of testing all of them
+  Bool_t        fBenchmarkMatching;     ///< run both matching strategies, compare their results and histogram their timing
   
 #if !(defined(__CINT__) || defined(__MAKECINT__))
   // Handle mapping between index and containers
   AliEmcalContainerIndexMap <AliClusterContainer, AliVCluster> fClusterContainerIndexMap;    //!<! Mapping between index and cluster containers
   AliEmcalContainerIndexMap <AliParticleContainer, AliVParticle> fParticleContainerIndexMap; //!<! Mapping between index and particle containers
+
+  std::vector<MatchCandidate> fMatches;          //!<! pairs within the maximum distance in the current event
+  std::vector<MatchCandidate> fMatchesRef;       //!<! pairs found by the brute force matching (benchmark mode)
+  std::vector<Double_t> fClusterEta;             //!<! cluster eta, as used in GetEtaPhiDiff
+  std::vector<Double_t> fClusterPhi;             //!<! cluster phi, as used in GetEtaPhiDiff
+  std::vector<Int_t>    fGridStart;              //!<! first entry of each grid cell in fGridClusters (plus end marker)
+  std::vector<Int_t>    fGridClusters;           //!<! cluster indices sorted by grid cell, ascending within a cell
+  std::vector<Int_t>    fUnbinnedClusters;       //!<! clusters with non-finite position, tested against every track
+  std::vector<Int_t>    fCandidates;             //!<! candidate clusters of the current track
 #endif
 
   TClonesArray *fEmcalTracks;           //!<!emcal tracks
@@ -103,6 +136,10 @@ class AliEmcalCorrectionClusterTrackMatcher : public AliEmcalCorrectionComponent
   TH1          *fHistMatchPhiAll;       //!<!dphi distribution
   TH1          *fHistMatchEta[10][9][2]; //!<!deta distribution
   TH1          *fHistMatchPhi[10][9][2]; //!<!dphi distribution
+  TH1          *fHistMatchingTimeBruteForce; //!<!real time of the brute force matching (benchmark mode)
+  TH1          *fHistMatchingTimeGrid;  //!<!real time of the grid matching (benchmark mode)
+  TH1          *fHistMatchingMismatch;  //!<!events with identical/different results of the two strategies (benchmark mode)
+  TStopwatch   *fMatchingTimer;         //!<!timer of the matching strategies (benchmark mode)
   
   Int_t      fNMCGenerToAccept;          ///<  Number of MC generators that should not be included in analysis
   TString    fMCGenerToAccept[5];        ///<  List with name of generators that should not be included
@@ -116,7 +153,7 @@ private:
   static RegisterCorrectionComponent<AliEmcalCorrectionClusterTrackMatcher> reg;
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalCorrectionClusterTrackMatcher, 5); // EMCal cluster track matcher correction component
+  ClassDef(AliEmcalCorrectionClusterTrackMatcher, 6); // EMCal cluster track matcher correction component
   /// \endcond
 };
 
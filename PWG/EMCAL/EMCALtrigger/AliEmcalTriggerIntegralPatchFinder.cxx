@@ -0,0 +1,167 @@
+/**************************************************************************
+ * Copyright(c) 1998-2015, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include "AliEMCALTriggerDataGrid.h"
+#include "AliEMCALTriggerRawPatch.h"
+#include "AliEmcalTriggerIntegralPatchFinder.h"
+
+/// \cond CLASSIMP
+ClassImp(AliEmcalTriggerIntegralPatchFinder)
+/// \endcond
+
+namespace {
+  // Sums of integers below this value are exact in double precision
+  const Double_t kMaxExactSum = 4503599627370496.;   // 2^52
+}
+
+AliEmcalTriggerIntegralPatchFinder::AliEmcalTriggerIntegralPatchFinder():
+  TObject(),
+  fRowMin(),
+  fRowMax(),
+  fBitMask(),
+  fPatchSize(),
+  fSubregionSize(),
+  fADCImage(),
+  fOfflineADCImage()
+{
+}
+
+void AliEmcalTriggerIntegralPatchFinder::AddTriggerAlgorithm(Int_t rowmin, Int_t rowmax, UInt_t bitmask, Int_t patchSize, Int_t subregionSize)
+{
+  fRowMin.push_back(rowmin);
+  fRowMax.push_back(rowmax);
+  fBitMask.push_back(bitmask);
+  fPatchSize.push_back(patchSize);
+  fSubregionSize.push_back(subregionSize);
+}
+
+void AliEmcalTriggerIntegralPatchFinder::ClearTriggerAlgorithms()
+{
+  fRowMin.clear();
+  fRowMax.clear();
+  fBitMask.clear();
+  fPatchSize.clear();
+  fSubregionSize.clear();
+}
+
+void AliEmcalTriggerIntegralPatchFinder::FindPatches(const AliEMCALTriggerDataGrid<double> &adc, const AliEMCALTriggerDataGrid<double> &offlineAdc, std::vector<AliEMCALTriggerRawPatch> &patches)
+{
+  patches.clear();
+  if (fPatchSize.empty()) return;
+  fADCImage.Build(adc);
+  fOfflineADCImage.Build(offlineAdc);
+
+  // The trigger algorithm sums both grids inside the same bounds check, which
+  // fails on the ADC grid first: the offline sum is restricted to the FastORs
+  // existing in both grids.
+  const Int_t nrowsOffline = std::min(fADCImage.fNRows, fOfflineADCImage.fNRows),
+              ncolsOffline = std::min(fADCImage.fNCols, fOfflineADCImage.fNCols);
+
+  for (size_t ialgo = 0; ialgo < fPatchSize.size(); ialgo++) {
+    const Int_t patchSize = fPatchSize[ialgo], subregionSize = fSubregionSize[ialgo];
+    const Int_t rowStartMax = fRowMax[ialgo] - (patchSize - 1), colStartMax = fADCImage.fNCols - patchSize;
+    for (Int_t irow = fRowMin[ialgo]; irow <= rowStartMax; irow += subregionSize) {
+      // FastORs outside the grid are skipped by the trigger algorithm
+      const Int_t rowmin = std::max(irow, 0),
+                  rowmax = std::min(irow + patchSize, fADCImage.fNRows),
+                  rowmaxOffline = std::min(irow + patchSize, nrowsOffline);
+      for (Int_t icol = 0; icol <= colStartMax; icol += subregionSize) {
+        const Int_t colmax = icol + patchSize, colmaxOffline = std::min(colmax, ncolsOffline);
+        // Patches without any non-zero FastOR have both sums 0 and are below threshold
+        const Bool_t hasADC = fADCImage.CountNonZero(icol, colmax, rowmin, rowmax) > 0,
+                     hasOfflineADC = fOfflineADCImage.CountNonZero(icol, colmaxOffline, rowmin, rowmaxOffline) > 0;
+        if (!hasADC && !hasOfflineADC) continue;
+        Double_t sumadc = hasADC ? fADCImage.Sum(icol, colmax, rowmin, rowmax) : 0.,
+                 sumofflineAdc = hasOfflineADC ? fOfflineADCImage.Sum(icol, colmaxOffline, rowmin, rowmaxOffline) : 0.;
+        if (sumadc > 0. || sumofflineAdc > 0.) {
+          AliEMCALTriggerRawPatch recpatch(icol, irow, patchSize, sumadc, sumofflineAdc);
+          recpatch.SetBitmask(fBitMask[ialgo]);
+          patches.push_back(recpatch);
+        }
+      }
+    }
+  }
+}
+
+void AliEmcalTriggerIntegralPatchFinder::GridImage::Build(const AliEMCALTriggerDataGrid<double> &grid)
+{
+  fNCols = grid.GetNumberOfCols();
+  fNRows = grid.GetNumberOfRows();
+  const Int_t stride = fNCols + 1;
+  // Buffers keep their capacity from event to event
+  fIntegral.assign(stride * (fNRows + 1), 0);
+  fNonZero.assign(stride * (fNRows + 1), 0);
+  fRowStart.resize(fNRows + 1);
+  fCol.clear();
+  fValue.clear();
+  fIsInteger = kTRUE;
+
+  Double_t sumabs = 0.;
+  fRowStart[0] = 0;
+  for (Int_t irow = 0; irow < fNRows; irow++) {
+    const Long64_t *integralBelow = &fIntegral[irow * stride];
+    const Int_t *nonZeroBelow = &fNonZero[irow * stride];
+    Long64_t *integral = &fIntegral[(irow + 1) * stride];
+    Int_t *nonZero = &fNonZero[(irow + 1) * stride];
+    Long64_t rowsum = 0;
+    Int_t rowcount = 0;
+    for (Int_t icol = 0; icol < fNCols; icol++) {
+      const Double_t value = grid(icol, irow);
+      if (value != 0.) {
+        fCol.push_back(icol);
+        fValue.push_back(value);
+        rowcount++;
+        sumabs += std::fabs(value);
+        if (fIsInteger && !(std::fabs(value) < kMaxExactSum && value == std::floor(value))) fIsInteger = kFALSE;
+        if (fIsInteger) rowsum += static_cast<Long64_t>(value);
+      }
+      integral[icol + 1] = integralBelow[icol + 1] + rowsum;
+      nonZero[icol + 1] = nonZeroBelow[icol + 1] + rowcount;
+    }
+    fRowStart[irow + 1] = fCol.size();
+  }
+  // All partial sums of a patch are bounded by the sum of the absolute values
+  if (!(sumabs < kMaxExactSum)) fIsInteger = kFALSE;
+}
+
+Int_t AliEmcalTriggerIntegralPatchFinder::GridImage::CountNonZero(Int_t colmin, Int_t colmax, Int_t rowmin, Int_t rowmax) const
+{
+  if (colmin >= colmax || rowmin >= rowmax) return 0;
+  const Int_t stride = fNCols + 1;
+  return fNonZero[rowmax * stride + colmax] - fNonZero[rowmin * stride + colmax]
+      - fNonZero[rowmax * stride + colmin] + fNonZero[rowmin * stride + colmin];
+}
+
+Double_t AliEmcalTriggerIntegralPatchFinder::GridImage::Sum(Int_t colmin, Int_t colmax, Int_t rowmin, Int_t rowmax) const
+{
+  if (colmin >= colmax || rowmin >= rowmax) return 0.;
+  if (fIsInteger) {
+    const Int_t stride = fNCols + 1;
+    return static_cast<Double_t>(fIntegral[rowmax * stride + colmax] - fIntegral[rowmin * stride + colmax]
+        - fIntegral[rowmax * stride + colmin] + fIntegral[rowmin * stride + colmin]);
+  }
+  // Same summation order as the trigger algorithm (row by row), zeros skipped
+  Double_t sum = 0.;
+  for (Int_t irow = rowmin; irow < rowmax; irow++) {
+    for (Int_t ientry = fRowStart[irow]; ientry < fRowStart[irow + 1]; ientry++) {
+      if (fCol[ientry] < colmin) continue;
+      if (fCol[ientry] >= colmax) break;
+      sum += fValue[ientry];
+    }
+  }
+  return sum;
+}
@@ -0,0 +1,118 @@
+#ifndef ALIEMCALTRIGGERINTEGRALPATCHFINDER_H
+#define ALIEMCALTRIGGERINTEGRALPATCHFINDER_H
+/* Copyright(c) 1998-2015, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+#include <vector>
+
+#include <TObject.h>
+
+class AliEMCALTriggerRawPatch;
+template<class T> class AliEMCALTriggerDataGrid;
+
+/**
+ * @class AliEmcalTriggerIntegralPatchFinder
+ * @brief Sliding-window patch finder based on integral images of the FastOR data grids
+ * @ingroup EMCALTRGFW
+ *
+ * Finds the same trigger patches, in the same order and with the same ADC sums,
+ * as an AliEMCALTriggerPatchFinder running a list of AliEMCALTriggerAlgorithm
+ * with the same settings (and thresholds 0, as used in the trigger maker kernel).
+ * Instead of summing the FastORs of each patch candidate, each data grid is
+ * converted once per event into
+ * - a summed-area table (integral image) of the number of non-zero FastORs, used
+ *   to reject empty patch candidates in constant time,
+ * - a summed-area table of the FastOR values, used to obtain the patch sum
+ *   in constant time when all FastOR values are integers (ADC counts),
+ * - a compact list of the non-zero FastORs in each row, used to sum the FastOR
+ *   values in the same order as the trigger algorithm when the values are not
+ *   integers (offline ADC from cell energies).
+ * All patch sizes and trigger algorithms share the same tables. The sums are
+ * exactly the ones of the row-by-row summation of the trigger algorithm: integer
+ * sums are exact in double precision and skipping zero values does not change a
+ * sum started at zero.
+ */
+class AliEmcalTriggerIntegralPatchFinder : public TObject {
+public:
+
+  /**
+   * @brief Constructor
+   */
+  AliEmcalTriggerIntegralPatchFinder();
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~AliEmcalTriggerIntegralPatchFinder() {}
+
+  /**
+   * @brief Add a trigger algorithm
+   * @param[in] rowmin Minimum row value
+   * @param[in] rowmax Maximum row value
+   * @param[in] bitmask Offline bit mask to be applied to the patches
+   * @param[in] patchSize Size of the patches
+   * @param[in] subregionSize Size of the sliding sub region
+   */
+  void AddTriggerAlgorithm(Int_t rowmin, Int_t rowmax, UInt_t bitmask, Int_t patchSize, Int_t subregionSize);
+
+  /**
+   * @brief Remove all trigger algorithms
+   */
+  void ClearTriggerAlgorithms();
+
+  /**
+   * @brief Get the number of trigger algorithms
+   * @return Number of trigger algorithms
+   */
+  Int_t GetNumberOfTriggerAlgorithms() const { return fPatchSize.size(); }
+
+  /**
+   * @brief Find the patches of all trigger algorithms
+   *
+   * The patches are appended algorithm by algorithm to the output container,
+   * which is cleared first.
+   * @param[in] adc Data grid with the (online) ADC values
+   * @param[in] offlineAdc Data grid with the offline ADC values
+   * @param[out] patches Patches found by the trigger algorithms
+   */
+  void FindPatches(const AliEMCALTriggerDataGrid<double> &adc, const AliEMCALTriggerDataGrid<double> &offlineAdc, std::vector<AliEMCALTriggerRawPatch> &patches);
+
+private:
+
+  /**
+   * @class GridImage
+   * @brief Summed-area tables and non-zero FastORs of one data grid
+   */
+  class GridImage {
+  public:
+    GridImage(): fNCols(0), fNRows(0), fIsInteger(kTRUE), fIntegral(), fNonZero(), fRowStart(), fCol(), fValue() {}
+
+    void Build(const AliEMCALTriggerDataGrid<double> &grid);
+    Int_t CountNonZero(Int_t colmin, Int_t colmax, Int_t rowmin, Int_t rowmax) const;
+    Double_t Sum(Int_t colmin, Int_t colmax, Int_t rowmin, Int_t rowmax) const;
+
+    Int_t                    fNCols;      ///< Number of columns of the grid
+    Int_t                    fNRows;      ///< Number of rows of the grid
+    Bool_t                   fIsInteger;  ///< All values are integers and their sums are exact in double precision
+    std::vector<Long64_t>    fIntegral;   ///< Summed-area table of the values (only if fIsInteger)
+    std::vector<Int_t>       fNonZero;    ///< Summed-area table of the number of non-zero values
+    std::vector<Int_t>       fRowStart;   ///< Index of the first non-zero value of each row in fCol and fValue
+    std::vector<Int_t>       fCol;        ///< Columns of the non-zero values, row by row
+    std::vector<Double_t>    fValue;      ///< Non-zero values, row by row
+  };
+
+  std::vector<Int_t>         fRowMin;             ///< Minimum row of each trigger algorithm
+  std::vector<Int_t>         fRowMax;             ///< Maximum row of each trigger algorithm
+  std::vector<UInt_t>        fBitMask;            ///< Bit mask of each trigger algorithm
+  std::vector<Int_t>         fPatchSize;          ///< Patch size of each trigger algorithm
+  std::vector<Int_t>         fSubregionSize;      ///< Size of the sliding sub region of each trigger algorithm
+
+  GridImage                  fADCImage;           //!<! Tables of the ADC grid
+  GridImage                  fOfflineADCImage;    //!<! Tables of the offline ADC grid
+
+  /// \cond CLASSIMP
+  ClassDef(AliEmcalTriggerIntegralPatchFinder, 1);
+  /// \endcond
+};
+
+#endif
@@ -21,6 +21,7 @@
 #include <TF1.h>
 #include <TObjArray.h>
 #include <TRandom.h>
+#include <TStopwatch.h>
 
 #include "AliAODCaloTrigger.h"
 #include "AliEMCALGeometry.h"
@@ -50,6 +51,10 @@ AliEmcalTriggerMakerKernel::AliEmcalTriggerMakerKernel():
   fTriggerBitConfig(nullptr),
   fPatchFinder(nullptr),
   fLevel0PatchFinder(nullptr),
+  fIntegralPatchFinder(),
+  fIntegralLevel0PatchFinder(),
+  fUseIntegralPatchFinder(kTRUE),
+  fBenchmarkPatchFinder(kFALSE),
   fL0MinTime(7),
   fL0MaxTime(10),
   fApplyL0TimeCut(true),
@@ -83,13 +88,15 @@ AliEmcalTriggerMakerKernel::AliEmcalTriggerMakerKernel():
   fPatchEnergySimpleSmeared(nullptr),
   fLevel0TimeMap(nullptr),
   fTriggerBitMap(nullptr),
-  fADCtoGeV(1.)
+  fADCtoGeV(1.),
+  fPatchFinderMismatch(kFALSE)
 {
   memset(fThresholdConstants, 0, sizeof(Int_t) * 12);
   memset(fL1ThresholdsOffline, 0, sizeof(ULong64_t) * 4);
   fCellTimeLimits[0] = -10000.;
   fCellTimeLimits[1] = 10000.;
   memset(fRhoValues, 0, sizeof(Double_t) * kNIndRho);
+  memset(fPatchFinderTime, 0, sizeof(Double_t) * 2);
 }
 
 AliEmcalTriggerMakerKernel::~AliEmcalTriggerMakerKernel() {
@@ -140,6 +147,7 @@ void AliEmcalTriggerMakerKernel::AddL1TriggerAlgorithm(Int_t rowmin, Int_t rowma
   trigger->SetPatchSize(patchSize);
   trigger->SetSubregionSize(subregionSize);
   fPatchFinder->AddTriggerAlgorithm(trigger);
+  fIntegralPatchFinder.AddTriggerAlgorithm(rowmin, rowmax, bitmask, patchSize, subregionSize);
 }
 
 void AliEmcalTriggerMakerKernel::SetL0TriggerAlgorithm(Int_t rowmin, Int_t rowmax, UInt_t bitmask, Int_t patchSize, Int_t subregionSize)
@@ -148,6 +156,8 @@ void AliEmcalTriggerMakerKernel::SetL0TriggerAlgorithm(Int_t rowmin, Int_t rowma
   fLevel0PatchFinder = new AliEMCALTriggerAlgorithm<double>(rowmin, rowmax, bitmask);
   fLevel0PatchFinder->SetPatchSize(patchSize);
   fLevel0PatchFinder->SetSubregionSize(subregionSize);
+  fIntegralLevel0PatchFinder.ClearTriggerAlgorithms();
+  fIntegralLevel0PatchFinder.AddTriggerAlgorithm(rowmin, rowmax, bitmask, patchSize, subregionSize);
 }
 
 void AliEmcalTriggerMakerKernel::ConfigureForPbPb2015()
@@ -158,6 +168,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPbPb2015()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fIntegralPatchFinder.ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 103, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -176,6 +187,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP2015()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fIntegralPatchFinder.ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 103, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -193,6 +205,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP20158x8()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fIntegralPatchFinder.ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 103, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -210,6 +223,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPPb2013()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fIntegralPatchFinder.ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -225,6 +239,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP2012()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fIntegralPatchFinder.ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit(), 2, 1);
@@ -240,6 +255,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPbPb2011()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fIntegralPatchFinder.ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit(), 2, 1);
@@ -255,6 +271,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP2011()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fIntegralPatchFinder.ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   fConfigured = true;
@@ -557,15 +574,8 @@ void AliEmcalTriggerMakerKernel::CreateTriggerPatches(const AliVEvent *inputeven
   bkgPatchMask = 1 << fTriggerBitConfig->GetBkgBit();
       //l0PatchMask = 1 << fTriggerBitConfig->GetLevel0Bit();
 
-  std::vector<AliEMCALTriggerRawPatch> patches;
-  if (fPatchFinder) {
-    if (useL0amp) {
-      patches = fPatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
-    }
-    else {
-      patches = fPatchFinder->FindPatches(*fPatchADC, *fPatchADCSimple);
-    }
-  }
+  std::vector<AliEMCALTriggerRawPatch> patches, l0patches;
+  FindRawPatches(useL0amp, patches, l0patches);
   outputcont.clear();
   for(std::vector<AliEMCALTriggerRawPatch>::iterator patchit = patches.begin(); patchit != patches.end(); ++patchit){
     // Apply offline and recalc selection
@@ -618,9 +628,7 @@ void AliEmcalTriggerMakerKernel::CreateTriggerPatches(const AliVEvent *inputeven
     outputcont.push_back(fullpatch);
   }
 
-  // Find Level0 patches
-  std::vector<AliEMCALTriggerRawPatch> l0patches;
-  if (fLevel0PatchFinder) l0patches = fLevel0PatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
+  // Level0 patches
   for(std::vector<AliEMCALTriggerRawPatch>::iterator patchit = l0patches.begin(); patchit != l0patches.end(); ++patchit){
     Int_t offlinebits = 0, onlinebits = 0;
     if(HasPHOSOverlap(*patchit)) continue;
@@ -650,6 +658,58 @@ void AliEmcalTriggerMakerKernel::CreateTriggerPatches(const AliVEvent *inputeven
   // std::cout << "Finished finding trigger patches" << std::endl;
 }
 
+void AliEmcalTriggerMakerKernel::FindRawPatches(Bool_t useL0amp, std::vector<AliEMCALTriggerRawPatch> &l1patches, std::vector<AliEMCALTriggerRawPatch> &l0patches){
+  const AliEMCALTriggerDataGrid<double> &l1grid = useL0amp ? *fPatchAmplitudes : *fPatchADC;
+  // Kernels configured before the integral-image patch finder existed only have the AliRoot algorithms
+  Bool_t hasIntegralL1 = fIntegralPatchFinder.GetNumberOfTriggerAlgorithms() > 0,
+         hasIntegralL0 = fIntegralLevel0PatchFinder.GetNumberOfTriggerAlgorithms() > 0;
+  l1patches.clear();
+  l0patches.clear();
+
+  if(!fBenchmarkPatchFinder){
+    if(fUseIntegralPatchFinder && hasIntegralL1) fIntegralPatchFinder.FindPatches(l1grid, *fPatchADCSimple, l1patches);
+    else if(fPatchFinder) l1patches = fPatchFinder->FindPatches(l1grid, *fPatchADCSimple);
+    if(fUseIntegralPatchFinder && hasIntegralL0) fIntegralLevel0PatchFinder.FindPatches(*fPatchAmplitudes, *fPatchADCSimple, l0patches);
+    else if(fLevel0PatchFinder) l0patches = fLevel0PatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
+    return;
+  }
+
+  // Benchmark mode: run both patch finders and compare the patches
+  std::vector<AliEMCALTriggerRawPatch> referencel1, referencel0;
+  TStopwatch timer;
+  timer.Start();
+  if(fPatchFinder) referencel1 = fPatchFinder->FindPatches(l1grid, *fPatchADCSimple);
+  if(fLevel0PatchFinder) referencel0 = fLevel0PatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
+  fPatchFinderTime[0] = timer.RealTime();
+  timer.Start();
+  fIntegralPatchFinder.FindPatches(l1grid, *fPatchADCSimple, l1patches);
+  fIntegralLevel0PatchFinder.FindPatches(*fPatchAmplitudes, *fPatchADCSimple, l0patches);
+  fPatchFinderTime[1] = timer.RealTime();
+
+  fPatchFinderMismatch = kFALSE;
+  const std::vector<AliEMCALTriggerRawPatch> *found[2] = {&l1patches, &l0patches}, *reference[2] = {&referencel1, &referencel0};
+  Bool_t compare[2] = {hasIntegralL1, hasIntegralL0};
+  for(int itype = 0; itype < 2; itype++){
+    if(!compare[itype]) continue;
+    if(found[itype]->size() != reference[itype]->size()){
+      fPatchFinderMismatch = kTRUE;
+      continue;
+    }
+    for(size_t ipatch = 0; ipatch < found[itype]->size(); ipatch++){
+      const AliEMCALTriggerRawPatch &test = (*found[itype])[ipatch], &ref = (*reference[itype])[ipatch];
+      if(test.GetColStart() != ref.GetColStart() || test.GetRowStart() != ref.GetRowStart() || test.GetPatchSize() != ref.GetPatchSize()
+          || test.GetBitmask() != ref.GetBitmask() || test.GetADC() != ref.GetADC() || test.GetOfflineADC() != ref.GetOfflineADC()){
+        fPatchFinderMismatch = kTRUE;
+        break;
+      }
+    }
+  }
+  if(fPatchFinderMismatch) AliErrorStream() << "Patches of the integral-image patch finder differ from the AliRoot trigger algorithms" << std::endl;
+
+  if(!fUseIntegralPatchFinder || !hasIntegralL1) l1patches.swap(referencel1);
+  if(!fUseIntegralPatchFinder || !hasIntegralL0) l0patches.swap(referencel0);
+}
+
 double AliEmcalTriggerMakerKernel::GetL0TriggerChannelAmplitude(Int_t col, Int_t row) const{
   double amp = 0;
   try {
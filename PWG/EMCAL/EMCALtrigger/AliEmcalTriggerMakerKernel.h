@@ -9,6 +9,7 @@
 
 #include <TObject.h>
 #include <TArrayF.h>
+#include "AliEmcalTriggerIntegralPatchFinder.h"
 //#include <AliEMCALTriggerPatchInfoV1.h>
 
 class TF1;
@@ -396,6 +397,46 @@ public:
    */
   void SetL0TriggerAlgorithm(Int_t rowmin, Int_t rowmax, UInt_t bitmask, Int_t patchSize, Int_t subregionSize);
 
+  /**
+   * @brief Switch between the integral-image patch finder and the AliRoot trigger algorithms
+   *
+   * Both find the same patches with the same ADC sums, the integral-image
+   * patch finder (AliEmcalTriggerIntegralPatchFinder) avoids the summation
+   * of the FastORs of each patch candidate.
+   * @param[in] doUse If true the integral-image patch finder is used (default)
+   */
+  void SetUseIntegralPatchFinder(Bool_t doUse) { fUseIntegralPatchFinder = doUse; }
+
+  /**
+   * @brief Benchmark mode of the patch finders
+   *
+   * In benchmark mode both patch finders run in each event. The patches of the
+   * patch finder selected with SetUseIntegralPatchFinder are used, the time
+   * spent in each patch finder and whether the patches differ can be obtained
+   * with GetPatchFinderTime and IsPatchFinderMismatch.
+   * @param[in] doBenchmark If true both patch finders run in each event
+   */
+  void SetBenchmarkPatchFinder(Bool_t doBenchmark) { fBenchmarkPatchFinder = doBenchmark; }
+
+  /**
+   * @brief Check whether the benchmark mode of the patch finders is enabled
+   * @return True if both patch finders run in each event
+   */
+  Bool_t IsBenchmarkPatchFinder() const { return fBenchmarkPatchFinder; }
+
+  /**
+   * @brief Get the time spent in the patch finder in the last event (benchmark mode)
+   * @param[in] integral If true the time of the integral-image patch finder, otherwise of the AliRoot trigger algorithms
+   * @return Real time in seconds
+   */
+  Double_t GetPatchFinderTime(Bool_t integral) const { return fPatchFinderTime[integral ? 1 : 0]; }
+
+  /**
+   * @brief Check whether the two patch finders found different patches in the last event (benchmark mode)
+   * @return True if the patches differ
+   */
+  Bool_t IsPatchFinderMismatch() const { return fPatchFinderMismatch; }
+
   /**
    * @brief Specify constant noise to be added to FastOR signal generated from smeared FEE data
    * @param noise Constant noise term (pedestal) in GeV
@@ -514,6 +555,17 @@ protected:
    */
   ELevel0TriggerStatus_t CheckForL0(Int_t col, Int_t row) const;
 
+  /**
+   * @brief Run the L1 and Level0 patch finders on the data grids
+   *
+   * Uses the integral-image patch finder if enabled and configured, otherwise
+   * the AliRoot trigger algorithms. In benchmark mode both are run and compared.
+   * @param[in] useL0amp If true L0 amplitudes are used instead of L1 ADC counts for the L1 patches
+   * @param[out] l1patches L1 (gamma, jet and background) patches
+   * @param[out] l0patches Level0 patch candidates
+   */
+  void FindRawPatches(Bool_t useL0amp, std::vector<AliEMCALTriggerRawPatch> &l1patches, std::vector<AliEMCALTriggerRawPatch> &l0patches);
+
   /**
    * @brief Check from the bitmask whether the patch is a gamma patch
    * @param[in] patch Patch to check
@@ -549,6 +601,10 @@ protected:
 
   AliEMCALTriggerPatchFinder<double>       *fPatchFinder;                 ///< The actual patch finder
   AliEMCALTriggerAlgorithm<double>         *fLevel0PatchFinder;           ///< Patch finder for Level0 patches
+  AliEmcalTriggerIntegralPatchFinder        fIntegralPatchFinder;         ///< Integral-image patch finder with the L1 trigger algorithms
+  AliEmcalTriggerIntegralPatchFinder        fIntegralLevel0PatchFinder;   ///< Integral-image patch finder with the Level0 trigger algorithm
+  Bool_t                                    fUseIntegralPatchFinder;      ///< Use the integral-image patch finders instead of the AliRoot trigger algorithms
+  Bool_t                                    fBenchmarkPatchFinder;        ///< Run and compare both patch finders in each event
   Int_t                                     fL0MinTime;                   ///< Minimum L0 time
   Int_t                                     fL0MaxTime;                   ///< Maximum L0 time
   Bool_t                                    fApplyL0TimeCut;              ///< Apply time cut (L0 time between fL0MinTime and fL0MaxTime) for L0 patch selection
@@ -589,9 +645,11 @@ protected:
   Double_t                                  fRhoValues[kNIndRho];         //!<! Rho values for background subtraction (only online ADC)
 
   Double_t                                  fADCtoGeV;                    //!<! Conversion factor from ADC to GeV
+  Double_t                                  fPatchFinderTime[2];          //!<! Time spent in the AliRoot [0] and integral-image [1] patch finders (benchmark mode)
+  Bool_t                                    fPatchFinderMismatch;         //!<! Patches of the two patch finders differ (benchmark mode)
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalTriggerMakerKernel, 4);
+  ClassDef(AliEmcalTriggerMakerKernel, 5);
   /// \endcond
 };
 
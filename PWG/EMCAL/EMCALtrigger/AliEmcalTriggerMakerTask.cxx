@@ -157,6 +157,13 @@ void AliEmcalTriggerMakerTask::UserCreateOutputObjects(){
       fQAHistos->CreateTH2("FastORDiffEnergyEsmear", "FastOR smeared energy - cell energy", 4994, -0.5, 4993.5, 200, -10., 10);
       fQAHistos->CreateTH2("FastORDiffEsmearADCrough", "FastOR ADC rough - smeared energy", 4994, -0.5, 4993.5, 200, -10., 10);
 
+      // Benchmark of the patch finders
+      if(fTriggerMaker->IsBenchmarkPatchFinder()){
+        fQAHistos->CreateTH1("PatchFinderTimeAliRoot", "Time spent in the AliRoot trigger algorithms; time (#mus); events", 1000, 0., 10000.);
+        fQAHistos->CreateTH1("PatchFinderTimeIntegral", "Time spent in the integral-image patch finder; time (#mus); events", 1000, 0., 10000.);
+        fQAHistos->CreateTH1("PatchFinderMismatch", "Events with identical (0) and different (1) patches; mismatch; events", 2, -0.5, 1.5);
+      }
+
       for(auto h : *(fQAHistos->GetListOfHistograms())) fOutput->Add(h);
       fQAHistos->GetListOfHistograms()->SetOwner(false);
       PostData(1, fOutput);
@@ -302,6 +309,11 @@ Bool_t AliEmcalTriggerMakerTask::Run(){
 
   std::vector<AliEMCALTriggerPatchInfo> patches;
   fTriggerMaker->CreateTriggerPatches(InputEvent(), patches, fUseL0Amplitudes);
+  if(fDoQA && fTriggerMaker->IsBenchmarkPatchFinder()){
+    fQAHistos->FillTH1("PatchFinderTimeAliRoot", fTriggerMaker->GetPatchFinderTime(kFALSE) * 1e6);
+    fQAHistos->FillTH1("PatchFinderTimeIntegral", fTriggerMaker->GetPatchFinderTime(kTRUE) * 1e6);
+    fQAHistos->FillTH1("PatchFinderMismatch", fTriggerMaker->IsPatchFinderMismatch() ? 1 : 0);
+  }
   Int_t patchcounter = 0;
   TString triggerstring;
   AliDebugStream(2) << GetName() << ": Found " << patches.size() << " patches" << std::endl;
@@ -194,6 +194,26 @@ public:
     if(fTriggerMaker) fTriggerMaker->SetTriggerThresholdGammaHigh(a, b, c);
   }
 
+  /**
+   * @brief Switch between the integral-image patch finder and the AliRoot trigger algorithms
+   * @param[in] doUse If true the integral-image patch finder is used (default)
+   */
+  void SetUseIntegralPatchFinder(Bool_t doUse) {
+    if(fTriggerMaker) fTriggerMaker->SetUseIntegralPatchFinder(doUse);
+  }
+
+  /**
+   * @brief Run and compare both patch finders in each event
+   *
+   * With QA enabled the time spent in each patch finder and the number of
+   * events with different patches are monitored in histograms (see
+   * PWG/EMCAL/macros/benchmarkTriggerPatchFinder.C)
+   * @param[in] doBenchmark If true both patch finders run in each event
+   */
+  void SetBenchmarkPatchFinder(Bool_t doBenchmark = kTRUE) {
+    if(fTriggerMaker) fTriggerMaker->SetBenchmarkPatchFinder(doBenchmark);
+  }
+
   /**
    * @brief Getter providing external access to the trigger maker kernel.
    *
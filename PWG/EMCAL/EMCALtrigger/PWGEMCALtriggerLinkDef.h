@@ -5,6 +5,7 @@
 #pragma link off all functions;
 
 #pragma link C++ class AliEmcalTriggerMaker+;
+#pragma link C++ class AliEmcalTriggerIntegralPatchFinder+;
 #pragma link C++ class AliEmcalTriggerMakerKernel+;
 #pragma link C++ class AliEmcalTriggerMakerTask+;
 #pragma link C++ class AliEmcalTriggerSetupInfo+;
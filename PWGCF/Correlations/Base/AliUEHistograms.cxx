@@ -565,6 +565,34 @@ void AliUEHistograms::Fill(AliVParticle* leadingMC, AliVParticle* leadingReco)
   }
 }
 
+//____________________________________________________________________
+void AliUEHistograms::FillParticleArrays(Int_t index, TObjArray* particles)
+{
+  // copies the properties of the particles needed in FillCorrelations into contiguous arrays
+  // the containers keep their capacity, so that no allocation takes place after the first events
+  
+  const Int_t n = particles->GetEntriesFast();
+  fArrayParticle[index].resize(n);
+  fArrayBasic[index].assign(n, 0);
+  fArrayPt[index].resize(n);
+  fArrayEta[index].resize(n);
+  fArrayPhi[index].resize(n);
+  fArrayCharge[index].resize(n);
+  fArrayFlag[index].assign(n, 0);
+  
+  for (Int_t i=0; i<n; i++)
+  {
+    AliVParticle* particle = (AliVParticle*) particles->UncheckedAt(i);
+    fArrayParticle[index][i] = particle;
+    fArrayPt[index][i] = particle->Pt();
+    fArrayEta[index][i] = particle->Eta();
+    fArrayPhi[index][i] = particle->Phi();
+    fArrayCharge[index][i] = particle->Charge();
+    if (fCheckEventNumberInCorrelation)
+      fArrayBasic[index][i] = dynamic_cast<AliBasicParticle*>(particle);
+  }
+}
+
 //____________________________________________________________________
 void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, TObjArray* particles, TObjArray* mixed, Float_t weight, Bool_t firstTime, Bool_t twoTrackEfficiencyCut, Float_t bSign, Float_t twoTrackEfficiencyCutValue, Bool_t applyEfficiency)
 {
@@ -591,11 +619,19 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
     TH1::AddDirectory(oldStatus);
   }
 
-  // Eta() is extremely time consuming, therefore cache it for the inner loop here:
+  // Eta() is extremely time consuming, therefore cache it for the inner loop here.
+  // The other kinematic variables are cached as well in contiguous arrays (filled once per call),
+  // which removes all virtual calls from the pair loop. Index 1 holds the associated particles,
+  // index 0 the trigger particles in the mixed-event case (otherwise both are the same array)
   TObjArray* input = (mixed) ? mixed : particles;
-  TArrayF eta(input->GetEntriesFast());
-  for (Int_t i=0; i<input->GetEntriesFast(); i++)
-    eta[i] = ((AliVParticle*) input->UncheckedAt(i))->Eta();
+  FillParticleArrays(1, input);
+  const Int_t trig = (mixed) ? 0 : 1;
+  if (particles && mixed)
+    FillParticleArrays(0, particles);
+  const Float_t* eta = fArrayEta[1].data();
+  const Double_t* pt = fArrayPt[1].data();
+  const Double_t* phi = fArrayPhi[1].data();
+  const Short_t* charge = fArrayCharge[1].data();
   
   // if particles is not set, just fill event statistics
   if (particles)
@@ -604,6 +640,11 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
     if (mixed)
       jMax = mixed->GetEntriesFast();
     
+    const Float_t* triggerEtaArray = fArrayEta[trig].data();
+    const Double_t* triggerPtArray = fArrayPt[trig].data();
+    const Double_t* triggerPhiArray = fArrayPhi[trig].data();
+    const Short_t* triggerChargeArray = fArrayCharge[trig].data();
+    
     TH1* triggerWeighting = 0;
     if (fWeightPerEvent)
     {
@@ -612,10 +653,8 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
     
       for (Int_t i=0; i<particles->GetEntriesFast(); i++)
       {
-	AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
-	
 	// some optimization
-	Float_t triggerEta = triggerParticle->Eta();
+	Float_t triggerEta = triggerEtaArray[i];
 
 	if (fTriggerRestrictEta > 0 && TMath::Abs(triggerEta) > fTriggerRestrictEta)
 	  continue;
@@ -627,10 +666,10 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 	
 	if (fTriggerSelectCharge != 0)
-	  if (triggerParticle->Charge() * fTriggerSelectCharge < 0)
+	  if (triggerChargeArray[i] * fTriggerSelectCharge < 0)
 	    continue;
 	
-	triggerWeighting->Fill(triggerParticle->Pt());
+	triggerWeighting->Fill(triggerPtArray[i]);
       }
     }
     
@@ -660,24 +699,20 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       
       for (Int_t i=0; i<particles->GetEntriesFast(); i++)
       {
-	AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
+	AliVParticle* triggerParticle = fArrayParticle[trig][i];
 	
 	for (Int_t j=0; j<jMax; j++)
 	{
 	  if (!mixed && i == j)
 	    continue;
 	
-	  AliVParticle* particle = 0;
-	  if (!mixed)
-	    particle = (AliVParticle*) particles->UncheckedAt(j);
-	  else
-	    particle = (AliVParticle*) mixed->UncheckedAt(j);
+	  AliVParticle* particle = fArrayParticle[1][j];
 	  
 	  // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
 	  if (fCheckEventNumberInCorrelation)
 	  {
-	    AliBasicParticle* triggerParticleBasic = dynamic_cast<AliBasicParticle*>(triggerParticle);
-	    AliBasicParticle* particleBasic        = dynamic_cast<AliBasicParticle*>(particle);
+	    AliBasicParticle* triggerParticleBasic = fArrayBasic[trig][i];
+	    AliBasicParticle* particleBasic        = fArrayBasic[1][j];
 	    if(!triggerParticleBasic || !particleBasic)
 	    {
 	      AliFatal("If fCheckEventNumberInCorrelation is set, particle must be derived from AliBasicParticle");
@@ -690,14 +725,14 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  else if (mixed && triggerParticle->IsEqual(particle))
 	    continue;
 	  
-	  if (triggerParticle->Charge() * particle->Charge() > 0)
+	  if (triggerChargeArray[i] * charge[j] > 0)
 	    continue;
       
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerParticle->Eta(), triggerParticle->Phi(), particle->Pt(), particle->Eta(), particle->Phi(), massDaughter1, massDaughter2);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPtArray[i], triggerEtaArray[i], triggerPhiArray[i], pt[j], eta[j], phi[j], massDaughter1, massDaughter2);
 	      
 	  if (TMath::Abs(mass - resonanceMass*resonanceMass) < interval*5)
 	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerParticle->Eta(), triggerParticle->Phi(), particle->Pt(), particle->Eta(), particle->Phi(), massDaughter1, massDaughter2);
+	    mass = GetInvMassSquared(triggerPtArray[i], triggerEtaArray[i], triggerPhiArray[i], pt[j], eta[j], phi[j], massDaughter1, massDaughter2);
 
 	    if (mass > (resonanceMass-interval)*(resonanceMass-interval) && mass < (resonanceMass+interval)*(resonanceMass+interval))
 	    {
@@ -709,14 +744,36 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  }
 	}
       }
+      
+      // the bits are copied into the arrays (they can be shared between the trigger and associated objects)
+      for (Int_t k=trig; k<2; k++)
+	for (UInt_t i=0; i<fArrayParticle[k].size(); i++)
+	  fArrayFlag[k][i] = fArrayParticle[k][i]->TestBit(kResonanceDaughterFlag);
     }
+    const Char_t* triggerFlagArray = fArrayFlag[trig].data();
+    const Char_t* flag = fArrayFlag[1].data();
+    
+    // the pair selections which only depend on the cached arrays are evaluated first without branches,
+    // the remaining ones (which fill control histograms) only for the accepted candidates
+    const Bool_t ptOrder = fPtOrder;
+    const Int_t associatedSelectCharge = fAssociatedSelectCharge;
+    const Int_t selectCharge = fSelectCharge;
+    const Int_t onlyOneAssocEtaSide = fOnlyOneAssocEtaSide;
+    const Bool_t etaOrdering = fEtaOrdering;
+    const Bool_t rejectResonanceDaughters = (fRejectResonanceDaughters > 0);
+    if ((Int_t) fCandidates.size() < jMax)
+      fCandidates.resize(jMax);
+    Int_t* candidates = fCandidates.data();
     
     for (Int_t i=0; i<particles->GetEntriesFast(); i++)
     {
-      AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
+      AliVParticle* triggerParticle = fArrayParticle[trig][i];
       
       // some optimization
-      Float_t triggerEta = triggerParticle->Eta();
+      Float_t triggerEta = triggerEtaArray[i];
+      const Double_t triggerPt = triggerPtArray[i];
+      const Double_t triggerPhi = triggerPhiArray[i];
+      const Short_t triggerCharge = triggerChargeArray[i];
       
       if (fTriggerRestrictEta > 0 && TMath::Abs(triggerEta) > fTriggerRestrictEta)
 	continue;
@@ -728,87 +785,61 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       }
       
       if (fTriggerSelectCharge != 0)
-	if (triggerParticle->Charge() * fTriggerSelectCharge < 0)
+	if (triggerCharge * fTriggerSelectCharge < 0)
 	  continue;
 	
       if (fRejectResonanceDaughters > 0)
-	if (triggerParticle->TestBit(kResonanceDaughterFlag))
+	if (triggerFlagArray[i])
 	{
 // 	  Printf("Skipped i=%d", i);
 	  continue;
 	}
-	
+      
+      Int_t nCandidates = 0;
       for (Int_t j=0; j<jMax; j++)
       {
-        if (!mixed && i == j)
-          continue;
-      
-        AliVParticle* particle = 0;
-        if (!mixed)
-          particle = (AliVParticle*) particles->UncheckedAt(j);
-        else
-          particle = (AliVParticle*) mixed->UncheckedAt(j);
-        
-        // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
-        if (fCheckEventNumberInCorrelation)
-        {
-          AliBasicParticle* triggerParticleBasic = dynamic_cast<AliBasicParticle*>(triggerParticle);
-          AliBasicParticle* particleBasic        = dynamic_cast<AliBasicParticle*>(particle);
-          if(!triggerParticleBasic || !particleBasic)
-            AliFatal("If fCheckEventNumberInCorrelation is set, particle must be derived from AliBasicParticle");
+	Bool_t accept = (mixed || i != j);
+	// pT,a < pT,t
+	accept &= !(ptOrder && pt[j] >= triggerPt);
+	accept &= !(associatedSelectCharge != 0 && charge[j] * associatedSelectCharge < 0);
+	// 1: skip like sign, 2: skip unlike sign
+	accept &= !(selectCharge == 1 && charge[j] * triggerCharge > 0);
+	accept &= !(selectCharge == 2 && charge[j] * triggerCharge < 0);
+	accept &= !(onlyOneAssocEtaSide != 0 && onlyOneAssocEtaSide * eta[j] < 0);
+	accept &= !(etaOrdering && ((triggerEta < 0 && eta[j] < triggerEta) || (triggerEta > 0 && eta[j] > triggerEta)));
+	accept &= !(rejectResonanceDaughters && flag[j]);
+	candidates[nCandidates] = j;
+	nCandidates += accept;
+      }
       
-          if(triggerParticleBasic->IsInSameEvent(particleBasic))
-            continue;
-        }
-        else if (mixed && triggerParticle->IsEqual(particle))
-          continue;
-        
-        if (fPtOrder)
-	  if (particle->Pt() >= triggerParticle->Pt())
-	    continue;
+      for (Int_t k=0; k<nCandidates; k++)
+      {
+	const Int_t j = candidates[k];
 	
-	if (fAssociatedSelectCharge != 0)
-	  if (particle->Charge() * fAssociatedSelectCharge < 0)
-	    continue;
-
-        if (fSelectCharge > 0)
-        {
-          // skip like sign
-          if (fSelectCharge == 1 && particle->Charge() * triggerParticle->Charge() > 0)
-            continue;
-            
-          // skip unlike sign
-          if (fSelectCharge == 2 && particle->Charge() * triggerParticle->Charge() < 0)
-            continue;
-        }
-        
-        if (fOnlyOneAssocEtaSide != 0)
-          if (fOnlyOneAssocEtaSide * eta[j] < 0)
-            continue;
-
-	if (fEtaOrdering)
+	// check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
+	if (fCheckEventNumberInCorrelation)
 	{
-	  if (triggerEta < 0 && eta[j] < triggerEta)
-	    continue;
-	  if (triggerEta > 0 && eta[j] > triggerEta)
+	  AliBasicParticle* triggerParticleBasic = fArrayBasic[trig][i];
+	  AliBasicParticle* particleBasic        = fArrayBasic[1][j];
+	  if(!triggerParticleBasic || !particleBasic)
+	    AliFatal("If fCheckEventNumberInCorrelation is set, particle must be derived from AliBasicParticle");
+      
+	  if(triggerParticleBasic->IsInSameEvent(particleBasic))
 	    continue;
 	}
-
-	if (fRejectResonanceDaughters > 0)
-	  if (particle->TestBit(kResonanceDaughterFlag))
-	  {
-// 	    Printf("Skipped j=%d", j);
-	    continue;
-	  }
+	else if (mixed && triggerParticle->IsEqual(fArrayParticle[1][j]))
+	  continue;
+	
+	const Int_t chargeProduct = charge[j] * triggerCharge;
 
 	// conversions
-	if (fCutConversionsV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutConversionsV > 0 && chargeProduct < 0)
 	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.510e-3, 0.510e-3);
 	  
 	  if (mass < fCutConversionsV * 5)
 	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.510e-3, 0.510e-3);
 	    
 	    fControlConvResoncances->Fill(0.0, mass);
 
@@ -818,15 +849,15 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 	
 	// K0s
-	if (fCutK0sV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutK0sV > 0 && chargeProduct < 0)
 	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.1396);
 	  
 	  const Float_t kK0smass = 0.4976;
 	  
 	  if (TMath::Abs(mass - kK0smass*kK0smass) < fCutK0sV * 5)
 	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.1396);
 	    
 	    fControlConvResoncances->Fill(1, mass - kK0smass*kK0smass);
 
@@ -836,16 +867,16 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 
 	// Lambda
-	if (fCutLambdaV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutLambdaV > 0 && chargeProduct < 0)
 	{
-	  Float_t mass1 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
-	  Float_t mass2 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
+	  Float_t mass1 = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.9383);
+	  Float_t mass2 = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.9383, 0.1396);
 	  
 	  const Float_t kLambdaMass = 1.115;
 
 	  if (TMath::Abs(mass1 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
 	  {
-	    mass1 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
+	    mass1 = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.9383);
 
 	    fControlConvResoncances->Fill(2, mass1 - kLambdaMass*kLambdaMass);
 	    
@@ -854,7 +885,7 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  }
 	  if (TMath::Abs(mass2 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
 	  {
-	    mass2 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
+	    mass2 = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.9383, 0.1396);
 
 	    fControlConvResoncances->Fill(2, mass2 - kLambdaMass*kLambdaMass);
 
@@ -864,15 +895,15 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 
         // Phi
-	if (fCutPhiV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutPhiV > 0 && chargeProduct < 0)
 	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.4937, 0.4937);
 	  
 	  const Float_t kPhimass = 1.019;
 	  
 	  if (TMath::Abs(mass - kPhimass*kPhimass) < fCutPhiV * 5)
 	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.4937, 0.4937);
 	    
 	    fControlConvResoncances->Fill(3, mass - kPhimass*kPhimass);
 	    
@@ -882,15 +913,15 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}	
 
         // Rho
-	if (fCutRhoV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutRhoV > 0 && chargeProduct < 0)
         {
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.1396);
 	  
 	  const Float_t kRhomass = 0.770;
 	  
 	  if (TMath::Abs(mass - kRhomass*kRhomass) < fCutRhoV * 5)
           {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.1396);
 	    
 	    fControlConvResoncances->Fill(4, mass - kRhomass*kRhomass);
 	    
@@ -900,13 +931,13 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 
         // User-defined cut
-	if (fCutCustomMass > 0 && fCutCustomFirst > 0 && fCutCustomSecond > 0 && fCutCustomV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutCustomMass > 0 && fCutCustomFirst > 0 && fCutCustomSecond > 0 && fCutCustomV > 0 && chargeProduct < 0)
         {
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], fCutCustomFirst, fCutCustomSecond);
 	  
 	  if (TMath::Abs(mass - fCutCustomMass*fCutCustomMass) < fCutCustomV * 5)
           {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], fCutCustomFirst, fCutCustomSecond);
 	    
 	    fControlConvResoncances->Fill(5, mass - fCutCustomMass*fCutCustomMass);
 	    
@@ -920,13 +951,13 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  // the variables & cuthave been developed by the HBT group 
 	  // see e.g. https://indico.cern.ch/materialDisplay.py?contribId=36&sessionId=6&materialId=slides&confId=142700
 
-	  Float_t phi1 = triggerParticle->Phi();
-	  Float_t pt1 = triggerParticle->Pt();
-	  Float_t charge1 = triggerParticle->Charge();
+	  Float_t phi1 = triggerPhi;
+	  Float_t pt1 = triggerPt;
+	  Float_t charge1 = triggerCharge;
 	    
-	  Float_t phi2 = particle->Phi();
-	  Float_t pt2 = particle->Pt();
-	  Float_t charge2 = particle->Charge();
+	  Float_t phi2 = phi[j];
+	  Float_t pt2 = pt[j];
+	  Float_t charge2 = charge[j];
 	      
 	  Float_t deta = triggerEta - eta[j];
 	      
@@ -971,10 +1002,10 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
         
         Double_t vars[6];
         vars[0] = triggerEta - eta[j];
-        vars[1] = particle->Pt();
-        vars[2] = triggerParticle->Pt();
+        vars[1] = pt[j];
+        vars[2] = triggerPt;
         vars[3] = centrality;
-        vars[4] = triggerParticle->Phi() - particle->Phi();
+        vars[4] = triggerPhi - phi[j];
         if (vars[4] > 1.5 * TMath::Pi()) 
           vars[4] -= TMath::TwoPi();
         if (vars[4] < -0.5 * TMath::Pi())
@@ -982,7 +1013,7 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	vars[5] = zVtx;
 	
 	if (fillpT)
-	  weight = particle->Pt();
+	  weight = pt[j];
 	
 	Double_t useWeight = weight;
 	if (applyEfficiency)
@@ -1029,7 +1060,7 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       {
         // once per trigger particle
         Double_t vars[3];
-        vars[0] = triggerParticle->Pt();
+        vars[0] = triggerPt;
         vars[1] = centrality;
 	vars[2] = zVtx;
 
@@ -1046,8 +1077,8 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  useWeight *= fEfficiencyCorrectionTriggers->GetBinContent(effVars);
 	}
 
-	if (TMath::Abs(triggerEta) < 0.8 && triggerParticle->Pt() > 0)
-	  fInvYield2->Fill(centrality, triggerParticle->Pt(), useWeight / triggerParticle->Pt());
+	if (TMath::Abs(triggerEta) < 0.8 && triggerPt > 0)
+	  fInvYield2->Fill(centrality, triggerPt, useWeight / triggerPt);
 
 	if (fWeightPerEvent)
 	{
@@ -1060,11 +1091,11 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
         fNumberDensityPhi->GetEventHist()->Fill(vars, step, useWeight);
 
 	// QA
-        fCorrelationpT->Fill(centrality, triggerParticle->Pt());
+        fCorrelationpT->Fill(centrality, triggerPt);
         fCorrelationEta->Fill(centrality, triggerEta);
-        fCorrelationPhi->Fill(centrality, triggerParticle->Phi());
-	fYields->Fill(centrality, triggerParticle->Pt(), triggerEta);
-	fYieldsEtaPhiPT->Fill(triggerParticle->Pt(), triggerEta, triggerParticle->Phi());
+        fCorrelationPhi->Fill(centrality, triggerPhi);
+	fYields->Fill(centrality, triggerPt, triggerEta);
+	fYieldsEtaPhiPT->Fill(triggerPt, triggerEta, triggerPhi);
 	
 /*        if (dynamic_cast<AliAODTrack*>(triggerParticle))
           fITSClusterMap->Fill(((AliAODTrack*) triggerParticle)->GetITSClusterMap(), centrality, triggerParticle->Pt());*/
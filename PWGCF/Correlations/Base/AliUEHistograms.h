@@ -12,8 +12,10 @@
 #include "AliUEHist.h"
 #include "TMath.h"
 #include "THn.h" // in cxx file causes .../THn.h:257: error: conflicting declaration ‘typedef class THnT<float> THnF’
+#include <vector>
 
 class AliVParticle;
+class AliBasicParticle;
 
 class TList;
 class TSeqCollection;
@@ -120,6 +122,7 @@ protected:
   void FillRegion(AliUEHist::Region region, Float_t zVtx, AliUEHist::CFStep step, AliVParticle* leading, TList* list, Int_t multiplicity);
   Int_t CountParticles(TList* list, Float_t ptMin);
   void DeleteContainers();
+  void FillParticleArrays(Int_t index, TObjArray* particles);
   inline Float_t GetInvMassSquared(Float_t pt1, Float_t eta1, Float_t phi1, Float_t pt2, Float_t eta2, Float_t phi2, Float_t m0_1, Float_t m0_2);
   inline Float_t GetInvMassSquaredCheap(Float_t pt1, Float_t eta1, Float_t phi1, Float_t pt2, Float_t eta2, Float_t phi2, Float_t m0_1, Float_t m0_2);
   inline Float_t GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign);
@@ -182,7 +185,17 @@ protected:
   
   Int_t fMergeCount;		// counts how many objects have been merged together
   
-  ClassDef(AliUEHistograms, 33)  // underlying event histogram container
+  // per-event copies of the particle properties used in FillCorrelations (0: trigger particles in mixed events; 1: associated particles)
+  std::vector<AliVParticle*> fArrayParticle[2];     //! particles
+  std::vector<AliBasicParticle*> fArrayBasic[2];    //! particles as AliBasicParticle (only with fCheckEventNumberInCorrelation)
+  std::vector<Double_t> fArrayPt[2];                //! pT
+  std::vector<Float_t> fArrayEta[2];                //! eta
+  std::vector<Double_t> fArrayPhi[2];               //! phi
+  std::vector<Short_t> fArrayCharge[2];             //! charge
+  std::vector<Char_t> fArrayFlag[2];                //! flagged as resonance daughter
+  std::vector<Int_t> fCandidates;                   //! associated particles passing the pair preselection
+  
+  ClassDef(AliUEHistograms, 34)  // underlying event histogram container
 };
 
 Float_t AliUEHistograms::GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign)
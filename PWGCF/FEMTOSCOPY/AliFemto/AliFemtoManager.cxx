@@ -8,6 +8,7 @@
 ///////////////////////////////////////////////////////////////////////////
 
 #include "AliFemtoManager.h"
+#include "AliFemtoPair.h"
 //#include "AliFemtoParticleCollection.h"
 //#include "AliFemtoTrackCut.h"
 //#include "AliFemtoV0Cut.h"
@@ -141,6 +142,10 @@ void AliFemtoManager::Finish()
   for (AliFemtoAnalysis *analysis : *fAnalysisCollection) {
     analysis->Finish();
   }
+
+  if (AliFemtoPair::CacheStatistics()) {
+    AliFemtoPair::PrintCacheStatistics();
+  }
 }
 //____________________________
 AliFemtoString AliFemtoManager::Report()
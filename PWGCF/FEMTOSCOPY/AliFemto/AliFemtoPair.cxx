@@ -10,17 +10,21 @@
 #include <TMath.h>
 #include "AliFemtoPair.h"
 
+#include <cstdio>
+
 double AliFemtoPair::fgMaxDuInner = .8;
 double AliFemtoPair::fgMaxDzInner = 3.;
 double AliFemtoPair::fgMaxDuOuter = 1.4;
 double AliFemtoPair::fgMaxDzOuter = 3.2;
+bool AliFemtoPair::fgCacheStatistics = false;
+unsigned long long AliFemtoPair::fgNRequested[AliFemtoPair::kNCachedQuantities] = {0};
+unsigned long long AliFemtoPair::fgNCalculated[AliFemtoPair::kNCachedQuantities] = {0};
 
 
 AliFemtoPair::AliFemtoPair():
   fTrack1(nullptr),
   fTrack2(nullptr),
   fPairAngleEP(0.0),
-  fNonIdParNotCalculated(0.0),
   fDKSide(0.0),
   fDKOut(0.0),
   fDKLong(0.0),
@@ -48,19 +52,20 @@ AliFemtoPair::AliFemtoPair():
   fClosestRowAtDCAV0PosV0Pos(0.0),
   fMergingParNotCalculatedV0NegV0Neg(0),
   fFracOfMergedRowV0NegV0Neg(0.0),
-  fClosestRowAtDCAV0NegV0Neg(0.0)
+  fClosestRowAtDCAV0NegV0Neg(0.0),
+  fCalculated(0)
 {
   // Default constructor
   SetDefaultHalfFieldMergingPar();
   std::fill_n(fAverageSeparations, 4, NAN);
   std::fill_n(fFemtoWeightCache, 3, std::make_pair(0, NAN));
+  std::fill_n(fCache, (int)kNCachedQuantities, 0.0);
 }
 
 AliFemtoPair::AliFemtoPair(AliFemtoParticle* a, AliFemtoParticle* b):
   fTrack1(a),
   fTrack2(b),
   fPairAngleEP(0.0),
-  fNonIdParNotCalculated(0.0),
   fDKSide(0.0),
   fDKOut(0.0),
   fDKLong(0.0),
@@ -88,12 +93,14 @@ AliFemtoPair::AliFemtoPair(AliFemtoParticle* a, AliFemtoParticle* b):
   fClosestRowAtDCAV0PosV0Pos(0.0),
   fMergingParNotCalculatedV0NegV0Neg(0),
   fFracOfMergedRowV0NegV0Neg(0.0),
-  fClosestRowAtDCAV0NegV0Neg(0.0)
+  fClosestRowAtDCAV0NegV0Neg(0.0),
+  fCalculated(0)
 {
   // Construct a pair from two particles
   SetDefaultHalfFieldMergingPar();
   std::fill_n(fAverageSeparations, 4, NAN);
   std::fill_n(fFemtoWeightCache, 3, std::make_pair(0, NAN));
+  std::fill_n(fCache, (int)kNCachedQuantities, 0.0);
 }
 
 void AliFemtoPair::SetDefaultHalfFieldMergingPar()
@@ -131,7 +138,6 @@ AliFemtoPair::AliFemtoPair(const AliFemtoPair &aPair):
   fTrack1(aPair.fTrack1),
   fTrack2(aPair.fTrack2),
   fPairAngleEP(aPair.fPairAngleEP),
-  fNonIdParNotCalculated(aPair.fNonIdParNotCalculated),
   fDKSide(aPair.fDKSide),
   fDKOut(aPair.fDKOut),
   fDKLong(aPair.fDKLong),
@@ -159,10 +165,11 @@ AliFemtoPair::AliFemtoPair(const AliFemtoPair &aPair):
   fClosestRowAtDCAV0PosV0Pos(aPair.fClosestRowAtDCAV0PosV0Pos),
   fMergingParNotCalculatedV0NegV0Neg(aPair.fMergingParNotCalculatedV0NegV0Neg),
   fFracOfMergedRowV0NegV0Neg(aPair.fFracOfMergedRowV0NegV0Neg),
-  fClosestRowAtDCAV0NegV0Neg(aPair.fClosestRowAtDCAV0NegV0Neg)
+  fClosestRowAtDCAV0NegV0Neg(aPair.fClosestRowAtDCAV0NegV0Neg),
+  fCalculated(aPair.fCalculated)
 {
   // Copy constructor
-  /* no-op */
+  std::copy(aPair.fCache, aPair.fCache + kNCachedQuantities, fCache);
   std::fill_n(fAverageSeparations, 4, NAN);
 }
 
@@ -177,7 +184,6 @@ AliFemtoPair& AliFemtoPair::operator=(const AliFemtoPair &aPair)
 
   fPairAngleEP = aPair.fPairAngleEP;
 
-  fNonIdParNotCalculated = aPair.fNonIdParNotCalculated;
   fDKSide = aPair.fDKSide;
   fDKOut = aPair.fDKOut;
   fDKLong = aPair.fDKLong;
@@ -215,11 +221,36 @@ AliFemtoPair& AliFemtoPair::operator=(const AliFemtoPair &aPair)
   fFracOfMergedRowV0NegV0Neg = aPair.fFracOfMergedRowV0NegV0Neg;
   fClosestRowAtDCAV0NegV0Neg = aPair.fClosestRowAtDCAV0NegV0Neg;
 
+  fCalculated = aPair.fCalculated;
+  std::copy(aPair.fCache, aPair.fCache + kNCachedQuantities, fCache);
+
   std::fill_n(fAverageSeparations, 4, NAN);
 
   return *this;
 }
 
+//________________________
+void AliFemtoPair::ResetCacheStatistics()
+{
+  // Zero the request and computation counters of the cached quantities
+  std::fill_n(fgNRequested, (int)kNCachedQuantities, 0ull);
+  std::fill_n(fgNCalculated, (int)kNCachedQuantities, 0ull);
+}
+//________________________
+void AliFemtoPair::PrintCacheStatistics()
+{
+  // Print how often each cached quantity was requested and computed
+  static const char *names[kNCachedQuantities] = {
+    "QInv", "KT", "MInv", "Rap", "QOutCMS", "QSideCMS", "QLongCMS", "QOutPf", "KStar"
+  };
+
+  printf("AliFemtoPair cache statistics:\n");
+  printf("  %-10s %16s %16s %10s\n", "quantity", "requested", "computed", "reuse");
+  for (int i = 0; i < kNCachedQuantities; i++) {
+    printf("  %-10s %16llu %16llu %10.2f\n", names[i], fgNRequested[i], fgNCalculated[i],
+           fgNCalculated[i] ? (double)fgNRequested[i] / fgNCalculated[i] : 0.0);
+  }
+}
 //________________________
 double AliFemtoPair::GetPairAngleEP() const
 {
@@ -229,22 +260,25 @@ double AliFemtoPair::GetPairAngleEP() const
 double AliFemtoPair::MInv() const
 {
   // invariant mass
+    if (IsCached(kMInv)) return fCache[kMInv];
     double tInvariantMass = abs(fTrack1->FourMomentum() + fTrack2->FourMomentum());
-    return tInvariantMass;
+    return Cache(kMInv, tInvariantMass);
 }
 //_________________
 double AliFemtoPair::KT() const
 {
   // transverse momentum
+  if (IsCached(kKT)) return fCache[kKT];
   double tmp = (fTrack1->FourMomentum() + fTrack2->FourMomentum()).Perp();
   tmp *= .5;
 
-  return tmp;
+  return Cache(kKT, tmp);
 }
 //_________________
 double AliFemtoPair::Rap() const
 {
   // longitudinal pair rapidity : Y = 0.5 ::log( E1 + E2 + pz1 + pz2 / E1 + E2 - pz1 - pz2 )
+  if (IsCached(kRap)) return fCache[kRap];
   const AliFemtoLorentzVector &p1 = fTrack1->FourMomentum(),
                               &p2 = fTrack2->FourMomentum();
 
@@ -252,7 +286,7 @@ double AliFemtoPair::Rap() const
                Z = p1.z() + p2.z(),
              tmp = 0.5 * log ( (E + Z) / (E - Z) );
 
-  return tmp;
+  return Cache(kRap, tmp);
 }
 //_________________
 double AliFemtoPair::EmissionAngle() const {
@@ -391,6 +425,7 @@ void AliFemtoPair::QYKPPF(double& qP, double& qT, double& q0) const
 double AliFemtoPair::QOutCMS() const
 {
   // relative momentum out component in lab frame
+  if (IsCached(kQOutCMS)) return fCache[kQOutCMS];
   const AliFemtoThreeVector
     &p1 = fTrack1->FourMomentum().vect(),
     &p2 = fTrack2->FourMomentum().vect();
@@ -405,13 +440,14 @@ double AliFemtoPair::QOutCMS() const
     k = dx*px + dy*py,
     pt = ::sqrt(px*px + py*py);
 
-  return CHECKED_DIVIDE_ELSE_ZERO(k, pt);
+  return Cache(kQOutCMS, CHECKED_DIVIDE_ELSE_ZERO(k, pt));
 }
 
 //_________________
 double AliFemtoPair::QSideCMS() const
 {
   // relative momentum side component in lab frame
+  if (IsCached(kQSideCMS)) return fCache[kQSideCMS];
   const AliFemtoThreeVector
     &p1 = fTrack1->FourMomentum().vect(),
     &p2 = fTrack2->FourMomentum().vect();
@@ -429,13 +465,14 @@ double AliFemtoPair::QSideCMS() const
     k = 2.0 * (x2*y1 - x1*y2),
     pt = ::sqrt(xt*xt + yt*yt);
 
-  return CHECKED_DIVIDE_ELSE_ZERO(k, pt);
+  return Cache(kQSideCMS, CHECKED_DIVIDE_ELSE_ZERO(k, pt));
 }
 
 //_________________________
 double AliFemtoPair::QLongCMS() const
 {
   // relative momentum component in lab frame
+  if (IsCached(kQLongCMS)) return fCache[kQLongCMS];
   const AliFemtoLorentzVector
     &tmp1 = fTrack1->FourMomentum(),
     &tmp2 = fTrack2->FourMomentum();
@@ -449,13 +486,14 @@ double AliFemtoPair::QLongCMS() const
   double beta = zz/tt;
   double gamma = 1.0/TMath::Sqrt((1.-beta)*(1.+beta));
 
-  return gamma * (dz - beta*dt);
+  return Cache(kQLongCMS, gamma * (dz - beta*dt));
 }
 
 //________________________________
 double AliFemtoPair::QOutPf() const
 {
   // relative momentum out component in pair frame
+  if (IsCached(kQOutPf)) return fCache[kQOutPf];
   const AliFemtoLorentzVector
     &tmp1 = fTrack1->FourMomentum(),
     &tmp2 = fTrack2->FourMomentum();
@@ -472,7 +510,7 @@ double AliFemtoPair::QOutPf() const
     bOut = pt / tt,
     gammaOut = 1.0 / TMath::Sqrt((1.-bOut)*(1.+bOut));
 
-  return gammaOut * (QOutCMS() - bOut*dt);
+  return Cache(kQOutPf, gammaOut * (QOutCMS() - bOut*dt));
 }
 
 #undef CHECKED_DIVIDE_ELSE_ZERO
@@ -764,7 +802,7 @@ void AliFemtoPair::CalcNonIdPar() const
   // Calculate generalized relative mometum
   // Use this instead of qXYZ() function when calculating
   // anything for non-identical particles
-  fNonIdParNotCalculated=0;
+  fCalculated |= (1u << kNonIdPar);
 
   const AliFemtoLorentzVector
     &p1 = fTrack1->FourMomentum(),
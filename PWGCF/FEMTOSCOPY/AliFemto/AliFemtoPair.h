@@ -212,6 +212,24 @@ public:
   static bool IsPointUnset(const AliFemtoThreeVector &v)
     { return v.x() < -9000.0 && v.y() < -9000.0 && v.z() < -9000.0; }
 
+  /// Kinematic quantities computed at most once per pair
+  ///
+  /// The values are kept until one of the tracks is changed. kNonIdPar
+  /// stands for the k* group (KStar, KStarOut/Side/Long, CVK).
+  enum ECachedQuantity {
+    kQInv, kKT, kMInv, kRap,
+    kQOutCMS, kQSideCMS, kQLongCMS, kQOutPf,
+    kNonIdPar,
+    kNCachedQuantities
+  };
+
+  /// Count, for all pairs, how often each cached quantity is requested
+  /// and how often it had to be computed (off by default)
+  static void SetCacheStatistics(bool enable) { fgCacheStatistics = enable; }
+  static bool CacheStatistics() { return fgCacheStatistics; }
+  static void ResetCacheStatistics();
+  static void PrintCacheStatistics();
+
   static double CalcAvgSepTracks(const AliFemtoTrack &t1, const AliFemtoTrack &t2);
   static void CalcAvgSepTrackV0(const AliFemtoTrack &, const AliFemtoV0 &,
                                 double &avgsep_neg, double &avgsep_pos);
@@ -227,7 +245,6 @@ private:
 
   double fPairAngleEP;	//Pair emission angle wrt EP
 
-  mutable short fNonIdParNotCalculated; // Set to 1 when NonId variables (kstar) have been already calculated for this pair
   mutable double fDKSide; // momemntum of first particle in PRF - k* side component
   mutable double fDKOut;  // momemntum of first particle in PRF - k* out component
   mutable double fDKLong; // momemntum of first particle in PRF - k* long component
@@ -272,6 +289,18 @@ private:
   mutable double fFracOfMergedRowV0NegV0Neg;	    // fraction of merged rows for V0 neg - V0 neg
   mutable double fClosestRowAtDCAV0NegV0Neg;	    // Row at which DCA occurs for V0 neg - V0 neg
 
+  mutable unsigned int fCalculated;                  // bit i set when quantity i (ECachedQuantity) is in fCache
+  mutable double fCache[kNCachedQuantities];         // cached kinematic quantities
+
+  static bool fgCacheStatistics;                              // count cache requests
+  static unsigned long long fgNRequested[kNCachedQuantities]; // requests of each cached quantity
+  static unsigned long long fgNCalculated[kNCachedQuantities]; // computations of each cached quantity
+
+  /// Check if the quantity is cached and update the statistics
+  bool IsCached(ECachedQuantity q) const;
+  /// Store the value of the quantity, returns it
+  double Cache(ECachedQuantity q, double value) const;
+
   /// Used to store the average separations of tracks
   mutable double fAverageSeparations[4];
 
@@ -304,7 +333,6 @@ private:
 };
 
 inline void AliFemtoPair::ResetParCalculated(){
-  fNonIdParNotCalculated=1;
   fNonIdParNotCalculatedGlobal=1;
   fMergingParNotCalculated=1;
   fMergingParNotCalculatedTrkV0Pos=1;
@@ -313,6 +341,7 @@ inline void AliFemtoPair::ResetParCalculated(){
   fMergingParNotCalculatedV0NegV0Pos=1;
   fMergingParNotCalculatedV0PosV0Neg=1;
   fMergingParNotCalculatedV0NegV0Neg=1;
+  fCalculated=0;
 
   std::fill_n(fAverageSeparations, 4, NAN);
   std::fill_n(fSharingCache, 2, NAN);
@@ -331,42 +360,57 @@ inline void AliFemtoPair::SetTrack2(const AliFemtoParticle* trkPtr){
 inline AliFemtoParticle* AliFemtoPair::Track1() const {return fTrack1;}
 inline AliFemtoParticle* AliFemtoPair::Track2() const {return fTrack2;}
 
+inline bool AliFemtoPair::IsCached(ECachedQuantity q) const {
+  const bool cached = fCalculated & (1u << q);
+  if (fgCacheStatistics) {
+    ++fgNRequested[q];
+    if (!cached) ++fgNCalculated[q];
+  }
+  return cached;
+}
+inline double AliFemtoPair::Cache(ECachedQuantity q, double value) const {
+  fCache[q] = value;
+  fCalculated |= (1u << q);
+  return value;
+}
+
 inline double AliFemtoPair::KSide() const{
-  if(fNonIdParNotCalculated) CalcNonIdPar();
+  if(!IsCached(kNonIdPar)) CalcNonIdPar();
   return fDKSide;
 }
 inline double AliFemtoPair::KOut() const{
-  if(fNonIdParNotCalculated) CalcNonIdPar();
+  if(!IsCached(kNonIdPar)) CalcNonIdPar();
   return fDKOut;
 }
 inline double AliFemtoPair::KLong() const{
-  if(fNonIdParNotCalculated) CalcNonIdPar();
+  if(!IsCached(kNonIdPar)) CalcNonIdPar();
   return fDKLong;
 }
 inline double AliFemtoPair::KStar() const{
-  if(fNonIdParNotCalculated) CalcNonIdPar();
+  if(!IsCached(kNonIdPar)) CalcNonIdPar();
   return fKStarCalc;
 }
 inline double AliFemtoPair::QInv() const {
+  if (IsCached(kQInv)) return fCache[kQInv];
   AliFemtoLorentzVector tDiff = (fTrack1->FourMomentum()-fTrack2->FourMomentum());
-  return -tDiff.m();
+  return Cache(kQInv, -tDiff.m());
 }
 
 // Fabrice private <<<
 inline double AliFemtoPair::KStarSide() const{
-  if(fNonIdParNotCalculated) CalcNonIdPar();
+  if(!IsCached(kNonIdPar)) CalcNonIdPar();
   return fDKSide;//mKStarSide;
 }
 inline double AliFemtoPair::KStarOut() const{
-  if(fNonIdParNotCalculated) CalcNonIdPar();
+  if(!IsCached(kNonIdPar)) CalcNonIdPar();
   return fDKOut;//mKStarOut;
 }
 inline double AliFemtoPair::KStarLong() const{
-  if(fNonIdParNotCalculated) CalcNonIdPar();
+  if(!IsCached(kNonIdPar)) CalcNonIdPar();
   return fDKLong;//mKStarLong;
 }
 inline double AliFemtoPair::CVK() const{
-  if(fNonIdParNotCalculated) CalcNonIdPar();
+  if(!IsCached(kNonIdPar)) CalcNonIdPar();
   return fCVK;
 }
 
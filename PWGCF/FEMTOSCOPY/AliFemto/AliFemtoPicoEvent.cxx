@@ -67,7 +67,10 @@
 AliFemtoPicoEvent::AliFemtoPicoEvent() :
   fFirstParticleCollection(0),
   fSecondParticleCollection(0),
-  fThirdParticleCollection(0)
+  fThirdParticleCollection(0),
+  fFirstParticleArray(),
+  fSecondParticleArray(),
+  fFrozen(false)
 {
   // Default constructor
   fFirstParticleCollection = new AliFemtoParticleCollection;
@@ -78,7 +81,10 @@ AliFemtoPicoEvent::AliFemtoPicoEvent() :
 AliFemtoPicoEvent::AliFemtoPicoEvent(const AliFemtoPicoEvent& aPicoEvent) :
   fFirstParticleCollection(0),
   fSecondParticleCollection(0),
-  fThirdParticleCollection(0)
+  fThirdParticleCollection(0),
+  fFirstParticleArray(),
+  fSecondParticleArray(),
+  fFrozen(false)
 {
   // Copy constructor
   AliFemtoParticleIterator iter;
@@ -174,6 +180,10 @@ AliFemtoPicoEvent& AliFemtoPicoEvent::operator=(const AliFemtoPicoEvent& aPicoEv
     fThirdParticleCollection = 0;
   }
 
+  fFirstParticleArray.clear();
+  fSecondParticleArray.clear();
+  fFrozen = false;
+
   fFirstParticleCollection = new AliFemtoParticleCollection;
   if (aPicoEvent.fFirstParticleCollection) {
     for (iter=aPicoEvent.fFirstParticleCollection->begin();iter!=aPicoEvent.fFirstParticleCollection->end();iter++){
@@ -195,4 +205,14 @@ AliFemtoPicoEvent& AliFemtoPicoEvent::operator=(const AliFemtoPicoEvent& aPicoEv
 
   return *this;
 }
+//_________________
+void AliFemtoPicoEvent::Freeze()
+{
+  // Fill the contiguous particle arrays from the collections
+  if (fFrozen)
+    return;
 
+  fFirstParticleArray.assign(fFirstParticleCollection->begin(), fFirstParticleCollection->end());
+  fSecondParticleArray.assign(fSecondParticleCollection->begin(), fSecondParticleCollection->end());
+  fFrozen = true;
+}
@@ -43,6 +43,7 @@
 #define ALIFEMTOPICOEVENT_H
 
 #include "AliFemtoParticleCollection.h"
+#include <vector>
 
 class AliFemtoPicoEvent{
 public:
@@ -58,14 +59,29 @@ public:
   AliFemtoParticleCollection* SecondParticleCollection();
   AliFemtoParticleCollection* ThirdParticleCollection();
 
+  /// Copy the first and second particle collections into contiguous arrays,
+  /// used by the pair loops instead of walking the lists. Must be called
+  /// once the collections are complete; later calls are no-ops.
+  void Freeze();
+  bool IsFrozen() const;
+  const std::vector<AliFemtoParticle*>& FirstParticleArray() const;
+  const std::vector<AliFemtoParticle*>& SecondParticleArray() const;
+
 private:
   AliFemtoParticleCollection* fFirstParticleCollection;  // Collection of particles of type 1
   AliFemtoParticleCollection* fSecondParticleCollection; // Collection of particles of type 2
   AliFemtoParticleCollection* fThirdParticleCollection;  // Collection of particles of type 3
+
+  std::vector<AliFemtoParticle*> fFirstParticleArray;    // Contiguous copy of the first collection
+  std::vector<AliFemtoParticle*> fSecondParticleArray;   // Contiguous copy of the second collection
+  bool fFrozen;                                          // Arrays are filled
 };
 
 inline AliFemtoParticleCollection* AliFemtoPicoEvent::FirstParticleCollection(){return fFirstParticleCollection;}
 inline AliFemtoParticleCollection* AliFemtoPicoEvent::SecondParticleCollection(){return fSecondParticleCollection;}
 inline AliFemtoParticleCollection* AliFemtoPicoEvent::ThirdParticleCollection(){return fThirdParticleCollection;}
+inline bool AliFemtoPicoEvent::IsFrozen() const {return fFrozen;}
+inline const std::vector<AliFemtoParticle*>& AliFemtoPicoEvent::FirstParticleArray() const {return fFirstParticleArray;}
+inline const std::vector<AliFemtoParticle*>& AliFemtoPicoEvent::SecondParticleArray() const {return fSecondParticleArray;}
 
 #endif
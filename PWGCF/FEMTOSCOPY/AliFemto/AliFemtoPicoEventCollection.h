@@ -30,18 +30,93 @@
 #ifndef AliFemtoPicoEventCollection_hh
 #define AliFemtoPicoEventCollection_hh
 #include "AliFemtoPicoEvent.h"
-#include <list>
+#include <vector>
+#include <cstddef>
 
-#if !defined(ST_NO_NAMESPACES)
-using std::list;
-#endif
+/// \class AliFemtoPicoEventCollection
+/// \brief Event-mixing buffer, stored as a ring of pico-event pointers
+///
+/// The newest event is at the front, the oldest one at the back. Only the
+/// subset of the std::list interface used by the analyses is provided
+/// (push_front, pop_back, front, back, size, empty, clear and forward
+/// iteration from the newest to the oldest event). The slots live in one
+/// contiguous array which only grows when an event is pushed into a full
+/// ring, so rotating a full buffer does not allocate.
+///
+/// As for the former list, the collection does not own the events.
+///
+class AliFemtoPicoEventCollection {
+public:
 
-#ifdef ST_NO_TEMPLATE_DEF_ARGS
-typedef list<AliFemtoPicoEvent*, allocator<AliFemtoPicoEvent*> >            AliFemtoPicoEventCollection;
-typedef list<AliFemtoPicoEvent*, allocator<AliFemtoPicoEvent*> >::iterator  AliFemtoPicoEventIterator;
-#else
-typedef list<AliFemtoPicoEvent*>            AliFemtoPicoEventCollection;
-typedef list<AliFemtoPicoEvent*>::iterator  AliFemtoPicoEventIterator;
-#endif
+  class iterator {
+  public:
+    iterator(): fCollection(NULL), fIndex(0) {}
+    iterator(AliFemtoPicoEventCollection *collection, size_t index): fCollection(collection), fIndex(index) {}
+
+    AliFemtoPicoEvent*& operator*() const { return fCollection->At(fIndex); }
+    AliFemtoPicoEvent* operator->() const { return fCollection->At(fIndex); }
+    iterator& operator++() { ++fIndex; return *this; }
+    iterator operator++(int) { iterator tmp(*this); ++fIndex; return tmp; }
+    bool operator==(const iterator &rhs) const { return fIndex == rhs.fIndex && fCollection == rhs.fCollection; }
+    bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+
+  private:
+    AliFemtoPicoEventCollection *fCollection; ///< iterated collection
+    size_t fIndex;                            ///< position counted from the front
+  };
+
+  AliFemtoPicoEventCollection(): fSlots(), fHead(0), fSize(0) {}
+
+  size_t size() const { return fSize; }
+  bool empty() const { return fSize == 0; }
+
+  AliFemtoPicoEvent*& front() { return fSlots[fHead]; }
+  AliFemtoPicoEvent*& back() { return At(fSize - 1); }
+
+  void push_front(AliFemtoPicoEvent *event)
+  {
+    if (fSize == fSlots.size()) {
+      Grow();
+    }
+    fHead = (fHead == 0 ? fSlots.size() : fHead) - 1;
+    fSlots[fHead] = event;
+    ++fSize;
+  }
+  void pop_back() { fSlots[Slot(--fSize)] = NULL; }
+  void clear() { fSlots.assign(fSlots.size(), NULL); fHead = 0; fSize = 0; }
+
+  /// Preallocate the ring for n events
+  void reserve(size_t n) { while (fSlots.size() < n) Grow(); }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, fSize); }
+
+  /// Event at the given position, counted from the front (newest event)
+  AliFemtoPicoEvent*& At(size_t index) { return fSlots[Slot(index)]; }
+
+private:
+  size_t Slot(size_t index) const
+  {
+    size_t slot = fHead + index;
+    return slot < fSlots.size() ? slot : slot - fSlots.size();
+  }
+
+  /// Double the ring, keeping the order of the stored events
+  void Grow()
+  {
+    std::vector<AliFemtoPicoEvent*> slots(fSlots.empty() ? 4 : 2 * fSlots.size(), NULL);
+    for (size_t i = 0; i < fSize; ++i) {
+      slots[i] = fSlots[Slot(i)];
+    }
+    fSlots.swap(slots);
+    fHead = 0;
+  }
+
+  std::vector<AliFemtoPicoEvent*> fSlots; ///< ring storage
+  size_t fHead;                           ///< slot of the newest event
+  size_t fSize;                           ///< number of stored events
+};
+
+typedef AliFemtoPicoEventCollection::iterator  AliFemtoPicoEventIterator;
 
 #endif
@@ -183,7 +183,9 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis():
   fMinSizePartCollection(0),
   fVerbose(kTRUE),
   fPerformSharedDaughterCut(kFALSE),
-  fEnablePairMonitors(kFALSE)
+  fEnablePairMonitors(kFALSE),
+  fPair(nullptr),
+  fParticleArray()
 {
   // Default constructor
   fCorrFctnCollection = new AliFemtoCorrFctnCollection;
@@ -205,7 +207,9 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis(const AliFemtoSimpleAnalysis& a):
   fMinSizePartCollection(a.fMinSizePartCollection),
   fVerbose(a.fVerbose),
   fPerformSharedDaughterCut(a.fPerformSharedDaughterCut),
-  fEnablePairMonitors(a.fEnablePairMonitors)
+  fEnablePairMonitors(a.fEnablePairMonitors),
+  fPair(nullptr),
+  fParticleArray()
 {
   /// Copy constructor
 
@@ -317,6 +321,8 @@ AliFemtoSimpleAnalysis::~AliFemtoSimpleAnalysis()
     }
     delete fMixingBuffer;
   }
+
+  delete fPair;
 }
 //______________________
 AliFemtoSimpleAnalysis& AliFemtoSimpleAnalysis::operator=(const AliFemtoSimpleAnalysis& aAna)
@@ -535,7 +541,13 @@ void AliFemtoSimpleAnalysis::ProcessEvent(const AliFemtoEvent* hbtEvent)
     collection2 = nullptr;
   }
 
-  MakePairs("real", collection1, collection2, EnablePairMonitors());
+  // the pico event is complete - the pair loops run over its particle arrays
+  fPicoEvent->Freeze();
+
+  const std::vector<AliFemtoParticle*> &particles1 = fPicoEvent->FirstParticleArray(),
+                                       &particles2 = fPicoEvent->SecondParticleArray();
+
+  MakePairs("real", particles1, collection2 ? &particles2 : nullptr, EnablePairMonitors());
 
   if (fVerbose) {
     cout << "AliFemtoSimpleAnalysis::ProcessEvent() - reals done ";
@@ -544,17 +556,20 @@ void AliFemtoSimpleAnalysis::ProcessEvent(const AliFemtoEvent* hbtEvent)
   //---- Make pairs for mixed events, looping over events in mixingBuffer ----//
   for (auto storedEvent : *fMixingBuffer) {
 
+    // events put in the buffer by other code may not have their arrays yet
+    storedEvent->Freeze();
+
     // If identical - only mix the first particle collections
     if (AnalyzeIdenticalParticles()) {
-      MakePairs("mixed", collection1, storedEvent->FirstParticleCollection());
+      MakePairs("mixed", particles1, &storedEvent->FirstParticleArray());
 
     // If non-identical - mix both combinations of first and second particles
     } else {
-        MakePairs("mixed", collection1,
-                           storedEvent->SecondParticleCollection());
+        MakePairs("mixed", particles1,
+                           &storedEvent->SecondParticleArray());
 
-        MakePairs("mixed", storedEvent->FirstParticleCollection(),
-                           collection2);
+        MakePairs("mixed", storedEvent->FirstParticleArray(),
+                           &particles2);
     }
   }
 
@@ -585,73 +600,63 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
 /// AddMixedPair() methods. If no second particle collection is
 /// specfied, make pairs within first particle collection.
 
+  fParticleArray[0].assign(partCollection1->begin(), partCollection1->end());
+  if (partCollection2) {
+    fParticleArray[1].assign(partCollection2->begin(), partCollection2->end());
+  }
+
+  MakePairs(typeIn, fParticleArray[0], partCollection2 ? &fParticleArray[1] : nullptr, enablePairMonitors);
+}
+//_________________________
+void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
+                                       const std::vector<AliFemtoParticle*> &particles1,
+                                       const std::vector<AliFemtoParticle*> *particles2,
+                                       Bool_t enablePairMonitors)
+{
+/// Build pairs, check pair cuts, and call CFs' AddRealPair() or
+/// AddMixedPair() methods. If no second particle array is specfied, make
+/// pairs within the first array.
+
   bool these_are_real_pairs = 0 == strcmp(typeIn, "real");
 
   if (!these_are_real_pairs && strcmp(typeIn, "mixed")) {
     std::cerr << "Problem with pair type, type = " << typeIn << "\n";
     return;
   }
-  //  int swpart = ((long int) partCollection1) % 2;
 
   // Used to swap particle 1 & 2 in identical-particle analysis
   // to avoid any implicit ordering in the event collection
   // "Seed" this here.
   bool swpart = fNeventsProcessed % 2;
 
-  // Setup iterator ranges
-  //
-  // The outer loop alway starts at beginning of particle collection 1.
-  // * If we are iterating over both particle collections, then the loop simply
-  // runs through both from beginning to end.
-  // * If we are only iterating over one particle collection, the inner loop
-  // loops over all particles between the outer iterator and the end of the
-  // collection. The outer loop must skip the last entry of the list.
-  AliFemtoParticleConstIterator tStartOuterLoop = partCollection1->begin(),
-                                tEndOuterLoop = partCollection1->end(),
-                                tStartInnerLoop,
-                                tEndInnerLoop;
-
-  if (partCollection2) {                         // Two collections:
-    tStartInnerLoop = partCollection2->begin();  //   Full inner & outer loops
-    tEndInnerLoop   = partCollection2->end();    //
-  }
-  else {                                         // One collection:
-    tEndOuterLoop--;                             //   Outer loop goes to next-to-last particle
-    tEndInnerLoop = partCollection1->end() ;     //   Inner loop goes to last particle
-  }
-
-  // Create the pair outside the loop - only allocate once
-  AliFemtoPair* tPair = new AliFemtoPair;
-
-  // Begin the outer loop
-  for (AliFemtoParticleConstIterator tPartIter1 = tStartOuterLoop;
-                                     tPartIter1 != tEndOuterLoop;
-                                     ++tPartIter1) {
-
-    // If analyzing identical particles, start inner loop at the particle
-    // after the current outer loop position, (loops until end)
-    if (!partCollection2) {
-      tStartInnerLoop = tPartIter1;
-      tStartInnerLoop++;
-    }
-
-    // If we have two collections - set the first track
-    if (partCollection2 != nullptr) {
-      tPair->SetTrack1(*tPartIter1);
-    }
+  // The pair is created once and reused for all the events
+  if (!fPair) {
+    fPair = new AliFemtoPair;
+  }
+  AliFemtoPair *tPair = fPair;
 
-    // Begin the inner loop
-    for (AliFemtoParticleConstIterator tPartIter2 = tStartInnerLoop;
-                                       tPartIter2 != tEndInnerLoop;
-                                     ++tPartIter2) {
-      // If we have two collections - only set the second track
-      if (partCollection2 != nullptr) {
-        tPair->SetTrack2(*tPartIter2);
+  // Setup index ranges
+  //
+  // The outer loop alway starts at the beginning of array 1.
+  // * If we are iterating over both arrays, then the inner loop simply
+  // runs through the second one from beginning to end.
+  // * If we are only iterating over one array, the inner loop starts at
+  // the particle after the current outer loop position.
+  AliFemtoParticle* const* tParticles1 = particles1.data();
+  AliFemtoParticle* const* tParticles2 = particles2 ? particles2->data() : tParticles1;
+  const size_t tNParticles1 = particles1.size(),
+               tNParticles2 = particles2 ? particles2->size() : tNParticles1;
+
+  for (size_t i = 0; i < tNParticles1; ++i) {
+    for (size_t j = particles2 ? 0 : i + 1; j < tNParticles2; ++j) {
+      if (particles2) {
+        tPair->SetTrack1(tParticles1[i]);
+        tPair->SetTrack2(tParticles2[j]);
 
       // Swap between first and second particles to avoid biased ordering
       } else {
-        tPair->SetTrack1(swpart ? *tPartIter2 : *tPartIter1);
-        tPair->SetTrack2(swpart ? *tPartIter1 : *tPartIter2);
+        tPair->SetTrack1(swpart ? tParticles2[j] : tParticles1[i]);
+        tPair->SetTrack2(swpart ? tParticles1[i] : tParticles2[j]);
         swpart = !swpart;
       }
 
@@ -675,9 +680,6 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
 
     }    // loop over second particle
   }      // loop over first particle
-
-  // we are done with the pair
-  delete tPair;
 }
 //_________________________
 void AliFemtoSimpleAnalysis::EventBegin(const AliFemtoEvent* ev)
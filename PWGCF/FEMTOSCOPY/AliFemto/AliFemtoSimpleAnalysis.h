@@ -16,6 +16,8 @@
 #include "AliFemtoV0SharedDaughterCut.h"
 #include "AliFemtoXiSharedDaughterCut.h"
 
+#include <vector>
+
 class AliFemtoPicoEventCollectionVectorHideAway;
 class AliFemtoPicoEvent;
 
@@ -159,6 +161,16 @@ protected:
                  AliFemtoParticleCollection* ParticlesPssingCut2=NULL,
                  Bool_t enablePairMonitors=kFALSE);
 
+  /// Same as above, running over contiguous particle arrays (see
+  /// AliFemtoPicoEvent::Freeze). Each pair passing the pair cut is handed
+  /// to the correlation functions before the next pair is cut, so pair
+  /// cuts and correlation functions keeping state see the same sequence
+  /// of calls as before.
+  void MakePairs(const char* type,
+                 const std::vector<AliFemtoParticle*>& ParticlesPassingCut1,
+                 const std::vector<AliFemtoParticle*>* ParticlesPassingCut2=NULL,
+                 Bool_t enablePairMonitors=kFALSE);
+
   AliFemtoPicoEventCollectionVectorHideAway* fPicoEventCollectionVectorHideAway; //!<! Mixing Buffer used for Analyses which wrap this one
 
   AliFemtoPairCut*             fPairCut;             ///< cut applied to pairs
@@ -178,6 +190,9 @@ protected:
   Bool_t fPerformSharedDaughterCut;
   Bool_t fEnablePairMonitors;
 
+  AliFemtoPair* fPair;                               //!<! pair reused by MakePairs for all the events
+  std::vector<AliFemtoParticle*> fParticleArray[2];  //!<! contiguous copies of the collections given to MakePairs
+
 #ifdef __ROOT__
   /// \cond CLASSIMP
   ClassDef(AliFemtoSimpleAnalysis, 0);
@@ -47,7 +47,9 @@ AliFemtoDreamCollConfig::AliFemtoDreamCollConfig()
       fDeltaEtaMax(0.f),
       fDeltaPhiMax(0.f),
       fDoDeltaEtaDeltaPhiCut(false),
-      fCoutVariables(false) {
+      fCoutVariables(false),
+      fNumberOfThreads(0),
+      fEnableThreadSafety(false) {
   //should not be used, since we need a name to deal with root objects
 }
 
@@ -92,7 +94,9 @@ AliFemtoDreamCollConfig::AliFemtoDreamCollConfig(
       fDeltaEtaMax(config.fDeltaEtaMax),
       fDeltaPhiMax(config.fDeltaPhiMax),
       fDoDeltaEtaDeltaPhiCut(config.fDoDeltaEtaDeltaPhiCut),
-      fCoutVariables(config.fCoutVariables) {
+      fCoutVariables(config.fCoutVariables),
+      fNumberOfThreads(config.fNumberOfThreads),
+      fEnableThreadSafety(config.fEnableThreadSafety) {
 }
 
 AliFemtoDreamCollConfig::AliFemtoDreamCollConfig(const char *name,
@@ -137,7 +141,9 @@ AliFemtoDreamCollConfig::AliFemtoDreamCollConfig(const char *name,
       fDeltaEtaMax(0.f),
       fDeltaPhiMax(0.f),
       fDoDeltaEtaDeltaPhiCut(false),
-      fCoutVariables(QACouts) {
+      fCoutVariables(QACouts),
+      fNumberOfThreads(0),
+      fEnableThreadSafety(false) {
 }
 AliFemtoDreamCollConfig& AliFemtoDreamCollConfig::operator=(
     const AliFemtoDreamCollConfig& config) {
@@ -182,6 +188,8 @@ AliFemtoDreamCollConfig& AliFemtoDreamCollConfig::operator=(
     this->fDeltaPhiMax = config.fDeltaPhiMax;
     this->fDoDeltaEtaDeltaPhiCut = config.fDoDeltaEtaDeltaPhiCut;
     this->fCoutVariables = config.fCoutVariables;
+    this->fNumberOfThreads = config.fNumberOfThreads;
+    this->fEnableThreadSafety = config.fEnableThreadSafety;
   }
   return *this;
 }
@@ -126,6 +126,20 @@ class AliFemtoDreamCollConfig : public TNamed {
     fMinimalBookingSample = doIt;
   }
   ;
+  //Number of threads of the pool pairing the different particle combinations,
+  //0 or 1 keeps the pairing in the calling thread (as does a ROOT built
+  //without implicit MT)
+  void SetNumberOfThreads(int nThreads) {
+    fNumberOfThreads = nThreads;
+  }
+  ;
+  //Calls ROOT::EnableThreadSafety() when the collection is created with more
+  //than one thread. This changes the state of the whole process, so it is
+  //left to the user to decide
+  void SetEnableThreadSafety(bool enable) {
+    fEnableThreadSafety = enable;
+  }
+  ;
   void SetMultiplicityEstimator(AliFemtoDreamEvent::MultEstimator est) {
     fEst = est;
   }
@@ -245,6 +259,14 @@ class AliFemtoDreamCollConfig : public TNamed {
     return fMixingDepth;
   }
   ;
+  int GetNumberOfThreads() {
+    return fNumberOfThreads;
+  }
+  ;
+  bool GetEnableThreadSafety() {
+    return fEnableThreadSafety;
+  }
+  ;
   int GetSpinningDepth() {
     return fSpinningDepth;
   }
@@ -318,7 +340,9 @@ class AliFemtoDreamCollConfig : public TNamed {
   float fDeltaPhiMax;           //
   bool fDoDeltaEtaDeltaPhiCut;  //
   bool fCoutVariables;
-  ClassDef(AliFemtoDreamCollConfig,17);
+  int fNumberOfThreads;         //
+  bool fEnableThreadSafety;     //
+  ClassDef(AliFemtoDreamCollConfig,19);
 };
 
 #endif /* ALIFEMTODREAMCOLLCONFIG_H_ */
@@ -8,13 +8,20 @@
 #include <iostream>
 #include "AliFemtoDreamPartCollection.h"
 #include "AliLog.h"
+#include "RConfigure.h"
+#include "TROOT.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 ClassImp(AliFemtoDreamPartCollection)
 AliFemtoDreamPartCollection::AliFemtoDreamPartCollection()
     : fHigherMath(),
       fNSpecies(0),
       fZVtxMultBuffer(),
       fValuesZVtxBins(),
-      fValuesMultBins() {
+      fValuesMultBins(),
+      fNumberOfThreads(0),
+      fThreadExecutor(nullptr) {
 
 }
 
@@ -24,7 +31,9 @@ AliFemtoDreamPartCollection::AliFemtoDreamPartCollection(
       fNSpecies(coll.fNSpecies),
       fZVtxMultBuffer(coll.fZVtxMultBuffer),
       fValuesZVtxBins(coll.fValuesZVtxBins),
-      fValuesMultBins(coll.fValuesMultBins) {
+      fValuesMultBins(coll.fValuesMultBins),
+      fNumberOfThreads(coll.fNumberOfThreads),
+      fThreadExecutor(nullptr) {
 
 }
 AliFemtoDreamPartCollection::AliFemtoDreamPartCollection(
@@ -36,7 +45,12 @@ AliFemtoDreamPartCollection::AliFemtoDreamPartCollection(
           std::vector<AliFemtoDreamZVtxMultContainer>(
               conf->GetNMultBins(), AliFemtoDreamZVtxMultContainer(conf))),
       fValuesZVtxBins(conf->GetZVtxBins()),
-      fValuesMultBins(conf->GetMultBins()) {
+      fValuesMultBins(conf->GetMultBins()),
+      fNumberOfThreads(conf->GetNumberOfThreads()),
+      fThreadExecutor(nullptr) {
+  if (fNumberOfThreads > 1 && conf->GetEnableThreadSafety()) {
+    ROOT::EnableThreadSafety();
+  }
 }
 
 AliFemtoDreamPartCollection& AliFemtoDreamPartCollection::operator=(
@@ -47,12 +61,36 @@ AliFemtoDreamPartCollection& AliFemtoDreamPartCollection::operator=(
     this->fZVtxMultBuffer = coll.fZVtxMultBuffer;
     this->fValuesZVtxBins = coll.fValuesZVtxBins;
     this->fValuesMultBins = coll.fValuesMultBins;
+    this->fNumberOfThreads = coll.fNumberOfThreads;
+#ifdef R__USE_IMT
+    delete this->fThreadExecutor;
+#endif
+    this->fThreadExecutor = nullptr;
   }
 
   return *this;
 }
 
 AliFemtoDreamPartCollection::~AliFemtoDreamPartCollection() {
+#ifdef R__USE_IMT
+  delete fThreadExecutor;
+#endif
+}
+
+ROOT::TThreadExecutor *AliFemtoDreamPartCollection::GetThreadExecutor() {
+  //The pool is created with the first event and then reused for all the
+  //events and all the z-vertex/multiplicity bins
+#ifdef R__USE_IMT
+  if (!fThreadExecutor && fNumberOfThreads > 1) {
+    fThreadExecutor = new ROOT::TThreadExecutor(fNumberOfThreads);
+  }
+#else
+  if (fNumberOfThreads > 1) {
+    AliWarning("ROOT built without implicit MT, pairing in a single thread");
+    fNumberOfThreads = 0;
+  }
+#endif
+  return fThreadExecutor;
 }
 
 void AliFemtoDreamPartCollection::SetEvent(
@@ -70,8 +108,8 @@ void AliFemtoDreamPartCollection::SetEvent(
     itZVtx += bins[0];
     auto itMult = itZVtx->begin();
     itMult += bins[1];
-    itMult->PairParticlesSE(Particles, fHigherMath, bins[1], cent);
-    itMult->PairParticlesME(Particles, fHigherMath, bins[1], cent);
+    itMult->PairParticles(Particles, fHigherMath, bins[1], cent,
+                          GetThreadExecutor());
     itMult->SetEvent(Particles);
   }
   return;
@@ -96,8 +134,8 @@ void AliFemtoDreamPartCollection::SetEvent(
     itZVtx += bins[0];
     auto itMult = itZVtx->begin();
     itMult += bins[1];
-    itMult->PairParticlesSE(Particles, fHigherMath, bins[1], cent);
-    itMult->PairParticlesME(Particles, fHigherMath, bins[1], cent);
+    itMult->PairParticles(Particles, fHigherMath, bins[1], cent,
+                          GetThreadExecutor());
     itMult->SetEvent(Particles);
   }
   return;
@@ -16,6 +16,11 @@
 #include "AliFemtoDreamCorrHists.h"
 #include "AliFemtoDreamHigherPairMath.h"
 #include "AliFemtoDreamZVtxMultContainer.h"
+
+namespace ROOT {
+class TThreadExecutor;
+}
+
 //Class containing all the different multiplicity containers for all the
 //particles
 class AliFemtoDreamPartCollection {
@@ -46,12 +51,15 @@ class AliFemtoDreamPartCollection {
   ;
   void FindBin(float ZVtxPos, float Multiplicity, int *returnBins);
  private:
+  ROOT::TThreadExecutor *GetThreadExecutor();
   AliFemtoDreamHigherPairMath* fHigherMath;
   unsigned int fNSpecies;
   std::vector<std::vector<AliFemtoDreamZVtxMultContainer>> fZVtxMultBuffer;
   std::vector<float> fValuesZVtxBins;
   std::vector<int> fValuesMultBins;
-  ClassDef(AliFemtoDreamPartCollection,2);
+  int fNumberOfThreads;
+  ROOT::TThreadExecutor *fThreadExecutor;  //! pool pairing the combinations, shared by all the bins
+  ClassDef(AliFemtoDreamPartCollection,4);
 };
 
 #endif /* ALIFEMTODREAMPARTCOLLECTION_H_ */
@@ -7,9 +7,14 @@
 //#include "AliLog.h"
 #include <iostream>
 #include "AliFemtoDreamZVtxMultContainer.h"
+#include "RConfigure.h"
 #include "TLorentzVector.h"
 #include "TDatabasePDG.h"
 #include "TVector2.h"
+#ifdef R__USE_IMT
+#include "ROOT/TSeq.hxx"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 ClassImp(AliFemtoDreamPartContainer)
 AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer()
@@ -61,58 +66,12 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
   int HistCounter = 0;
   //First loop over all the different Species
-  auto itPDGPar1 = fPDGParticleSpecies.begin();
-  for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
-      ++itSpec1) {
-    auto itPDGPar2 = fPDGParticleSpecies.begin();
-    itPDGPar2 += itSpec1 - Particles.begin();
-    for (auto itSpec2 = itSpec1; itSpec2 != Particles.end(); ++itSpec2) {
-      HigherMath->FillPairCounterSE(HistCounter, itSpec1->size(),
-                                    itSpec2->size());
-      //Now loop over the actual Particles and correlate them
-      for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
-          ++itPart1) {
-        AliFemtoDreamBasePart part1 = *itPart1;
-        std::vector<AliFemtoDreamBasePart>::iterator itPart2;
-        if (itSpec1 == itSpec2) {
-          itPart2 = itPart1 + 1;
-        } else {
-          itPart2 = itSpec2->begin();
-        }
-        while (itPart2 != itSpec2->end()) {
-          AliFemtoDreamBasePart part2 = *itPart2;
-          TLorentzVector PartOne, PartTwo;
-          PartOne.SetXYZM(
-              itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
-              itPart1->GetMomentum().Z(),
-              TDatabasePDG::Instance()->GetParticle(*itPDGPar1)->Mass());
-          PartTwo.SetXYZM(
-              itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
-              itPart2->GetMomentum().Z(),
-              TDatabasePDG::Instance()->GetParticle(*itPDGPar2)->Mass());
-          float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
-          if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
-                                               RelativeK, true, false)) {
-            ++itPart2;
-            continue;
-          }
-          RelativeK = HigherMath->FillSameEvent(HistCounter, iMult, cent,
-                                                part1,
-                                                *itPDGPar1,
-                                                part2,
-                                                *itPDGPar2);
-          HigherMath->MassQA(HistCounter, RelativeK, *itPart1, *itPart2);
-          HigherMath->SEDetaDPhiPlots(HistCounter, *itPart1, *itPDGPar1,
-                                      *itPart2, *itPDGPar2, RelativeK, false);
-          HigherMath->SEMomentumResolution(HistCounter, &(*itPart1), *itPDGPar1,
-                                           &(*itPart2), *itPDGPar2, RelativeK);
-          ++itPart2;
-        }
-      }
+  for (unsigned int iSpec1 = 0; iSpec1 < Particles.size(); ++iSpec1) {
+    for (unsigned int iSpec2 = iSpec1; iSpec2 < Particles.size(); ++iSpec2) {
+      PairSpeciesSE(Particles, HigherMath, iMult, cent, iSpec1, iSpec2,
+                    HistCounter);
       ++HistCounter;
-      itPDGPar2++;
     }
-    itPDGPar1++;
   }
 }
 
@@ -120,61 +79,147 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
   int HistCounter = 0;
-  auto itPDGPar1 = fPDGParticleSpecies.begin();
   //First loop over all the different Species
-  for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
-      ++itSpec1) {
-    //We dont want to correlate the particles twice. Mixed Event Dist. of
-    //Particle1 + Particle2 == Particle2 + Particle 1
-    int SkipPart = itSpec1 - Particles.begin();
-    auto itPDGPar2 = fPDGParticleSpecies.begin() + SkipPart;
-    for (auto itSpec2 = fPartContainer.begin() + SkipPart;
-        itSpec2 != fPartContainer.end(); ++itSpec2) {
-      if (itSpec1->size() > 0) {
-        HigherMath->FillEffectiveMixingDepth(HistCounter,
-                                             (int) itSpec2->GetMixingDepth());
+  //We dont want to correlate the particles twice. Mixed Event Dist. of
+  //Particle1 + Particle2 == Particle2 + Particle 1
+  for (unsigned int iSpec1 = 0; iSpec1 < Particles.size(); ++iSpec1) {
+    for (unsigned int iSpec2 = iSpec1; iSpec2 < fPartContainer.size();
+        ++iSpec2) {
+      PairSpeciesME(Particles, HigherMath, iMult, cent, iSpec1, iSpec2,
+                    HistCounter);
+      ++HistCounter;
+    }
+  }
+}
+
+void AliFemtoDreamZVtxMultContainer::PairParticles(
+    std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+    AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent,
+    ROOT::TThreadExecutor *executor) {
+  //Same and mixed event pairing of the event. Every pair combination only
+  //fills its own histograms, so the combinations are distributed over the
+  //thread pool of the collection, each combination being paired completely
+  //(same and mixed event) by a single task. The content of each histogram is
+  //the same as for the serial pairing.
+  const unsigned int nSpecies = Particles.size();
+  const unsigned int nCombinations = nSpecies * (nSpecies + 1) / 2;
+#ifdef R__USE_IMT
+  if (executor && nCombinations > 1) {
+    //Resolve the masses before starting the tasks: the PDG lookup table is
+    //built on first use
+    for (auto pdg : fPDGParticleSpecies) {
+      TDatabasePDG::Instance()->GetParticle(pdg);
+    }
+    std::vector<std::pair<unsigned int, unsigned int>> combinations;
+    combinations.reserve(nCombinations);
+    for (unsigned int iSpec1 = 0; iSpec1 < nSpecies; ++iSpec1) {
+      for (unsigned int iSpec2 = iSpec1; iSpec2 < nSpecies; ++iSpec2) {
+        combinations.push_back(std::make_pair(iSpec1, iSpec2));
       }
-      for (int iDepth = 0; iDepth < (int) itSpec2->GetMixingDepth(); ++iDepth) {
-        std::vector<AliFemtoDreamBasePart> ParticlesOfEvent = itSpec2->GetEvent(
-            iDepth);
-        HigherMath->FillPairCounterME(HistCounter, itSpec1->size(),
-                                      ParticlesOfEvent.size());
-        for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
-            ++itPart1) {
-          for (auto itPart2 = ParticlesOfEvent.begin();
-              itPart2 != ParticlesOfEvent.end(); ++itPart2) {
+    }
+    executor->Foreach([&](unsigned int iHC) {
+      PairSpeciesSE(Particles, HigherMath, iMult, cent,
+                    combinations[iHC].first, combinations[iHC].second, iHC);
+      PairSpeciesME(Particles, HigherMath, iMult, cent,
+                    combinations[iHC].first, combinations[iHC].second, iHC);
+    }, ROOT::TSeq<unsigned int>(nCombinations));
+    return;
+  }
+#else
+  (void) executor;
+  (void) nCombinations;
+#endif
+  PairParticlesSE(Particles, HigherMath, iMult, cent);
+  PairParticlesME(Particles, HigherMath, iMult, cent);
+}
 
-            TLorentzVector PartOne, PartTwo;
-            PartOne.SetXYZM(
-                itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
-                itPart1->GetMomentum().Z(),
-                TDatabasePDG::Instance()->GetParticle(*itPDGPar1)->Mass());
-            PartTwo.SetXYZM(
-                itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
-                itPart2->GetMomentum().Z(),
-                TDatabasePDG::Instance()->GetParticle(*itPDGPar2)->Mass());
-            float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
-            if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
-                                                 RelativeK, false, false)) {
-              continue;
-            }
-            RelativeK = HigherMath->FillMixedEvent(
-                HistCounter, iMult, cent, *itPart1, *itPDGPar1,
-                *itPart2, *itPDGPar2,
-                AliFemtoDreamCollConfig::kNone);
-			
-			HigherMath->MEMassQA(HistCounter, RelativeK, *itPart1, *itPart2);
-            HigherMath->MEDetaDPhiPlots(HistCounter, *itPart1, *itPDGPar1,
-                                        *itPart2, *itPDGPar2, RelativeK, false);
-            HigherMath->MEMomentumResolution(HistCounter, &(*itPart1),
-                                             *itPDGPar1, &(*itPart2),
-                                             *itPDGPar2, RelativeK);
-          }
+void AliFemtoDreamZVtxMultContainer::PairSpeciesSE(
+    std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+    AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent,
+    unsigned int iSpec1, unsigned int iSpec2, int HistCounter) {
+  std::vector<AliFemtoDreamBasePart> &Spec1 = Particles[iSpec1];
+  std::vector<AliFemtoDreamBasePart> &Spec2 = Particles[iSpec2];
+  const int PDGPar1 = fPDGParticleSpecies[iSpec1];
+  const int PDGPar2 = fPDGParticleSpecies[iSpec2];
+  const double MassPar1 = TDatabasePDG::Instance()->GetParticle(PDGPar1)->Mass();
+  const double MassPar2 = TDatabasePDG::Instance()->GetParticle(PDGPar2)->Mass();
+  HigherMath->FillPairCounterSE(HistCounter, Spec1.size(), Spec2.size());
+  //Now loop over the actual Particles and correlate them
+  for (auto itPart1 = Spec1.begin(); itPart1 != Spec1.end(); ++itPart1) {
+    std::vector<AliFemtoDreamBasePart>::iterator itPart2;
+    if (iSpec1 == iSpec2) {
+      itPart2 = itPart1 + 1;
+    } else {
+      itPart2 = Spec2.begin();
+    }
+    while (itPart2 != Spec2.end()) {
+      TLorentzVector PartOne, PartTwo;
+      PartOne.SetXYZM(itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
+                      itPart1->GetMomentum().Z(), MassPar1);
+      PartTwo.SetXYZM(itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
+                      itPart2->GetMomentum().Z(), MassPar2);
+      float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
+      if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
+                                           RelativeK, true, false)) {
+        ++itPart2;
+        continue;
+      }
+      RelativeK = HigherMath->FillSameEvent(HistCounter, iMult, cent,
+                                            *itPart1, PDGPar1,
+                                            *itPart2, PDGPar2);
+      HigherMath->MassQA(HistCounter, RelativeK, *itPart1, *itPart2);
+      HigherMath->SEDetaDPhiPlots(HistCounter, *itPart1, PDGPar1,
+                                  *itPart2, PDGPar2, RelativeK, false);
+      HigherMath->SEMomentumResolution(HistCounter, &(*itPart1), PDGPar1,
+                                       &(*itPart2), PDGPar2, RelativeK);
+      ++itPart2;
+    }
+  }
+}
+
+void AliFemtoDreamZVtxMultContainer::PairSpeciesME(
+    std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+    AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent,
+    unsigned int iSpec1, unsigned int iSpec2, int HistCounter) {
+  std::vector<AliFemtoDreamBasePart> &Spec1 = Particles[iSpec1];
+  AliFemtoDreamPartContainer &Spec2 = fPartContainer[iSpec2];
+  const int PDGPar1 = fPDGParticleSpecies[iSpec1];
+  const int PDGPar2 = fPDGParticleSpecies[iSpec2];
+  const double MassPar1 = TDatabasePDG::Instance()->GetParticle(PDGPar1)->Mass();
+  const double MassPar2 = TDatabasePDG::Instance()->GetParticle(PDGPar2)->Mass();
+  if (Spec1.size() > 0) {
+    HigherMath->FillEffectiveMixingDepth(HistCounter,
+                                         (int) Spec2.GetMixingDepth());
+  }
+  for (int iDepth = 0; iDepth < (int) Spec2.GetMixingDepth(); ++iDepth) {
+    std::vector<AliFemtoDreamBasePart> &ParticlesOfEvent = Spec2.GetEvent(
+        iDepth);
+    HigherMath->FillPairCounterME(HistCounter, Spec1.size(),
+                                  ParticlesOfEvent.size());
+    for (auto itPart1 = Spec1.begin(); itPart1 != Spec1.end(); ++itPart1) {
+      for (auto itPart2 = ParticlesOfEvent.begin();
+          itPart2 != ParticlesOfEvent.end(); ++itPart2) {
+        TLorentzVector PartOne, PartTwo;
+        PartOne.SetXYZM(itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
+                        itPart1->GetMomentum().Z(), MassPar1);
+        PartTwo.SetXYZM(itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
+                        itPart2->GetMomentum().Z(), MassPar2);
+        float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
+        if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
+                                             RelativeK, false, false)) {
+          continue;
         }
+        RelativeK = HigherMath->FillMixedEvent(
+            HistCounter, iMult, cent, *itPart1, PDGPar1,
+            *itPart2, PDGPar2,
+            AliFemtoDreamCollConfig::kNone);
+        HigherMath->MEMassQA(HistCounter, RelativeK, *itPart1, *itPart2);
+        HigherMath->MEDetaDPhiPlots(HistCounter, *itPart1, PDGPar1,
+                                    *itPart2, PDGPar2, RelativeK, false);
+        HigherMath->MEMomentumResolution(HistCounter, &(*itPart1),
+                                         PDGPar1, &(*itPart2),
+                                         PDGPar2, RelativeK);
       }
-      ++HistCounter;
-      ++itPDGPar2;
     }
-    ++itPDGPar1;
   }
 }
@@ -15,6 +15,10 @@
 #include "AliFemtoDreamPartContainer.h"
 #include "AliFemtoDreamHigherPairMath.h"
 
+namespace ROOT {
+class TThreadExecutor;
+}
+
 //Class containing the array buffer of the different particle species for one
 //Multiplicity bin
 class AliFemtoDreamZVtxMultContainer {
@@ -28,6 +32,10 @@ class AliFemtoDreamZVtxMultContainer {
   void PairParticlesME(
       std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
       AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent);
+  void PairParticles(
+      std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+      AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent,
+      ROOT::TThreadExecutor *executor);
   void DeltaEtaDeltaPhi(int Hist, AliFemtoDreamBasePart &part1,
                         AliFemtoDreamBasePart &part2, bool SEorME,
                         AliFemtoDreamCorrHists *ResultsHist, float relk);
@@ -41,6 +49,14 @@ class AliFemtoDreamZVtxMultContainer {
   }
   ;
  private:
+  void PairSpeciesSE(
+      std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+      AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent,
+      unsigned int iSpec1, unsigned int iSpec2, int HistCounter);
+  void PairSpeciesME(
+      std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+      AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent,
+      unsigned int iSpec1, unsigned int iSpec2, int HistCounter);
   std::vector<AliFemtoDreamPartContainer> fPartContainer;
   std::vector<int> fPDGParticleSpecies;
   std::vector<unsigned int> fWhichPairs;
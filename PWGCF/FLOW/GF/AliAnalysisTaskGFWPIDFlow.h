@@ -52,7 +52,7 @@ class AliAnalysisTaskGFWPIDFlow : public AliAnalysisTaskSE {
   void FillMeanPt(AliAODEvent*, Double_t vz, Double_t l_Cent);
   void FillCK(AliAODEvent *fAOD, Double_t vz, Double_t l_Cent);
   Int_t GetStageSwitch(TString instr);
-  AliGFW::CorrConfig GetConf(TString head, TString desc, Bool_t ptdif) { return fGFW->GetCorrelatorConfig(desc,head,ptdif);};
+  AliGFW::CorrConfig GetConf(TString head, TString desc, Bool_t ptdif) { AliGFW::CorrConfig conf = fGFW->GetCorrelatorConfig(desc,head,ptdif); fGFW->BuildPlan(conf); return conf; };
   void CreateCorrConfigs();
   void LoadWeightAndMPT(AliAODEvent*);
   void GetSingleWeightFromList(AliGFWWeights **inWeights, Int_t runno, TString pf="");
@@ -50,7 +50,7 @@ class AliAnalysisTaskMeanPtV2Corr : public AliAnalysisTaskSE {
   void ProduceALICEPublished_CovProd(AliAODEvent *fAOD, Double_t vz, Double_t l_Cent);
   void ProduceFBSpectra(AliAODEvent *fAOD, Double_t vz, Double_t l_Cent);
   Int_t GetStageSwitch(TString instr);
-  AliGFW::CorrConfig GetConf(TString head, TString desc, Bool_t ptdif) { return fGFW->GetCorrelatorConfig(desc,head,ptdif);};
+  AliGFW::CorrConfig GetConf(TString head, TString desc, Bool_t ptdif) { AliGFW::CorrConfig conf = fGFW->GetCorrelatorConfig(desc,head,ptdif); fGFW->BuildPlan(conf); return conf; };
   void CreateCorrConfigs();
   void LoadWeightAndMPT();
   void GetSingleWeightFromList(AliGFWWeights **inWeights, TString pf="");
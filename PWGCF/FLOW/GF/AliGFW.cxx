@@ -7,7 +7,8 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 need to add flags to have control over what is added, e.g. what happens, when I have several overlapping regions of different types: reference, pT-diff unID and pT-diff. ID?
 */
 AliGFW::AliGFW():
-  fInitialized(kFALSE)
+  fInitialized(kFALSE),
+  fFillStamp(1)
 {
 };
 
@@ -78,13 +79,13 @@ Int_t AliGFW::CreateRegions() {
   //for(auto pitr = fRegions.begin(); pitr!=fRegions.end(); pitr++) pitr->PrintStructure();
   Int_t nRegions=0;
   for(auto pItr=fRegions.begin(); pItr!=fRegions.end(); pItr++) {
-    AliGFWCumulant *lCumulant = new AliGFWCumulant();
+    AliGFWCumulant lCumulant;
     if(pItr->NparVec.size()) {
-      lCumulant->CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
+      lCumulant.CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
     } else {
-      lCumulant->CreateComplexVectorArray(pItr->Nhar, pItr->Npar, pItr->NpT);
+      lCumulant.CreateComplexVectorArray(pItr->Nhar, pItr->Npar, pItr->NpT);
     };
-    fCumulants.push_back(*lCumulant);
+    fCumulants.push_back(lCumulant);
     ++nRegions;
   };
   if(nRegions) fInitialized=kTRUE;
@@ -93,6 +94,7 @@ Int_t AliGFW::CreateRegions() {
 void AliGFW::Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t mask, Double_t SecondWeight) {
   if(!fInitialized) CreateRegions();
   if(!fInitialized) return;
+  ++fFillStamp;
   for(Int_t i=0;i<(Int_t)fRegions.size();++i) {
     if(fRegions.at(i).EtaMin<eta && fRegions.at(i).EtaMax>eta && (fRegions.at(i).BitMask&mask))
       fCumulants.at(i).FillArray(eta,ptin,phi,weight,SecondWeight);
@@ -135,6 +137,7 @@ void AliGFW::Clear() {
   for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs();
   fCalculatedNames.clear();
   fCalculatedQs.clear();
+  ++fFillStamp;
 };
 TComplex AliGFW::Calculate(TString config, Bool_t SetHarmsToZero) {
   if(config.EqualTo("")) {
@@ -270,6 +273,8 @@ TComplex AliGFW::Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin
   return RecursiveCorr(qpoi, qref, qovl, ptbin, hars);
 };
 TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
+  Int_t plan = corconf.Plans[(SetHarmsToZero?1:0)+(DisableOverlap?2:0)];
+  if(plan>-1) return CalculatePlan(plan,ptbin);
   if(corconf.Regs.size()==0) return TComplex(0,0);
   Int_t poi = corconf.Regs.at(0);
   Int_t ref = (corconf.Regs.size()>1)?corconf.Regs.at(1):corconf.Regs.at(0);
@@ -296,6 +301,110 @@ TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZer
   return retval;
 };
 
+void AliGFW::BuildPlan(CorrConfig &corconf) {
+  for(Int_t i=0;i<4;i++) corconf.Plans[i] = BuildPlan(corconf,i&1,i&2);
+};
+Int_t AliGFW::BuildPlan(const CorrConfig &corconf, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
+  //Same logic as Calculate(CorrConfig...), but on region indices, such that the recursion is only done once
+  if(corconf.Regs.size()==0 || corconf.Hars.size()==0) return -1;
+  if(corconf.Regs2.size() && corconf.Hars2.size()==0) return -1;
+  CorrPlan lPlan;
+  Int_t poi = corconf.Regs.at(0);
+  Int_t ref = (corconf.Regs.size()>1)?corconf.Regs.at(1):corconf.Regs.at(0);
+  Int_t ovl = -1;
+  if(corconf.Overlap1 > -1)
+    ovl = DisableOverlap?-1:corconf.Overlap1;
+  else if(ref==poi) ovl = ref;
+  vector<Int_t> hars = corconf.Hars;
+  if(SetHarmsToZero) std::fill(hars.begin(),hars.end(),0);
+  lPlan.Poi = poi;
+  lPlan.Root1 = AddPlanNode(poi, ref, ovl, hars);
+  if(corconf.Regs2.size()) {
+    poi = corconf.Regs2.at(0);
+    ref = (corconf.Regs2.size()>1)?corconf.Regs2.at(1):corconf.Regs2.at(0);
+    if(corconf.Overlap2 > -1)
+      ovl = DisableOverlap?-1:corconf.Overlap2;
+    else if(ref==poi) ovl = ref; //Otherwise the overlap of the first part is kept, as in Calculate(CorrConfig...)
+    hars = corconf.Hars2;
+    if(SetHarmsToZero) std::fill(hars.begin(),hars.end(),0);
+    lPlan.Root2 = AddPlanNode(poi, ref, ovl, hars);
+  };
+  fPlans.push_back(lPlan);
+  return (Int_t)fPlans.size()-1;
+};
+Int_t AliGFW::AddPlanNode(Int_t poi, Int_t ref, Int_t ol, vector<Int_t> hars, vector<Int_t> pows) {
+  //Mirrors RecursiveCorr. Nodes are shared between all correlators through fPlanNodeIndex
+  if(pows.size()==0)
+    for(Int_t i=0; i<(Int_t)hars.size(); i++)
+      pows.push_back(1);
+  if((pows.at(0)!=1) && ol>-1) poi=ol;
+  vector<Int_t> key = {poi, ref, ol, (Int_t)hars.size()};
+  key.insert(key.end(),hars.begin(),hars.end());
+  key.insert(key.end(),pows.begin(),pows.end());
+  auto found = fPlanNodeIndex.find(key);
+  if(found!=fPlanNodeIndex.end()) return found->second;
+  PlanNode lNode;
+  if(hars.size()<2) {
+    lNode.Type = kSingleNode;
+    lNode.Reg[0] = poi; lNode.Har[0] = hars.at(0); lNode.Pow[0] = pows.at(0);
+  } else if(hars.size()<3) {
+    lNode.Type = kTwoRecNode;
+    lNode.Reg[0] = poi; lNode.Reg[1] = ref; lNode.Reg[2] = ol;
+    lNode.Har[0] = hars.at(0); lNode.Har[1] = hars.at(1);
+    lNode.Pow[0] = pows.at(0); lNode.Pow[1] = pows.at(1);
+  } else {
+    lNode.Type = kProductNode;
+    Int_t harlast=hars.at(hars.size()-1);
+    Int_t powlast=pows.at(pows.size()-1);
+    hars.erase(hars.end()-1);
+    pows.erase(pows.end()-1);
+    lNode.Reg[1] = ref; lNode.Har[1] = harlast; lNode.Pow[1] = powlast;
+    lNode.Children.push_back(AddPlanNode(poi, ref, ol, hars, pows));
+    for(Int_t i=0;i<(Int_t)hars.size();i++) {
+      vector<Int_t> lhars = hars;
+      vector<Int_t> lpows = pows;
+      lhars.at(i)+=harlast;
+      lpows.at(i)+=powlast;
+      lNode.Children.push_back(AddPlanNode(poi, ref, ol, lhars, lpows));
+    };
+  };
+  fPlanNodes.push_back(lNode);
+  fNodeValue.push_back(0);
+  fNodeStamp.push_back(0);
+  fNodePt.push_back(0);
+  Int_t index = (Int_t)fPlanNodes.size()-1;
+  fPlanNodeIndex[key] = index;
+  return index;
+};
+std::complex<Double_t> AliGFW::EvaluateNode(Int_t node, Int_t ptbin) {
+  if(fNodeStamp[node]==fFillStamp && fNodePt[node]==ptbin) return fNodeValue[node];
+  const PlanNode &lNode = fPlanNodes[node];
+  std::complex<Double_t> val;
+  switch(lNode.Type) {
+    case kSingleNode:
+      val = fCumulants[lNode.Reg[0]].Q(lNode.Har[0],lNode.Pow[0],ptbin);
+      break;
+    case kTwoRecNode:
+      val = fCumulants[lNode.Reg[0]].Q(lNode.Har[0],lNode.Pow[0],ptbin)*fCumulants[lNode.Reg[1]].Q(lNode.Har[1],lNode.Pow[1],ptbin);
+      if(lNode.Reg[2]>-1) val -= fCumulants[lNode.Reg[2]].Q(lNode.Har[0]+lNode.Har[1],lNode.Pow[0]+lNode.Pow[1],ptbin);
+      break;
+    default:
+      val = EvaluateNode(lNode.Children[0],ptbin)*fCumulants[lNode.Reg[1]].Q(lNode.Har[1],lNode.Pow[1]); //reference always in the first pt bin, as in RecursiveCorr
+      for(Int_t i=1;i<(Int_t)lNode.Children.size();i++) val -= EvaluateNode(lNode.Children[i],ptbin);
+  };
+  fNodeValue[node] = val;
+  fNodeStamp[node] = fFillStamp;
+  fNodePt[node] = ptbin;
+  return val;
+};
+TComplex AliGFW::CalculatePlan(Int_t plan, Int_t ptbin) {
+  if(!fInitialized) return TComplex(0,0);
+  const CorrPlan &lPlan = fPlans.at(plan);
+  if(!fCumulants[lPlan.Poi].IsPtBinFilled(ptbin)) return TComplex(0,0);
+  std::complex<Double_t> retval = EvaluateNode(lPlan.Root1,ptbin);
+  if(lPlan.Root2>-1) retval*=EvaluateNode(lPlan.Root2,0);
+  return TComplex(retval.real(),retval.imag());
+};
 TComplex AliGFW::Calculate(Int_t poi, vector<Int_t> hars) {
   AliGFWCumulant *qpoi = &fCumulants.at(poi);
   return RecursiveCorr(qpoi, qpoi, qpoi, 0, hars);
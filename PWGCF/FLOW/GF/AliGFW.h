@@ -8,6 +8,8 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <complex>
+#include <map>
 #include "TString.h"
 #include "TObjArray.h"
 using std::vector;
@@ -46,7 +48,23 @@ class AliGFW {
     Int_t Overlap2=-1;
     Bool_t pTDif=kFALSE;
     TString Head="";
+    Int_t Plans[4] = {-1,-1,-1,-1}; //Compiled plans (see BuildPlan), indexed by SetHarmsToZero + 2*DisableOverlap
   };
+  //Correlator resolved to nodes of the recursion, evaluated without any string handling
+  struct CorrPlan {
+    Int_t Poi=-1;   //Region which has to have the pt bin filled
+    Int_t Root1=-1; //Node of the first (pt-differential) part
+    Int_t Root2=-1; //Node of the second part (evaluated for pt bin 0), -1 if none
+  };
+  //Node of the recursion: single Q-vector, two-particle term, or product with the reference minus the lower-order terms
+  struct PlanNode {
+    Int_t Type=0;
+    Int_t Reg[3] = {-1,-1,-1};
+    Int_t Har[2] = {0,0};
+    Int_t Pow[2] = {0,0};
+    vector<Int_t> Children {};
+  };
+  enum PlanNodeType { kSingleNode=0, kTwoRecNode=1, kProductNode=2 };
   AliGFW();
   ~AliGFW();
   vector<Region> fRegions;
@@ -61,6 +79,11 @@ class AliGFW {
   TComplex Calculate(TString config, Bool_t SetHarmsToZero=kFALSE);
   CorrConfig GetCorrelatorConfig(TString config, TString head = "", Bool_t ptdif=kFALSE);
   TComplex Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
+  //Resolve the regions, harmonics and powers of a correlator once (e.g. in UserCreateOutputObjects); Calculate(corconf,...) then uses the plans.
+  //Sub-products common to several correlators are shared and only calculated once per event and pt bin
+  void BuildPlan(CorrConfig &corconf);
+  Int_t BuildPlan(const CorrConfig &corconf, Bool_t SetHarmsToZero, Bool_t DisableOverlap);
+  TComplex CalculatePlan(Int_t plan, Int_t ptbin=0);
  private:
   Bool_t fInitialized;
   void SplitRegions();
@@ -81,6 +104,16 @@ class AliGFW {
   TComplex CalculateSingle(TString config);
 
   Bool_t SetHarmonicsToZero(TString &instr);
+  //Compiled correlators:
+  Int_t AddPlanNode(Int_t poi, Int_t ref, Int_t ol, vector<Int_t> hars, vector<Int_t> pows={});
+  std::complex<Double_t> EvaluateNode(Int_t node, Int_t ptbin);
+  vector<CorrPlan> fPlans; //!
+  vector<PlanNode> fPlanNodes; //!
+  std::map<vector<Int_t>, Int_t> fPlanNodeIndex; //! node of each (poi, ref, overlap, harmonics, powers)
+  vector<std::complex<Double_t> > fNodeValue; //! memoized value of each node
+  vector<ULong64_t> fNodeStamp; //! fill stamp at which the value was calculated
+  vector<Int_t> fNodePt; //! pt bin for which the value was calculated
+  ULong64_t fFillStamp; //! incremented whenever the Q-vectors change
 
 };
 #endif
@@ -8,6 +8,8 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 #include "TNamed.h"
 #include "TMath.h"
 #include "TAxis.h"
+#include <complex>
+#include <vector>
 using std::vector;
 class AliGFWCumulant {
  public:
@@ -20,15 +22,23 @@ class AliGFWCumulant {
   void Inc() { fNEntries++; };
   Int_t GetN() { return fNEntries; };
   // protected:
-  TComplex ***fQvector;
+  vector<std::complex<Double_t> > fQvector; //Q-vectors, flat array indexed by [pt][harmonic][power]
+  vector<Int_t> fPowOffset; //Offset of each harmonic within one pt bin
   UInt_t fUsed;
   Int_t fNEntries;
   //Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
   TComplex Vec(Int_t, Int_t, Int_t ptbin=0); //envelope class to summarize pt-dif. Q-vec getter
+  std::complex<Double_t> Q(Int_t n, Int_t p, Int_t ptbin=0) const { //Same as Vec, without conversion to TComplex
+    if(!fInitialized) return 0;
+    if(ptbin>=fPt || ptbin<0) ptbin=0;
+    if(n>=0) return fQvector[ptbin*fNQ+fPowOffset[n]+p];
+    return std::conj(fQvector[ptbin*fNQ+fPowOffset[-n]+p]);
+  };
   Int_t fN; //! Harmonics
   Int_t fPow; //! Power
   vector<Int_t> fPowVec; //! Powers array
   Int_t fPt; //!fPt bins
+  Int_t fNQ; //! Number of Q-vectors per pt bin
   Bool_t *fFilledPts;
   Bool_t fInitialized; //Arrays are initialized
   void CreateComplexVectorArray(Int_t N=1, Int_t P=1, Int_t Pt=1);
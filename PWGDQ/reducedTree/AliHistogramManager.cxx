@@ -49,7 +49,10 @@ AliHistogramManager::AliHistogramManager() :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(0)
+  fNVars(0),
+  fFillPlans(),
+  fFillPlanHandles(),
+  fFillPlansValid(kFALSE)
 {
   //
   // Constructor
@@ -71,7 +74,10 @@ AliHistogramManager::AliHistogramManager(const Char_t* name, Int_t nvars) :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(nvars)
+  fNVars(nvars),
+  fFillPlans(),
+  fFillPlanHandles(),
+  fFillPlansValid(kFALSE)
 {
   //
   // Constructor
@@ -131,6 +137,7 @@ void AliHistogramManager::AddHistClass(const Char_t* histClass) {
   hList->SetOwner(kTRUE);
   hList->SetName(histClass);
   fMainList.Add(hList);
+  fFillPlansValid = kFALSE;
 }
 
 //_________________________________________________________________
@@ -144,6 +151,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
   //
   // add a histogram
   //
+  fFillPlansValid = kFALSE;
   THashList* hList = (THashList*)fMainList.FindObject(histClass);
   if(!hList) {
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram list " << histClass << " not found!" << endl;
@@ -286,6 +294,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
   //
   // add a histogram
   //
+  fFillPlansValid = kFALSE;
   THashList* hList = (THashList*)fMainList.FindObject(histClass);
   if(!hList) {
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram list " << histClass << " not found!" << endl;
@@ -431,6 +440,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
   //
   // add a multi-dimensional histogram THnF or THnFSparseF
   //
+  fFillPlansValid = kFALSE;
   THashList* hList = (THashList*)fMainList.FindObject(histClass);
   if(!hList) {
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram list " << histClass << " not found!" << endl;
@@ -484,6 +494,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
   //
   // add a multi-dimensional histogram THnF or THnSparseF with equal or variable bin widths
   //
+  fFillPlansValid = kFALSE;
   THashList* hList = (THashList*)fMainList.FindObject(histClass);
   if(!hList) {
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram list " << histClass << " not found!" << endl;
@@ -630,141 +641,173 @@ void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values
     cout << "         Histogram list not filled" << endl; */
     return;
   }
+  if(!fFillPlansValid) BuildFillPlans();
+  FillHistClass(fFillPlanHandles[hList], values);
+}
+
+//__________________________________________________________________
+Int_t AliHistogramManager::GetHistClassHandle(const Char_t* className) {
+  //
+  //  get the integer handle of a histogram class, to be used in FillHistClass() instead of the class name
+  //  The handles stay valid when histograms or classes are added
+  //
+  THashList* hList = (THashList*)fMainList.FindObject(className);
   if(!hList) {
-    return;
+    cout << "Warning in AliHistogramManager::GetHistClassHandle(): Histogram list " << className << " not found!" << endl;
+    return -1;
   }
+  if(!fFillPlansValid) BuildFillPlans();
+  return fFillPlanHandles[hList];
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(Int_t classHandle, Float_t* values) {
+  //
+  //  fill a class of histograms using its handle
+  //
+  if(!fFillPlansValid) BuildFillPlans();
+  if(classHandle<0 || classHandle>=(Int_t)fFillPlans.size()) return;
+  const std::vector<FillPlanEntry>& plan = fFillPlans[classHandle];
+  for(UInt_t ih=0; ih<plan.size(); ++ih)
+    FillHistogram(plan[ih], values);
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(Int_t classHandle, Int_t nEntries, Float_t* values, Int_t stride) {
+  //
+  //  fill a class of histograms with nEntries value arrays (e.g. for all the tracks or pairs of an event),
+  //  the value array of entry i starts at values+i*stride
+  //  Each histogram is filled with the entries in the given order, as with one FillHistClass() call per entry
+  //
+  if(!fFillPlansValid) BuildFillPlans();
+  if(classHandle<0 || classHandle>=(Int_t)fFillPlans.size()) return;
+  const std::vector<FillPlanEntry>& plan = fFillPlans[classHandle];
+  for(UInt_t ih=0; ih<plan.size(); ++ih)
+    for(Int_t ie=0; ie<nEntries; ++ie)
+      FillHistogram(plan[ih], values+ie*stride);
+}
+
+//__________________________________________________________________
+void AliHistogramManager::BuildFillPlans() {
+  //
+  //  decode, for all the histogram classes, the type and the variables of the histograms
+  //  from the unique IDs of the histograms and axes
+  //  Histograms using a variable which is not flagged as used are not part of the plans
+  //
+  fFillPlans.clear();
+  fFillPlanHandles.clear();
+  fFillPlans.resize(fMainList.GetEntries());
+  for(Int_t iclass=0; iclass<fMainList.GetEntries(); ++iclass) {
+    THashList* hList = (THashList*)fMainList.At(iclass);
+    fFillPlanHandles[hList] = iclass;
+    std::vector<FillPlanEntry>& plan = fFillPlans[iclass];
     
-  TIter next(hList);
-  TObject* h=0x0;
-  Bool_t isProfile;
-  Bool_t isTHn;
-  Int_t thnDim=0;
-  Bool_t isSparse=kFALSE;
-  Double_t fillValues[20]={0.0};
-  Int_t uid = 0;
-  Int_t varX=-1, varY=-1, varZ=-1, varT=-1, varW=-1;
-  Int_t dimension=0;
-  while((h=next())) {
-    Bool_t allVarsGood = kTRUE;
-    uid = h->GetUniqueID();
-    isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
-    isTHn = ((uid%100)>10 ? kTRUE : kFALSE);      
-    if(isTHn) thnDim = (uid%100)-10;        // the excess over 10 from the last 2 digits give the dimension of the THn
-    if(isTHn && ((TString)h->ClassName()).Contains("Sparse")) isSparse = kTRUE;
-    dimension = 0;
-    if(!isTHn) dimension = ((TH1*)h)->GetDimension();
-        
-    uid = (uid-(uid%100))/100;
-    varX = -1;
-    varY = -1;
-    varZ = -1;
-    varT = -1;
-    varW = -1;
-    if(uid>0) {
-      varW = uid%(fNVars+1)-1;
-      if(varW==0) varW=AliReducedVarManager::kNothing;
-      uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
-      if(uid>0) varT = uid - 1;
-      //cout << "Filling " << h->GetName() << " with varT " << varT << endl;
-    }
-        
-    if(!isTHn) {
-      varX = ((TH1*)h)->GetXaxis()->GetUniqueID();
-      if(fUsedVars[varX]) {
-        switch(dimension) {
+    TIter next(hList);
+    TObject* h=0x0;
+    while((h=next())) {
+      FillPlanEntry entry;
+      entry.fHist = h;
+      entry.fNVars = 0;
+      Int_t uid = h->GetUniqueID();
+      Bool_t isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
+      Bool_t isTHn = ((uid%100)>10 ? kTRUE : kFALSE);
+      Int_t thnDim = 0;
+      if(isTHn) thnDim = (uid%100)-10;        // the excess over 10 from the last 2 digits give the dimension of the THn
+      
+      uid = (uid-(uid%100))/100;
+      Int_t varT = -1, varW = -1;
+      if(uid>0) {
+        varW = uid%(fNVars+1)-1;
+        if(varW==0) varW=AliReducedVarManager::kNothing;
+        uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
+        if(uid>0) varT = uid - 1;
+      }
+      if(varW>AliReducedVarManager::kNothing && !fUsedVars[varW]) continue;
+      entry.fVarW = (varW>AliReducedVarManager::kNothing ? varW : AliReducedVarManager::kNothing);
+      
+      Bool_t allVarsGood = kTRUE;
+      if(!isTHn) {
+        TH1* h1 = (TH1*)h;
+        entry.fVars[entry.fNVars++] = h1->GetXaxis()->GetUniqueID();
+        switch(h1->GetDimension()) {
           case 1:
-            if(isProfile) {
-              varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-              if(!fUsedVars[varY]) break;
-              if(varW>AliReducedVarManager::kNothing) { 
-                if(!fUsedVars[varW]) break;
-                ((TProfile*)h)->Fill(values[varX],values[varY],values[varW]);
-              }
-              else 
-                ((TProfile*)h)->Fill(values[varX],values[varY]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH1F*)h)->Fill(values[varX],values[varW]);
-              }
-              else
-                ((TH1F*)h)->Fill(values[varX]);
-            }
+            entry.fKind = (isProfile ? kTProfile : kTH1);
+            if(isProfile) entry.fVars[entry.fNVars++] = h1->GetYaxis()->GetUniqueID();
           break;
           case 2:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            if(isProfile) {
-              varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-              if(!fUsedVars[varZ]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ]);        
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH2F*)h)->Fill(values[varX],values[varY], values[varW]);
-              }
-              else
-                ((TH2F*)h)->Fill(values[varX],values[varY]);
-            }
+            entry.fKind = (isProfile ? kTProfile2D : kTH2);
+            entry.fVars[entry.fNVars++] = h1->GetYaxis()->GetUniqueID();
+            if(isProfile) entry.fVars[entry.fNVars++] = h1->GetZaxis()->GetUniqueID();
           break;
           case 3:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-            if(!fUsedVars[varZ]) break;
+            entry.fKind = (isProfile ? kTProfile3D : kTH3);
+            entry.fVars[entry.fNVars++] = h1->GetYaxis()->GetUniqueID();
+            entry.fVars[entry.fNVars++] = h1->GetZaxis()->GetUniqueID();
             if(isProfile) {
-              if(!fUsedVars[varT]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT],values[varW]);
-              }
-              else
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ]);
+              if(varT<0) allVarsGood = kFALSE;
+              else entry.fVars[entry.fNVars++] = varT;
             }
           break;
           default:
+            allVarsGood = kFALSE;
           break;
-        }  // end switch
-      }
-    }  // end if(!isTHn)
-    else {
-      for(Int_t idim=0;idim<thnDim;++idim) {
-        if (isSparse) {
-          allVarsGood &= fUsedVars[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-        } else {
-          allVarsGood &= fUsedVars[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
         }
       }
-      if(allVarsGood) {
-        if(varW>AliReducedVarManager::kNothing) {
-          if(fUsedVars[varW]) {
-            if (isSparse) ((THnSparseF*)h)->Fill(fillValues,values[varW]);
-            else          ((THnF*)h)->Fill(fillValues,values[varW]);
-          }
-        }
-        else {
-          if (isSparse) ((THnSparseF*)h)->Fill(fillValues);
-          else          ((THnF*)h)->Fill(fillValues);
-        }
+      else {
+        entry.fKind = kTHn;
+        for(Int_t idim=0;idim<thnDim;++idim)
+          entry.fVars[entry.fNVars++] = ((THnBase*)h)->GetAxis(idim)->GetUniqueID();
       }
+      for(Int_t ivar=0; ivar<entry.fNVars; ++ivar)
+        allVarsGood &= fUsedVars[entry.fVars[ivar]];
+      if(allVarsGood) plan.push_back(entry);
+    }
+  }
+  fFillPlansValid = kTRUE;
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistogram(const FillPlanEntry& entry, const Float_t* values) const {
+  //
+  //  fill one histogram according to its fill plan
+  //
+  const Int_t* vars = entry.fVars;
+  TObject* h = entry.fHist;
+  const Bool_t weighted = (entry.fVarW>AliReducedVarManager::kNothing);
+  switch(entry.fKind) {
+    case kTH1:
+      if(weighted) ((TH1F*)h)->Fill(values[vars[0]],values[entry.fVarW]);
+      else         ((TH1F*)h)->Fill(values[vars[0]]);
+    break;
+    case kTProfile:
+      if(weighted) ((TProfile*)h)->Fill(values[vars[0]],values[vars[1]],values[entry.fVarW]);
+      else         ((TProfile*)h)->Fill(values[vars[0]],values[vars[1]]);
+    break;
+    case kTH2:
+      if(weighted) ((TH2F*)h)->Fill(values[vars[0]],values[vars[1]],values[entry.fVarW]);
+      else         ((TH2F*)h)->Fill(values[vars[0]],values[vars[1]]);
+    break;
+    case kTProfile2D:
+      if(weighted) ((TProfile2D*)h)->Fill(values[vars[0]],values[vars[1]],values[vars[2]],values[entry.fVarW]);
+      else         ((TProfile2D*)h)->Fill(values[vars[0]],values[vars[1]],values[vars[2]]);
+    break;
+    case kTH3:
+      if(weighted) ((TH3F*)h)->Fill(values[vars[0]],values[vars[1]],values[vars[2]],values[entry.fVarW]);
+      else         ((TH3F*)h)->Fill(values[vars[0]],values[vars[1]],values[vars[2]]);
+    break;
+    case kTProfile3D:
+      if(weighted) ((TProfile3D*)h)->Fill(values[vars[0]],values[vars[1]],values[vars[2]],values[vars[3]],values[entry.fVarW]);
+      else         ((TProfile3D*)h)->Fill(values[vars[0]],values[vars[1]],values[vars[2]],values[vars[3]]);
+    break;
+    case kTHn: {
+      Double_t fillValues[20]={0.0};
+      for(Int_t idim=0;idim<entry.fNVars;++idim) fillValues[idim] = values[vars[idim]];
+      if(weighted) ((THnBase*)h)->Fill(fillValues,values[entry.fVarW]);
+      else         ((THnBase*)h)->Fill(fillValues);
     }
+    break;
+    default:
+    break;
   }
 }
 
@@ -8,6 +8,9 @@
 #ifndef ALIHISTOGRAMMANAGER_H
 #define ALIHISTOGRAMMANAGER_H
 
+#include <map>
+#include <vector>
+
 #include <TString.h>
 #include <TObject.h>
 #include <THn.h>
@@ -69,6 +72,9 @@ class AliHistogramManager : public TObject {
                         TAxis* axis);
   
   void FillHistClass(const Char_t* className, Float_t* values);
+  Int_t GetHistClassHandle(const Char_t* className);     // integer handle of a histogram class (-1 if it does not exist)
+  void FillHistClass(Int_t classHandle, Float_t* values);
+  void FillHistClass(Int_t classHandle, Int_t nEntries, Float_t* values, Int_t stride=AliReducedVarManager::kNVars);   // fill nEntries value arrays stored with a given stride
   
   void SetUseDefaultVariableNames(Bool_t flag) {fUseDefaultVariableNames = flag;};
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -106,9 +112,26 @@ class AliHistogramManager : public TObject {
   TString fVariableUnits[AliReducedVarManager::kNVars];               //! variable units
   Int_t fNVars;                          // maximum number of variables
   
+  // Fill plan of a histogram, decoded once from the unique IDs of the histogram and of its axes
+  enum EFillKind {
+    kTH1=0, kTProfile, kTH2, kTProfile2D, kTH3, kTProfile3D, kTHn
+  };
+  struct FillPlanEntry {
+    TObject* fHist;             // histogram
+    Int_t fKind;                // EFillKind
+    Int_t fNVars;               // number of filled variables (without weight)
+    Int_t fVars[20];            // filled variables
+    Int_t fVarW;                // weight variable (kNothing if not weighted)
+  };
+  std::vector<std::vector<FillPlanEntry> > fFillPlans;   //! fill plans of the histogram classes, indexed by class handle
+  std::map<const TObject*, Int_t> fFillPlanHandles;      //! class handle of each histogram list
+  Bool_t fFillPlansValid;                                //! the fill plans correspond to the current histograms
+
   void MakeAxisLabels(TAxis* ax, const Char_t* labels);
+  void BuildFillPlans();
+  void FillHistogram(const FillPlanEntry& entry, const Float_t* values) const;
   
-  ClassDef(AliHistogramManager, 4)
+  ClassDef(AliHistogramManager, 5)
 };
 
 #endif
@@ -356,7 +356,11 @@ AliAnalysisTaskGammaConvV1::AliAnalysisTaskGammaConvV1(): AliAnalysisTaskSE(),
   tBrokenFiles(NULL),
   fFileNameBroken(NULL),
   fFileWasAlreadyReported(kFALSE),
-  fAODMCTrackArray(NULL)
+  fAODMCTrackArray(NULL),
+  fMaxGammasForMesonStore(300),
+  fNGammasMesonStore(-1),
+  fMesonStore(),
+  fMesonStoreGammaIndex()
 {
 
 }
@@ -658,7 +662,11 @@ AliAnalysisTaskGammaConvV1::AliAnalysisTaskGammaConvV1(const char *name):
   tBrokenFiles(NULL),
   fFileNameBroken(NULL),
   fFileWasAlreadyReported(kFALSE),
-  fAODMCTrackArray(NULL)
+  fAODMCTrackArray(NULL),
+  fMaxGammasForMesonStore(300),
+  fNGammasMesonStore(-1),
+  fMesonStore(),
+  fMesonStoreGammaIndex()
 {
   // Define output slots here
   DefineOutput(1, TList::Class());
@@ -691,7 +699,7 @@ AliAnalysisTaskGammaConvV1::~AliAnalysisTaskGammaConvV1()
     delete[] fWeightCentrality;
     fWeightCentrality = 0x0;
   }
-
+  ClearMesonStore();
 }
 //___________________________________________________________
 void AliAnalysisTaskGammaConvV1::InitBack(){
@@ -2341,6 +2349,7 @@ void AliAnalysisTaskGammaConvV1::UserExec(Option_t *)
   }
 
   fReaderGammas = fV0Reader->GetReconstructedGammas(); // Gammas from default Cut
+  ClearMesonStore(); // meson candidates of the previous event
 
   // ------------------- BeginEvent ----------------------------
 
@@ -4074,6 +4083,7 @@ void AliAnalysisTaskGammaConvV1::CalculatePi0Candidates(){
     }
   }
   // Conversion Gammas
+  Bool_t useMesonStore = fGammaCandidates->GetEntries()>1 && InitMesonStore();
   if(fGammaCandidates->GetEntries()>1){
     for(Int_t firstGammaIndex=0;firstGammaIndex<fGammaCandidates->GetEntries()-1;firstGammaIndex++){
       AliAODConversionPhoton *gamma0=dynamic_cast<AliAODConversionPhoton*>(fGammaCandidates->At(firstGammaIndex));
@@ -4087,9 +4097,13 @@ void AliAnalysisTaskGammaConvV1::CalculatePi0Candidates(){
         gamma0->GetTrackLabelNegative() == gamma1->GetTrackLabelPositive() ||
         gamma0->GetTrackLabelPositive() == gamma1->GetTrackLabelNegative() ) continue;
 
-        AliAODConversionMother *pi0cand = new AliAODConversionMother(gamma0,gamma1);
+        AliAODConversionMother *pi0cand = useMesonStore ? GetStoredMesonCandidate(gamma0,gamma1) : NULL;
+        Bool_t ownsCandidate = (pi0cand == NULL);
+        if(ownsCandidate){
+          pi0cand = new AliAODConversionMother(gamma0,gamma1);
+          pi0cand->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
+        }
         pi0cand->SetLabels(firstGammaIndex,secondGammaIndex);
-        pi0cand->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
 
         if((fiMesonCut->MesonIsSelected(pi0cand,kTRUE,fiEventCut->GetEtaShift()))){
           if(fDoCentralityFlat > 0){
@@ -4350,13 +4364,56 @@ void AliAnalysisTaskGammaConvV1::CalculatePi0Candidates(){
             }
           }
         }
-        delete pi0cand;
+        if(ownsCandidate) delete pi0cand;
         pi0cand=0x0;
       }
     }
   }
 }
 
+//______________________________________________________________________
+Bool_t AliAnalysisTaskGammaConvV1::InitMesonStore(){
+  // The meson candidates of the reader photons are the same for all cuts of the
+  // wagon, they are built once per event and shared between the cuts
+  if(fnCuts < 2) return kFALSE;
+  // smeared momenta differ from cut to cut
+  if(fIsMC > 0 && fiMesonCut->UseMCPSmearing()) return kFALSE;
+  if(fNGammasMesonStore < 0){
+    Int_t nGammas = fReaderGammas->GetEntriesFast();
+    if(nGammas > fMaxGammasForMesonStore) return kFALSE;
+    fMesonStore.assign(nGammas*nGammas, NULL);
+    for(Int_t i = 0; i < nGammas; i++){
+      if(fReaderGammas->At(i)) fMesonStoreGammaIndex[fReaderGammas->At(i)] = i;
+    }
+    fNGammasMesonStore = nGammas;
+  }
+  return kTRUE;
+}
+
+//______________________________________________________________________
+AliAODConversionMother* AliAnalysisTaskGammaConvV1::GetStoredMesonCandidate(AliAODConversionPhoton *gamma0, AliAODConversionPhoton *gamma1){
+  // Returns the meson candidate of the two photons, built on first request in the
+  // event; NULL if the photons are not in the reader array
+  std::map<const TObject*,Int_t>::const_iterator index0 = fMesonStoreGammaIndex.find(gamma0);
+  std::map<const TObject*,Int_t>::const_iterator index1 = fMesonStoreGammaIndex.find(gamma1);
+  if(index0 == fMesonStoreGammaIndex.end() || index1 == fMesonStoreGammaIndex.end()) return NULL;
+  // the candidate depends on the order of the photons
+  AliAODConversionMother *&pi0cand = fMesonStore[index0->second*fNGammasMesonStore + index1->second];
+  if(!pi0cand){
+    pi0cand = new AliAODConversionMother(gamma0,gamma1);
+    pi0cand->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
+  }
+  return pi0cand;
+}
+
+//______________________________________________________________________
+void AliAnalysisTaskGammaConvV1::ClearMesonStore(){
+  for(size_t i = 0; i < fMesonStore.size(); i++) delete fMesonStore[i];
+  fMesonStore.clear();
+  fMesonStoreGammaIndex.clear();
+  fNGammasMesonStore = -1;
+}
+
 //______________________________________________________________________
 void AliAnalysisTaskGammaConvV1::ProcessTrueMesonCandidates(AliAODConversionMother *Pi0Candidate, AliAODConversionPhoton *TrueGammaCandidate0, AliAODConversionPhoton *TrueGammaCandidate1)
 {
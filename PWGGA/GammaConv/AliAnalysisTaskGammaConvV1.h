@@ -54,6 +54,9 @@ class AliAnalysisTaskGammaConvV1 : public AliAnalysisTaskSE {
     void ProcessJets();
     void ProcessPhotonsHighPtHadronAnalysis();
     void CalculatePi0Candidates();
+    Bool_t InitMesonStore();
+    AliAODConversionMother* GetStoredMesonCandidate(AliAODConversionPhoton *gamma0, AliAODConversionPhoton *gamma1);
+    void ClearMesonStore();
     void CalculateBackground();
     void CalculateBackgroundSwapp();
     void CalculateBackgroundRP();
@@ -77,6 +80,7 @@ class AliAnalysisTaskGammaConvV1 : public AliAnalysisTaskSE {
                                                                   fClusterCutArray              = CutArray  ;}
 
     void SetDoMaterialBudgetWeightingOfGammasForTrueMesons(Bool_t flag) {fDoMaterialBudgetWeightingOfGammasForTrueMesons = flag;}
+    void SetMaxGammasForMesonStore(Int_t max)                     { fMaxGammasForMesonStore     = max     ;}
 
     // BG HandlerSettings
     void SetMoveParticleAccordingToVertex(Bool_t flag)            {fMoveParticleAccordingToVertex = flag;}
@@ -407,12 +411,16 @@ class AliAnalysisTaskGammaConvV1 : public AliAnalysisTaskSE {
     TObjString*                       fFileNameBroken;                            // string object for broken file name
     Bool_t                            fFileWasAlreadyReported;                    // to store if the current file was already marked broken
     TClonesArray*                     fAODMCTrackArray;                           //! pointer to track array
+    Int_t                             fMaxGammasForMesonStore;                    // max number of reader photons for which the meson candidates are shared between the cuts
+    Int_t                             fNGammasMesonStore;                         //! number of reader photons in the meson candidate store, -1 if not filled for this event
+    std::vector<AliAODConversionMother*> fMesonStore;                             //! meson candidates of the reader photon pairs of the current event
+    std::map<const TObject*,Int_t>    fMesonStoreGammaIndex;                      //! index of the photons in the reader array
 
   private:
 
     AliAnalysisTaskGammaConvV1(const AliAnalysisTaskGammaConvV1&); // Prevent copy-construction
     AliAnalysisTaskGammaConvV1 &operator=(const AliAnalysisTaskGammaConvV1&); // Prevent assignment
-    ClassDef(AliAnalysisTaskGammaConvV1, 52);
+    ClassDef(AliAnalysisTaskGammaConvV1, 53);
 };
 
 #endif
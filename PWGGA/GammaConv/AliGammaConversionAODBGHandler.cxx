@@ -47,7 +47,9 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler() :
 	fBGEvents(),
 	fBGEventsENeg(),
 	fBGEventsMeson(),
-	fBGEventsMCParticle()
+	fBGEventsMCParticle(),
+	fBGEventsPool(),
+	fBGEventsPoolSize()
 {
 	// constructor
 }
@@ -70,7 +72,9 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler(Int_t binsZ,Int_t
 	fBGEvents(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
 	fBGEventsENeg(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
 	fBGEventsMeson(binsZ,AliGammaConversionMotherMultipicityVector(binsMultiplicity,AliGammaConversionMotherBGEventVector(nEvents))),
-	fBGEventsMCParticle(binsZ,AliGammaMCParticleMultipicityVector(binsMultiplicity,AliGammaMCParticleBGEventVector(nEvents)))
+	fBGEventsMCParticle(binsZ,AliGammaMCParticleMultipicityVector(binsMultiplicity,AliGammaMCParticleBGEventVector(nEvents))),
+	fBGEventsPool(),
+	fBGEventsPoolSize()
 {
 	// constructor
 }
@@ -95,7 +99,9 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler(Int_t collisionSy
 	fBGEvents(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
 	fBGEventsENeg(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
 	fBGEventsMeson(binsZ,AliGammaConversionMotherMultipicityVector(binsMultiplicity,AliGammaConversionMotherBGEventVector(nEvents))),
-	fBGEventsMCParticle(binsZ,AliGammaMCParticleMultipicityVector(binsMultiplicity,AliGammaMCParticleBGEventVector(nEvents)))
+	fBGEventsMCParticle(binsZ,AliGammaMCParticleMultipicityVector(binsMultiplicity,AliGammaMCParticleBGEventVector(nEvents))),
+	fBGEventsPool(),
+	fBGEventsPoolSize()
 {
 	// constructor
     if(fNBinsMultiplicity>5) fNBinsMultiplicity = 5;
@@ -400,7 +406,9 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler(const AliGammaCon
 	fBGEvents(original.fBGEvents),
 	fBGEventsENeg(original.fBGEventsENeg),
 	fBGEventsMeson(original.fBGEventsMeson),
-	fBGEventsMCParticle(original.fBGEventsMCParticle)
+	fBGEventsMCParticle(original.fBGEventsMCParticle),
+	fBGEventsPool(),
+	fBGEventsPoolSize()
 {
 	//copy constructor	
 }
@@ -472,6 +480,11 @@ AliGammaConversionAODBGHandler::~AliGammaConversionAODBGHandler(){
 	if(fBinLimitsArrayMultiplicity){
 		delete[] fBinLimitsArrayMultiplicity;
 	}
+
+	for(UInt_t i=0;i<fBGEventsPool.size();i++){
+		delete fBGEventsPool[i];
+	}
+	fBGEventsPool.clear();
 }
 
 //_____________________________________________________________________________________________________________________________
@@ -655,18 +668,33 @@ void AliGammaConversionAODBGHandler::AddEvent(TList* const eventGammas,Double_t
 	//  cout<<"Checking the entries: Z="<<z<<", M="<<m<<", eventCounter="<<eventCounter<<endl;
 
 	//  cout<<"The size of this vector is: "<<fBGEvents[z][m][eventCounter].size()<<endl;
-    for(UInt_t d=0;d<fBGEvents[z][m][eventCounter].size();d++){
-		delete (AliAODConversionPhoton*)(fBGEvents[z][m][eventCounter][d]);
-	}
+	// the photons of the replaced event are destroyed, their memory is reused for the new event
+	TClonesArray *pool = GetBGEventPool(z,m,eventCounter);
+	pool->Delete();
 	fBGEvents[z][m][eventCounter].clear();
 	
 	// add the gammas to the vector
 	for(Int_t i=0; i< eventGammas->GetEntries();i++){
 		//    AliKFParticle *t = new AliKFParticle(*(AliKFParticle*)(eventGammas->At(i)));
-		fBGEvents[z][m][eventCounter].push_back(new AliAODConversionPhoton(*(AliAODConversionPhoton*)(eventGammas->At(i))));
+		AliAODConversionPhoton *gamma = new((*pool)[i]) AliAODConversionPhoton(*(AliAODConversionPhoton*)(eventGammas->At(i)));
+		fBGEvents[z][m][eventCounter].push_back(gamma);
 	}
+	Int_t &poolSize = fBGEventsPoolSize[(z*fNBinsMultiplicity+m)*fNEvents+eventCounter];
+	if(eventGammas->GetEntries() > poolSize) poolSize = eventGammas->GetEntries();
 	fBGEventCounter[z][m]++;
 }
+
+//_____________________________________________________________________________________________________________________________
+TClonesArray* AliGammaConversionAODBGHandler::GetBGEventPool(Int_t z, Int_t m, Int_t event){
+	// storage of the photons of a buffered event, created on first use
+	if(fBGEventsPool.empty()){
+		fBGEventsPool.assign(fNBinsZ*fNBinsMultiplicity*fNEvents,NULL);
+		fBGEventsPoolSize.assign(fNBinsZ*fNBinsMultiplicity*fNEvents,0);
+	}
+	TClonesArray *&pool = fBGEventsPool[(z*fNBinsMultiplicity+m)*fNEvents+event];
+	if(!pool) pool = new TClonesArray("AliAODConversionPhoton",10);
+	return pool;
+}
 //_____________________________________________________________________________________________________________________________
 void AliGammaConversionAODBGHandler::AddMesonEvent(TList* const eventMothers, Double_t xvalue, Double_t yvalue, Double_t zvalue, Int_t multiplicity, Double_t epvalue){
 
@@ -819,6 +847,29 @@ AliGammaConversionAODVector* AliGammaConversionAODBGHandler::GetBGGoodENeg(Int_t
 	return &(fBGEventsENeg[z][m][event]);
 }
 
+//_____________________________________________________________________________________________________________________________
+void AliGammaConversionAODBGHandler::PrintMemoryUsage() const{
+	// prints for each z and multiplicity bin the number of buffered events and photons
+	// and the memory allocated for the photons of the buffered events
+	Long64_t totalBytes = 0;
+	cout<<"Memory usage of the photon buffer: "<<fNBinsZ<<" z bins x "<<fNBinsMultiplicity<<" multiplicity bins x "<<fNEvents<<" events"<<endl;
+	for(Int_t z=0;z<fNBinsZ;z++){
+		for(Int_t m=0;m<fNBinsMultiplicity;m++){
+			Int_t nEvents = 0, nPhotons = 0, nAllocated = 0;
+			for(Int_t event=0;event<fNEvents;event++){
+				Int_t nEventPhotons = fBGEvents[z][m][event].size();
+				if(nEventPhotons > 0) nEvents++;
+				nPhotons += nEventPhotons;
+				if(!fBGEventsPoolSize.empty()) nAllocated += fBGEventsPoolSize[(z*fNBinsMultiplicity+m)*fNEvents+event];
+			}
+			Long64_t bytes = (Long64_t)nAllocated*sizeof(AliAODConversionPhoton);
+			totalBytes += bytes;
+			cout<<"z bin "<<z<<", multiplicity bin "<<m<<": "<<nEvents<<" events, "<<nPhotons<<" photons, "<<nAllocated<<" photons allocated ("<<bytes/1024.<<" kB)"<<endl;
+		}
+	}
+	cout<<"Total: "<<totalBytes/1024.<<" kB"<<endl;
+}
+
 //_____________________________________________________________________________________________________________________________
 void AliGammaConversionAODBGHandler::PrintBGArray(){
 	//see headerfile for documentation
@@ -85,6 +85,7 @@ class AliGammaConversionAODBGHandler : public TObject {
 	AliGammaConversionAODVector* GetBGGoodENeg(Int_t event, Double_t zvalue, Int_t multiplicity);
 	
 	void PrintBGArray();
+	void PrintMemoryUsage() const;
 
 	GammaConversionVertex * GetBGEventVertex(Int_t zbin, Int_t mbin, Int_t event){return &fBGEventVertex[zbin][mbin][event];}
 
@@ -92,6 +93,8 @@ class AliGammaConversionAODBGHandler : public TObject {
 
 	private:
 
+		TClonesArray* GetBGEventPool(Int_t z, Int_t m, Int_t event);
+
 		Int_t 								fNEvents; 						// number of events
 		Int_t ** 							fBGEventCounter;				//! bg counter
 		Int_t ** 							fBGEventENegCounter;			//! bg electron counter
@@ -108,7 +111,9 @@ class AliGammaConversionAODBGHandler : public TObject {
 		AliGammaConversionBGVector 			fBGEventsENeg; 					// electron background electron events
 		AliGammaConversionMotherBGVector                fBGEventsMeson; 				// neutral meson background events
 		AliAODMCParticleBGVector 	                fBGEventsMCParticle; 				// MC Particle background events
+		std::vector<TClonesArray*> 			fBGEventsPool;					//! storage of the photons of each buffered event, reused when the event is replaced
+		std::vector<Int_t> 				fBGEventsPoolSize;				//! number of photons allocated in each storage
 		
-	ClassDef(AliGammaConversionAODBGHandler,8)
+	ClassDef(AliGammaConversionAODBGHandler,9)
 };
 #endif
@@ -2572,7 +2572,7 @@ Bool_t AliCaloPhotonCuts::ClusterQualityCuts(AliVCluster* cluster, AliVEvent *ev
         if ( classification == 6)
           fHistClusterTMEffiInput->Fill(cluster->E(), 20., weight); // El cl match
 
-        vector<Int_t> labelsMatchedTracks;
+        AliCaloTrackMatcher::MatchedIDs labelsMatchedTracks;
         if (fUsePtDepTrackToCluster == 0)
           labelsMatchedTracks           = fCaloTrackMatcher->GetMatchedTrackIDsForCluster(event, cluster->GetID(), fMaxDistTrackToClusterEta, -fMaxDistTrackToClusterEta,
                                                                                           fMaxDistTrackToClusterPhi, fMinDistTrackToClusterPhi);
@@ -2637,8 +2637,6 @@ Bool_t AliCaloPhotonCuts::ClusterQualityCuts(AliVCluster* cluster, AliVEvent *ev
           fHistClusterEvsTrackEGamma->Fill(cluster->E(), eMax, weight);
         if (classification == 3)
           fHistClusterEvsTrackEGammaSubCharged->Fill(cluster->E(), eMax, weight);
-
-        labelsMatchedTracks.clear();
       }
 
       return kFALSE;
@@ -9005,11 +9003,14 @@ std::vector<Int_t> AliCaloPhotonCuts::GetVectorMatchedTracksToCluster(AliVEvent*
   vector<Int_t> labelsMatched(0);
   if(!fUseDistTrackToCluster || fUseElectronClusterCalibration) return labelsMatched;
 
+  // the matcher returns a view on its own buffer, valid until the next query - copy it
+  AliCaloTrackMatcher::MatchedIDs matchedIDs;
   if (fUsePtDepTrackToCluster == 0)
-    labelsMatched = fCaloTrackMatcher->GetMatchedTrackIDsForCluster(event, cluster->GetID(), fMaxDistTrackToClusterEta, -fMaxDistTrackToClusterEta,
-                                                                    fMaxDistTrackToClusterPhi, fMinDistTrackToClusterPhi);
+    matchedIDs = fCaloTrackMatcher->GetMatchedTrackIDsForCluster(event, cluster->GetID(), fMaxDistTrackToClusterEta, -fMaxDistTrackToClusterEta,
+                                                                 fMaxDistTrackToClusterPhi, fMinDistTrackToClusterPhi);
   else if (fUsePtDepTrackToCluster == 1)
-    labelsMatched = fCaloTrackMatcher->GetMatchedTrackIDsForCluster(event, cluster->GetID(), fFuncPtDepEta, fFuncPtDepPhi);
+    matchedIDs = fCaloTrackMatcher->GetMatchedTrackIDsForCluster(event, cluster->GetID(), fFuncPtDepEta, fFuncPtDepPhi);
+  labelsMatched.assign(matchedIDs.begin(), matchedIDs.end());
 
   return labelsMatched;
 }
@@ -36,6 +36,7 @@
 #include "TH1F.h"
 #include "TF1.h"
 
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <utility>
@@ -65,6 +66,13 @@ AliCaloTrackMatcher::AliCaloTrackMatcher(const char *name, Int_t clusterType, In
   fNEntries(1),
   fVectorDeltaEtaDeltaPhi(0),
   fMap_TrID_ClID_ToIndex(),
+  fClusterTable(),
+  fTrackTable(),
+  fTrackIDToPosition(),
+  fTrackIDToPositionBuilt(kFALSE),
+  fWindowColumns(),
+  fWindowColumnIndex(),
+  fQueryBuffer(),
   fSecMapTrackToCluster(),
   fSecMapClusterToTrack(),
   fSecNEntries(1),
@@ -74,7 +82,9 @@ AliCaloTrackMatcher::AliCaloTrackMatcher(const char *name, Int_t clusterType, In
   fListHistos(NULL),
   fHistControlMatches(NULL),
   fSecHistControlMatches(NULL),
-  fDoLightOutput(kFALSE)
+  fHistCheckMatchTables(NULL),
+  fDoLightOutput(kFALSE),
+  fCheckMatchTables(kFALSE)
 {
     // Default constructor
     DefineInput(0, TChain::Class());
@@ -90,6 +100,8 @@ AliCaloTrackMatcher::~AliCaloTrackMatcher(){
     fMapClusterToTrack.clear();
     fVectorDeltaEtaDeltaPhi.clear();
     fMap_TrID_ClID_ToIndex.clear();
+    fClusterTable.Clear();
+    fTrackTable.Clear();
 
     fSecMapTrackToCluster.clear();
     fSecMapClusterToTrack.clear();
@@ -112,6 +124,11 @@ void AliCaloTrackMatcher::Terminate(Option_t *){
   fMapClusterToTrack.clear();
   fVectorDeltaEtaDeltaPhi.clear();
   fMap_TrID_ClID_ToIndex.clear();
+  fClusterTable.Clear();
+  fTrackTable.Clear();
+  fTrackIDToPosition.clear();
+  fWindowColumns.clear();
+  fWindowColumnIndex.clear();
 
   fSecMapTrackToCluster.clear();
   fSecMapClusterToTrack.clear();
@@ -136,6 +153,12 @@ void AliCaloTrackMatcher::UserCreateOutputObjects(){
     else
       fListHistos->SetName(Form("CaloTrackMatcher_%i_%i_%s",fClusterType,fRunningMode,fCorrTaskSetting.Data()));
   }
+  if(fCheckMatchTables){
+    fHistCheckMatchTables = new TH1F(Form("CheckMatchTables_%i_%i",fClusterType,fRunningMode),Form("CheckMatchTables_%i_%i",fClusterType,fRunningMode),2,-0.5,1.5);
+    fHistCheckMatchTables->GetXaxis()->SetBinLabel(1,"same as multimap scan");
+    fHistCheckMatchTables->GetXaxis()->SetBinLabel(2,"mismatch");
+    fListHistos->Add(fHistCheckMatchTables);
+  }
   if(fDoLightOutput) return;
 
   // Create User Output Objects
@@ -172,6 +195,11 @@ void AliCaloTrackMatcher::Initialize(Int_t runNumber){
   fNEntries = 1;
   fVectorDeltaEtaDeltaPhi.clear();
   fMap_TrID_ClID_ToIndex.clear();
+  fClusterTable.Clear();
+  fTrackTable.Clear();
+  fTrackIDToPositionBuilt = kFALSE;
+  fWindowColumns.clear();
+  fWindowColumnIndex.clear();
 
   fSecMapTrackToCluster.clear();
   fSecMapClusterToTrack.clear();
@@ -515,6 +543,7 @@ void AliCaloTrackMatcher::ProcessEvent(AliVEvent *event){
     delete trackParam;
   }
 
+  BuildMatchTables(event);
   return;
 }
 
@@ -747,7 +776,9 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
 //________________________________________________________________________
 //________________________________________________________________________
 Bool_t AliCaloTrackMatcher::GetTrackClusterMatchingResidual(Int_t trackID, Int_t clusterID, Float_t &dEta, Float_t &dPhi){
-  Int_t position = fMap_TrID_ClID_ToIndex[make_pair(trackID,clusterID)];
+  mapT::const_iterator it = fMap_TrID_ClID_ToIndex.find(make_pair(trackID,clusterID));
+  if(it == fMap_TrID_ClID_ToIndex.end()) return kFALSE;
+  Int_t position = it->second;
   if(position == 0) return kFALSE;
 
   pairFloat tempEtaPhi = fVectorDeltaEtaDeltaPhi.at(position-1);
@@ -756,340 +787,348 @@ Bool_t AliCaloTrackMatcher::GetTrackClusterMatchingResidual(Int_t trackID, Int_t
   return kTRUE;
 }
 //________________________________________________________________________
-Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
-  Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
-        }else if(tempTrack->Charge()<0){
-          dPhiMin*=-1;
-          dPhiMax*=-1;
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin > tempDPhi) && (tempDPhi > dPhiMax) ) matched++;
-        }
-      }
-    }
-  }
-
-  return matched;
+Int_t AliCaloTrackMatcher::MatchTable::FindRow(Int_t key) const{
+  vector<Int_t>::const_iterator it = lower_bound(fKeys.begin(), fKeys.end(), key);
+  if(it == fKeys.end() || *it != key) return -1;
+  return it - fKeys.begin();
 }
 
 //________________________________________________________________________
-Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
-  Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
+void AliCaloTrackMatcher::BuildMatchTables(AliVEvent *event){
+  // flatten fMapClusterToTrack and fMapTrackToCluster into CSR tables, resolving the residuals
+  // and the track pT/charge once per event instead of in every query
+  fClusterTable.Clear();
+  fTrackTable.Clear();
 
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
-
-        if (match_dPhi && match_dEta )matched++;
-      }
+  multimap<Int_t,Int_t>::const_iterator it;
+  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
+    if(!tempTrack) continue;
+    MatchEntry entry;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,entry.fDEta,entry.fDPhi)) continue;
+    entry.fID     = it->second;
+    entry.fPt     = tempTrack->Pt();
+    entry.fCharge = tempTrack->Charge();
+    if(fClusterTable.fKeys.empty() || fClusterTable.fKeys.back() != it->first){
+      fClusterTable.fKeys.push_back(it->first);
+      fClusterTable.fStart.push_back(fClusterTable.fEntries.size());
     }
+    fClusterTable.fEntries.push_back(entry);
   }
-  return matched;
-}
+  fClusterTable.fStart.push_back(fClusterTable.fEntries.size());
 
-//________________________________________________________________________
-Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dR){
-  Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
+  Bool_t firstRow = kTRUE;
+  Int_t lastTrackPos = -1;
+  AliVTrack* rowTrack = NULL;
+  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
+    if(firstRow || it->first != lastTrackPos){
+      firstRow = kFALSE;
+      lastTrackPos = it->first;
+      rowTrack = dynamic_cast<AliVTrack*>(event->GetTrack(it->first));
+      if(rowTrack){
+        fTrackTable.fKeys.push_back(it->first);
+        fTrackTable.fStart.push_back(fTrackTable.fEntries.size());
       }
     }
+    if(!rowTrack) continue;
+    MatchEntry entry;
+    if(!GetTrackClusterMatchingResidual(rowTrack->GetID(),it->second,entry.fDEta,entry.fDPhi)) continue;
+    entry.fID     = it->second;
+    entry.fPt     = rowTrack->Pt();
+    entry.fCharge = rowTrack->Charge();
+    fTrackTable.fEntries.push_back(entry);
   }
-  return matched;
+  fTrackTable.fStart.push_back(fTrackTable.fEntries.size());
 }
 
 //________________________________________________________________________
-Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
+Int_t AliCaloTrackMatcher::GetTrackPosition(AliVEvent *event, Int_t trackID){
+  if(event->IsA()!=AliAODEvent::Class()) return trackID; // for ESD just take trackID
 
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
+  // for AOD, we have to look for position of track in the event, the lookup table is filled at the first query
+  if(!fTrackIDToPositionBuilt){
+    fTrackIDToPosition.clear();
     for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
       AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
+      if(currTrack) fTrackIDToPosition.push_back(make_pair(currTrack->GetID(),iTrack));
     }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+    // sorted by ID and then by position, so that the first track with a given ID is found
+    sort(fTrackIDToPosition.begin(), fTrackIDToPosition.end());
+    fTrackIDToPositionBuilt = kTRUE;
+  }
+  vector<pairInt>::const_iterator it = lower_bound(fTrackIDToPosition.begin(), fTrackIDToPosition.end(), make_pair(trackID,-1));
+  if(it == fTrackIDToPosition.end() || it->first != trackID)
+    AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
+  return it->second;
+}
 
-  Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
-  if(!tempTrack) return matched;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
-        }else if(tempTrack->Charge()<0){
-          dPhiMin*=-1;
-          dPhiMax*=-1;
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin > tempDPhi) && (tempDPhi > dPhiMax) ) matched++;
+//________________________________________________________________________
+Int_t AliCaloTrackMatcher::GetWindowColumn(TF1* func, Int_t table){
+  Int_t index = -1;
+  map<TF1*,Int_t>::const_iterator it = fWindowColumnIndex.find(func);
+  if(it != fWindowColumnIndex.end()){
+    index = it->second;
+  }else{
+    // identical functions of different cut instances share the same column
+    TString signature = func->GetExpFormula();
+    if(signature.Length() > 0){
+      for(Int_t i = 0; i < func->GetNpar(); i++) signature += Form(";%a",func->GetParameter(i));
+      for(UInt_t i = 0; i < fWindowColumns.size(); i++){
+        if(fWindowColumns[i].fSignature == signature){
+          index = i;
+          break;
         }
       }
     }
+    if(index < 0){
+      WindowColumn column;
+      column.fFunction  = func;
+      column.fSignature = signature;
+      column.fFilled[0] = kFALSE;
+      column.fFilled[1] = kFALSE;
+      fWindowColumns.push_back(column);
+      index = fWindowColumns.size() - 1;
+    }
+    fWindowColumnIndex[func] = index;
   }
-  return matched;
+
+  WindowColumn &column = fWindowColumns[index];
+  if(!column.fFilled[table]){
+    const vector<MatchEntry> &entries = (table == 0) ? fClusterTable.fEntries : fTrackTable.fEntries;
+    column.fValues[table].resize(entries.size());
+    for(UInt_t i = 0; i < entries.size(); i++) column.fValues[table][i] = column.fFunction->Eval(entries[i].fPt);
+    column.fFilled[table] = kTRUE;
+  }
+  return index;
 }
 
 //________________________________________________________________________
-Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
-
+Int_t AliCaloTrackMatcher::SelectWindow(const MatchTable &table, Int_t row, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin, vector<Int_t>* ids) const{
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
-  if(!tempTrack) return matched;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
-
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
-
-        if (match_dPhi && match_dEta )matched++;
-
-      }
+  if(row < 0) return matched;
+  for (Int_t i = table.fStart[row]; i < table.fStart[row+1]; i++){
+    const MatchEntry &entry = table.fEntries[i];
+    Bool_t match = kFALSE;
+    if(entry.fCharge>0){
+      if( (dEtaMin < entry.fDEta) && (entry.fDEta < dEtaMax) && (dPhiMin < entry.fDPhi) && (entry.fDPhi < dPhiMax) ) match = kTRUE;
+    }else if(entry.fCharge<0){
+      // the phi window is mirrored in place for every negative track, as it always was
+      dPhiMin*=-1;
+      dPhiMax*=-1;
+      if( (dEtaMin < entry.fDEta) && (entry.fDEta < dEtaMax) && (dPhiMin > entry.fDPhi) && (entry.fDPhi > dPhiMax) ) match = kTRUE;
     }
+    if(!match) continue;
+    matched++;
+    if(ids) ids->push_back(entry.fID);
   }
   return matched;
 }
 
 //________________________________________________________________________
-Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dR){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+Int_t AliCaloTrackMatcher::SelectPtDep(const MatchTable &table, Int_t row, const vector<Double_t> &windowEta, const vector<Double_t> &windowPhi, vector<Int_t>* ids) const{
+  Int_t matched = 0;
+  if(row < 0) return matched;
+  for (Int_t i = table.fStart[row]; i < table.fStart[row+1]; i++){
+    const MatchEntry &entry = table.fEntries[i];
+    Bool_t match_dEta = TMath::Abs(entry.fDEta) < windowEta[i];
+    Bool_t match_dPhi = TMath::Abs(entry.fDPhi) < windowPhi[i];
+    if(!(match_dPhi && match_dEta)) continue;
+    matched++;
+    if(ids) ids->push_back(entry.fID);
+  }
+  return matched;
+}
 
+//________________________________________________________________________
+Int_t AliCaloTrackMatcher::SelectDR(const MatchTable &table, Int_t row, Float_t dR, vector<Int_t>* ids) const{
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
-  if(!tempTrack) return matched;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
-      }
-    }
+  if(row < 0) return matched;
+  for (Int_t i = table.fStart[row]; i < table.fStart[row+1]; i++){
+    const MatchEntry &entry = table.fEntries[i];
+    if(!(TMath::Sqrt(entry.fDEta*entry.fDEta + entry.fDPhi*entry.fDPhi) < dR)) continue;
+    matched++;
+    if(ids) ids->push_back(entry.fID);
   }
   return matched;
 }
 
 //________________________________________________________________________
-vector<Int_t> AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
-  vector<Int_t> tempMatchedTracks;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedTracks.push_back(it->second);
-        }else if(tempTrack->Charge()<0){
-          dPhiMin*=-1;
-          dPhiMax*=-1;
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin > tempDPhi) && (tempDPhi > dPhiMax) ) tempMatchedTracks.push_back(it->second);
+Int_t AliCaloTrackMatcher::ReferenceSelection(AliVEvent *event, Int_t key, Bool_t trackQuery, QueryWindow window, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin, TF1* funcEta, TF1* funcPhi, Float_t dR, vector<Int_t> &ids){
+  // selection as done by the primary-track queries before the adjacency tables: scan of the whole
+  // multimap, residual map lookup and window evaluation for every entry
+  ids.clear();
+  AliVTrack* rowTrack = NULL;
+  if(trackQuery){
+    Int_t TrackPos = -1;
+    if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
+      for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
+        AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
+        if(currTrack && currTrack->GetID() == key){
+          TrackPos = iTrack;
+          break;
         }
       }
+      if(TrackPos == -1) return 0;
+    }else TrackPos = key; // for ESD just take trackID
+    rowTrack = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
+    if(!rowTrack) return 0;
+    key = TrackPos;
+  }
+
+  const multimap<Int_t,Int_t> &matchMap = trackQuery ? fMapTrackToCluster : fMapClusterToTrack;
+  multimap<Int_t,Int_t>::const_iterator it;
+  for (it=matchMap.begin(); it!=matchMap.end(); ++it){
+    if(it->first != key) continue;
+    AliVTrack* tempTrack = trackQuery ? rowTrack : dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
+    if(!tempTrack) continue;
+    Int_t clusterID = trackQuery ? it->second : it->first;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),clusterID,tempDEta,tempDPhi)) continue;
+    Bool_t match = kFALSE;
+    if(window == kQueryWindow){
+      if(tempTrack->Charge()>0){
+        match = (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax);
+      }else if(tempTrack->Charge()<0){
+        dPhiMin*=-1;
+        dPhiMax*=-1;
+        match = (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin > tempDPhi) && (tempDPhi > dPhiMax);
+      }
+    }else if(window == kQueryPtDep){
+      match = (TMath::Abs(tempDEta) < funcEta->Eval(tempTrack->Pt())) && (TMath::Abs(tempDPhi) < funcPhi->Eval(tempTrack->Pt()));
+    }else{
+      match = TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR;
     }
+    if(match) ids.push_back(it->second);
   }
-  return tempMatchedTracks;
+  return ids.size();
 }
 
 //________________________________________________________________________
-vector<Int_t> AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID,  TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
-  vector<Int_t> tempMatchedTracks;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
-
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
+void AliCaloTrackMatcher::CheckQuery(const char* query, AliVEvent *event, Int_t key, Bool_t trackQuery, QueryWindow window, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin, TF1* funcEta, TF1* funcPhi, Float_t dR, Int_t matched, const vector<Int_t>* ids){
+  vector<Int_t> reference;
+  ReferenceSelection(event, key, trackQuery, window, dEtaMax, dEtaMin, dPhiMax, dPhiMin, funcEta, funcPhi, dR, reference);
+  Bool_t agree = (matched == (Int_t)reference.size());
+  if(agree && ids) agree = (*ids == reference);
+  if(fHistCheckMatchTables) fHistCheckMatchTables->Fill(agree ? 0. : 1.);
+  if(!agree) AliError(Form("AliCaloTrackMatcher: %s for ID %i - %i matches from the tables, %i from the multimap scan",query,key,matched,(Int_t)reference.size()));
+}
 
-        if (match_dPhi && match_dEta )tempMatchedTracks.push_back(it->second);
+//________________________________________________________________________
+Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
+  Int_t matched = SelectWindow(fClusterTable, fClusterTable.FindRow(clusterID), dEtaMax, dEtaMin, dPhiMax, dPhiMin, NULL);
+  if(fCheckMatchTables) CheckQuery("GetNMatchedTrackIDsForCluster", event, clusterID, kFALSE, kQueryWindow, dEtaMax, dEtaMin, dPhiMax, dPhiMin, NULL, NULL, 0, matched, NULL);
+  return matched;
+}
 
-      }
-    }
+//________________________________________________________________________
+Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
+  Int_t matched = 0;
+  Int_t row = fClusterTable.FindRow(clusterID);
+  if(row >= 0){
+    Int_t columnEta = GetWindowColumn(fFuncPtDepEta, 0);
+    Int_t columnPhi = GetWindowColumn(fFuncPtDepPhi, 0);
+    matched = SelectPtDep(fClusterTable, row, fWindowColumns[columnEta].fValues[0], fWindowColumns[columnPhi].fValues[0], NULL);
   }
-  return tempMatchedTracks;
+  if(fCheckMatchTables) CheckQuery("GetNMatchedTrackIDsForCluster", event, clusterID, kFALSE, kQueryPtDep, 0, 0, 0, 0, fFuncPtDepEta, fFuncPtDepPhi, 0, matched, NULL);
+  return matched;
 }
 
 //________________________________________________________________________
-vector<Int_t> AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID,  Float_t dR){
-  vector<Int_t> tempMatchedTracks;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedTracks.push_back(it->second);
-      }
-    }
-  }
-  return tempMatchedTracks;
+Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dR){
+  Int_t matched = SelectDR(fClusterTable, fClusterTable.FindRow(clusterID), dR, NULL);
+  if(fCheckMatchTables) CheckQuery("GetNMatchedTrackIDsForCluster", event, clusterID, kFALSE, kQueryDR, 0, 0, 0, 0, NULL, NULL, dR, matched, NULL);
+  return matched;
 }
 
 //________________________________________________________________________
-vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
+  Int_t TrackPos = GetTrackPosition(event, trackID);
+  Int_t matched = SelectWindow(fTrackTable, fTrackTable.FindRow(TrackPos), dEtaMax, dEtaMin, dPhiMax, dPhiMin, NULL);
+  if(fCheckMatchTables) CheckQuery("GetNMatchedClusterIDsForTrack", event, trackID, kTRUE, kQueryWindow, dEtaMax, dEtaMin, dPhiMax, dPhiMin, NULL, NULL, 0, matched, NULL);
+  return matched;
+}
 
-  vector<Int_t> tempMatchedClusters;
-  multimap<Int_t,Int_t>::iterator it;
-  AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
-  if(!tempTrack) return tempMatchedClusters;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedClusters.push_back(it->second);
-        }else if(tempTrack->Charge()<0){
-          dPhiMin*=-1;
-          dPhiMax*=-1;
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin > tempDPhi) && (tempDPhi > dPhiMax) ) tempMatchedClusters.push_back(it->second);
-        }
-      }
-    }
+//________________________________________________________________________
+Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
+  Int_t TrackPos = GetTrackPosition(event, trackID);
+  Int_t matched = 0;
+  Int_t row = fTrackTable.FindRow(TrackPos);
+  if(row >= 0){
+    Int_t columnEta = GetWindowColumn(fFuncPtDepEta, 1);
+    Int_t columnPhi = GetWindowColumn(fFuncPtDepPhi, 1);
+    matched = SelectPtDep(fTrackTable, row, fWindowColumns[columnEta].fValues[1], fWindowColumns[columnPhi].fValues[1], NULL);
   }
-
-  return tempMatchedClusters;
+  if(fCheckMatchTables) CheckQuery("GetNMatchedClusterIDsForTrack", event, trackID, kTRUE, kQueryPtDep, 0, 0, 0, 0, fFuncPtDepEta, fFuncPtDepPhi, 0, matched, NULL);
+  return matched;
 }
 
 //________________________________________________________________________
-vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
-
-  vector<Int_t> tempMatchedClusters;
-  multimap<Int_t,Int_t>::iterator it;
-  AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
-  if(!tempTrack) return tempMatchedClusters;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
+Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dR){
+  Int_t TrackPos = GetTrackPosition(event, trackID);
+  Int_t matched = SelectDR(fTrackTable, fTrackTable.FindRow(TrackPos), dR, NULL);
+  if(fCheckMatchTables) CheckQuery("GetNMatchedClusterIDsForTrack", event, trackID, kTRUE, kQueryDR, 0, 0, 0, 0, NULL, NULL, dR, matched, NULL);
+  return matched;
+}
 
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
+//________________________________________________________________________
+AliCaloTrackMatcher::MatchedIDs AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
+  fQueryBuffer.clear();
+  SelectWindow(fClusterTable, fClusterTable.FindRow(clusterID), dEtaMax, dEtaMin, dPhiMax, dPhiMin, &fQueryBuffer);
+  if(fCheckMatchTables) CheckQuery("GetMatchedTrackIDsForCluster", event, clusterID, kFALSE, kQueryWindow, dEtaMax, dEtaMin, dPhiMax, dPhiMin, NULL, NULL, 0, fQueryBuffer.size(), &fQueryBuffer);
+  return MatchedIDs(fQueryBuffer.data(), fQueryBuffer.size());
+}
 
-        if (match_dPhi && match_dEta )tempMatchedClusters.push_back(it->second);
-      }
-    }
+//________________________________________________________________________
+AliCaloTrackMatcher::MatchedIDs AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID,  TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
+  fQueryBuffer.clear();
+  Int_t row = fClusterTable.FindRow(clusterID);
+  if(row >= 0){
+    Int_t columnEta = GetWindowColumn(fFuncPtDepEta, 0);
+    Int_t columnPhi = GetWindowColumn(fFuncPtDepPhi, 0);
+    SelectPtDep(fClusterTable, row, fWindowColumns[columnEta].fValues[0], fWindowColumns[columnPhi].fValues[0], &fQueryBuffer);
   }
-  return tempMatchedClusters;
+  if(fCheckMatchTables) CheckQuery("GetMatchedTrackIDsForCluster", event, clusterID, kFALSE, kQueryPtDep, 0, 0, 0, 0, fFuncPtDepEta, fFuncPtDepPhi, 0, fQueryBuffer.size(), &fQueryBuffer);
+  return MatchedIDs(fQueryBuffer.data(), fQueryBuffer.size());
 }
 
 //________________________________________________________________________
-vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dR){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+AliCaloTrackMatcher::MatchedIDs AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID,  Float_t dR){
+  fQueryBuffer.clear();
+  SelectDR(fClusterTable, fClusterTable.FindRow(clusterID), dR, &fQueryBuffer);
+  if(fCheckMatchTables) CheckQuery("GetMatchedTrackIDsForCluster", event, clusterID, kFALSE, kQueryDR, 0, 0, 0, 0, NULL, NULL, dR, fQueryBuffer.size(), &fQueryBuffer);
+  return MatchedIDs(fQueryBuffer.data(), fQueryBuffer.size());
+}
 
-  vector<Int_t> tempMatchedClusters;
-  multimap<Int_t,Int_t>::iterator it;
-  AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
-  if(!tempTrack) return tempMatchedClusters;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedClusters.push_back(it->second);
-      }
-    }
+//________________________________________________________________________
+AliCaloTrackMatcher::MatchedIDs AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
+  Int_t TrackPos = GetTrackPosition(event, trackID);
+  fQueryBuffer.clear();
+  SelectWindow(fTrackTable, fTrackTable.FindRow(TrackPos), dEtaMax, dEtaMin, dPhiMax, dPhiMin, &fQueryBuffer);
+  if(fCheckMatchTables) CheckQuery("GetMatchedClusterIDsForTrack", event, trackID, kTRUE, kQueryWindow, dEtaMax, dEtaMin, dPhiMax, dPhiMin, NULL, NULL, 0, fQueryBuffer.size(), &fQueryBuffer);
+  return MatchedIDs(fQueryBuffer.data(), fQueryBuffer.size());
+}
+
+//________________________________________________________________________
+AliCaloTrackMatcher::MatchedIDs AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
+  Int_t TrackPos = GetTrackPosition(event, trackID);
+  fQueryBuffer.clear();
+  Int_t row = fTrackTable.FindRow(TrackPos);
+  if(row >= 0){
+    Int_t columnEta = GetWindowColumn(fFuncPtDepEta, 1);
+    Int_t columnPhi = GetWindowColumn(fFuncPtDepPhi, 1);
+    SelectPtDep(fTrackTable, row, fWindowColumns[columnEta].fValues[1], fWindowColumns[columnPhi].fValues[1], &fQueryBuffer);
   }
-  return tempMatchedClusters;
+  if(fCheckMatchTables) CheckQuery("GetMatchedClusterIDsForTrack", event, trackID, kTRUE, kQueryPtDep, 0, 0, 0, 0, fFuncPtDepEta, fFuncPtDepPhi, 0, fQueryBuffer.size(), &fQueryBuffer);
+  return MatchedIDs(fQueryBuffer.data(), fQueryBuffer.size());
+}
+
+//________________________________________________________________________
+AliCaloTrackMatcher::MatchedIDs AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dR){
+  Int_t TrackPos = GetTrackPosition(event, trackID);
+  fQueryBuffer.clear();
+  SelectDR(fTrackTable, fTrackTable.FindRow(TrackPos), dR, &fQueryBuffer);
+  if(fCheckMatchTables) CheckQuery("GetMatchedClusterIDsForTrack", event, trackID, kTRUE, kQueryDR, 0, 0, 0, 0, NULL, NULL, dR, fQueryBuffer.size(), &fQueryBuffer);
+  return MatchedIDs(fQueryBuffer.data(), fQueryBuffer.size());
 }
 
 //________________________________________________________________________
@@ -1460,7 +1499,7 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForSecTrack(AliVEvent *ev
 //________________________________________________________________________
 Float_t AliCaloTrackMatcher::SumTrackEtAroundCluster(AliVEvent* event, Int_t clusterID, Float_t dR){
   Float_t sumTrackEt = 0.;
-  vector<Int_t> labelsMatched = GetMatchedTrackIDsForCluster(event, clusterID, dR);
+  MatchedIDs labelsMatched = GetMatchedTrackIDsForCluster(event, clusterID, dR);
   if((Int_t) labelsMatched.size()<1) return sumTrackEt;
 
   TLorentzVector vecTrack;
@@ -1559,7 +1598,7 @@ void AliCaloTrackMatcher::DebugMatching(){
     cout << "mapClusterToTrack" << endl;
     Int_t tempClus = it->second;
     for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it) cout << it->first << " => " << it->second << '\n';
-    vector<Int_t> tempTracks = GetMatchedTrackIDsForCluster(fInputEvent,tempClus, 5, -5, 0.2, -0.4);
+    MatchedIDs tempTracks = GetMatchedTrackIDsForCluster(fInputEvent,tempClus, 5, -5, 0.2, -0.4);
     for(UInt_t iJ=0; iJ<tempTracks.size();iJ++){
       cout << tempClus << " - " << tempTracks.at(iJ) << endl;
     }
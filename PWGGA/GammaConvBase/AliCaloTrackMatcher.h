@@ -9,12 +9,29 @@
 #include <utility>
 
 class TF1;
+class TH1F;
 
 using namespace std;
 
 class AliCaloTrackMatcher : public AliAnalysisTaskSE {
 
   public:
+    // non-owning view on the track positions/cluster IDs selected by a query, the buffer belongs
+    // to the matcher and stays valid until the next GetMatched...IDsFor... call or the next event
+    class MatchedIDs {
+      public:
+        MatchedIDs(const Int_t* data = NULL, UInt_t size = 0) : fData(data), fSize(size) {}
+        const Int_t* begin() const              { return fData; }
+        const Int_t* end() const                { return fData + fSize; }
+        UInt_t size() const                     { return fSize; }
+        Bool_t empty() const                    { return fSize == 0; }
+        Int_t operator[](UInt_t i) const        { return fData[i]; }
+        Int_t at(UInt_t i) const                { return fData[i]; }
+      private:
+        const Int_t* fData;
+        UInt_t fSize;
+    };
+
     AliCaloTrackMatcher(const char *name="CaloTrackMatcher_0_0", Int_t clusterType = 0, Int_t runningMode = 0);
     //Uncopyable & operator=(const Uncopyable&);
 
@@ -31,6 +48,9 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
     void SetAnalysisTrainMode(TString mode){fAnalysisTrainMode = mode; return;}
     void SetMatchingResidual(Float_t res) {fMatchingResidual = res; return;}
     void SetMatchingWindow(Float_t win) {fMatchingWindow = win; return;}
+    // validation only: every primary-track query is repeated with the scan of the track <-> cluster
+    // multimaps it replaced and the outcome is counted in CheckMatchTables, mismatches are reported
+    void SetCheckMatchTables(Bool_t flag) {fCheckMatchTables = flag; return;}
 
     // for cluster <-> primary matching
     Bool_t GetTrackClusterMatchingResidual(Int_t trackID, Int_t clusterID, Float_t &dEta, Float_t &dPhi);
@@ -43,13 +63,17 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
     Int_t GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi);
     Int_t GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dR);
 
-    vector<Int_t> GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin);
-    vector<Int_t> GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi);
-    vector<Int_t> GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dR);
+    // The MatchedIDs returned by the following methods do not own the IDs: they point to a buffer of
+    // the matcher, which is overwritten by the next GetMatchedTrackIDsForCluster or
+    // GetMatchedClusterIDsForTrack call (from any task using this matcher) and is released with the
+    // matcher. Copy the IDs, e.g. vector<Int_t>(ids.begin(), ids.end()), to keep them longer.
+    MatchedIDs    GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin);
+    MatchedIDs    GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi);
+    MatchedIDs    GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dR);
 
-    vector<Int_t> GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi);
-    vector<Int_t> GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin);
-    vector<Int_t> GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dR);
+    MatchedIDs    GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi);
+    MatchedIDs    GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin);
+    MatchedIDs    GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dR);
 
     // for cluster <-> V0-track matching
     Bool_t PropagateV0TrackToClusterAndGetMatchingResidual(AliVTrack* inSecTrack, AliVCluster* cluster, AliVEvent* event, Float_t &dEta, Float_t &dPhi);
@@ -83,6 +107,30 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
     typedef pair<Float_t, Float_t> pairFloat;
     typedef map<pairInt, Int_t> mapT;
 
+    // entry of the per-event track <-> cluster adjacency tables
+    struct MatchEntry {
+      Int_t    fID;                                // track position (cluster table) or cluster ID (track table)
+      Float_t  fDEta;                              // matching residual in eta
+      Float_t  fDPhi;                              // matching residual in phi
+      Double_t fPt;                                // pT of the track
+      Short_t  fCharge;                            // charge of the track
+    };
+    // adjacency table in CSR layout: the entries of fKeys[i] are fEntries[fStart[i]..fStart[i+1])
+    struct MatchTable {
+      vector<Int_t>      fKeys;                    // sorted cluster IDs or track positions
+      vector<Int_t>      fStart;                   // first entry of each key, plus end marker
+      vector<MatchEntry> fEntries;                 // matched partners in the order of the multimaps
+      void Clear() { fKeys.clear(); fStart.clear(); fEntries.clear(); }
+      Int_t FindRow(Int_t key) const;
+    };
+    // pT-dependent matching window tabulated for the entries of both tables
+    struct WindowColumn {
+      TF1*             fFunction;                  // first function with this signature in the event
+      TString          fSignature;                 // formula and parameters, empty if not comparable
+      vector<Double_t> fValues[2];                 // window for each entry of the cluster (0) and track (1) table
+      Bool_t           fFilled[2];                 // whether fValues[i] has been computed
+    };
+
     AliCaloTrackMatcher (const AliCaloTrackMatcher&); // not implemented
     AliCaloTrackMatcher & operator=(const AliCaloTrackMatcher&); // not implemented
 
@@ -91,6 +139,19 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
     void ProcessEvent(AliVEvent *event);
     void SetLogBinningYTH2(TH2* histoRebin);
 
+    // adjacency tables
+    void BuildMatchTables(AliVEvent *event);
+    Int_t GetTrackPosition(AliVEvent *event, Int_t trackID);
+    Int_t GetWindowColumn(TF1* func, Int_t table);
+    Int_t SelectWindow(const MatchTable &table, Int_t row, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin, vector<Int_t>* ids) const;
+    Int_t SelectPtDep(const MatchTable &table, Int_t row, const vector<Double_t> &windowEta, const vector<Double_t> &windowPhi, vector<Int_t>* ids) const;
+    Int_t SelectDR(const MatchTable &table, Int_t row, Float_t dR, vector<Int_t>* ids) const;
+
+    // check of the table queries against the multimap scan (SetCheckMatchTables)
+    enum QueryWindow { kQueryWindow, kQueryPtDep, kQueryDR };
+    Int_t ReferenceSelection(AliVEvent *event, Int_t key, Bool_t trackQuery, QueryWindow window, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin, TF1* funcEta, TF1* funcPhi, Float_t dR, vector<Int_t> &ids);
+    void CheckQuery(const char* query, AliVEvent *event, Int_t key, Bool_t trackQuery, QueryWindow window, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin, TF1* funcEta, TF1* funcPhi, Float_t dR, Int_t matched, const vector<Int_t>* ids);
+
     // debug methods
     void DebugMatching();
     void DebugV0Matching();
@@ -124,6 +185,14 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
     vector<pairFloat>     fVectorDeltaEtaDeltaPhi; //! vector of all matching residuals for a specific TrackID/ClusterID
     mapT                  fMap_TrID_ClID_ToIndex;  //! map tuple of (trackID,clusterID) to index in vector fVectorDeltaEtaDeltaPhi
 
+    MatchTable            fClusterTable;           //! cluster ID -> matched tracks with residuals, built once per event
+    MatchTable            fTrackTable;             //! track position -> matched clusters with residuals, built once per event
+    vector<pairInt>       fTrackIDToPosition;      //! (track ID, position) sorted by ID, AOD only, built at the first track query
+    Bool_t                fTrackIDToPositionBuilt; //! whether fTrackIDToPosition is up to date
+    vector<WindowColumn>  fWindowColumns;          //! tabulated pT-dependent windows of the current event
+    map<TF1*, Int_t>      fWindowColumnIndex;      //! window function -> index in fWindowColumns
+    vector<Int_t>         fQueryBuffer;            //! storage of the IDs returned by the last query
+
     // for cluster <-> V0-track matching (running with different mass hypthesis)
     multimap<Int_t,Int_t> fSecMapTrackToCluster;      //! connects a given secondary track ID with all associated cluster IDs
     multimap<Int_t,Int_t> fSecMapClusterToTrack;      //! connects a given cluster ID with all associated secondary track IDs
@@ -137,10 +206,12 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
     TList*                fListHistos;             //! list with histogram(s)
     TH2F*                 fHistControlMatches;     //! bookkeeping for processed tracks/clusters and succesful matches
     TH2F*                 fSecHistControlMatches;  //! bookkeeping for processed V0-tracks/clusters and succesful matches
+    TH1F*                 fHistCheckMatchTables;   //! queries agreeing (0) or not (1) with the multimap scan
 
     Bool_t                fDoLightOutput;          // switch for running light output, kFALSE -> normal mode, kTRUE -> light mode
+    Bool_t                fCheckMatchTables;       // switch for comparing the table queries with the multimap scan
 
-    ClassDef(AliCaloTrackMatcher,8)
+    ClassDef(AliCaloTrackMatcher,10)
 };
 
 #endif
@@ -161,7 +161,12 @@ fMassLambdaC(0.),
 fMassDstar(0.),
 fMassJpsi(0.),
 fMassPhi(0.),
-fMassK(0.)
+fMassK(0.),
+fMaxTracksForPairDCACache(5000),
+fNTracksPairDCA(0),
+fPairDCAIndex(),
+fPairDCAStatus(),
+fPairDCAValues()
 {
   /// Default constructor
 
@@ -260,7 +265,12 @@ fMassLambdaC(source.fMassLambdaC),
 fMassDstar(source.fMassDstar),
 fMassJpsi(source.fMassJpsi),
 fMassPhi(source.fMassPhi),
-fMassK(source.fMassK)
+fMassK(source.fMassK),
+fMaxTracksForPairDCACache(source.fMaxTracksForPairDCACache),
+fNTracksPairDCA(0),
+fPairDCAIndex(),
+fPairDCAStatus(),
+fPairDCAValues()
 {
   ///
   /// Copy constructor
@@ -356,6 +366,7 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
   fMassJpsi = source.fMassJpsi;
   fMassPhi = source.fMassPhi;
   fMassK = source.fMassK;
+  fMaxTracksForPairDCACache = source.fMaxTracksForPairDCACache;
 
   return *this;
 }
@@ -628,6 +639,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
   AliDebug(1,Form(" Selected tracks: %d",nSeleTrks));
   fnSeleTrksTotal += nSeleTrks;
+  InitPairDCACache(nSeleTrks,seleFlags);
 
 
   TObjArray *twoTrackArray1    = new TObjArray(2);
@@ -876,7 +888,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       negtrack1->GetPxPyPz(momneg1);
 
       // DCA between the two tracks
-      dcap1n1 = postrack1->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+      dcap1n1 = GetPairDCA(postrack1,iTrkP1,negtrack1,iTrkN1,dcaMax);
       if(dcap1n1>dcaMax) { negtrack1=0; continue; }
 
       // Vertexing
@@ -1139,9 +1151,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
 	//printf("********** %d %d %d\n",postrack1->GetID(),postrack2->GetID(),negtrack1->GetID());
 
-	dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+	dcap2n1 = GetPairDCA(postrack2,iTrkP2,negtrack1,iTrkN1,dcaMax);
 	if(dcap2n1>dcaMax) { postrack2=0; continue; }
-	dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
+	dcap1p2 = GetPairDCA(postrack2,iTrkP2,postrack1,iTrkP1,dcaMax);
 	if(dcap1p2>dcaMax) { postrack2=0; continue; }
 
 	// check invariant mass cuts for D+,Ds,Lc
@@ -1277,9 +1289,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
 	    SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
 
-	    dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	    dcap1n2 = GetPairDCA(postrack1,iTrkP1,negtrack2,iTrkN2,dcaMax);
 	    if(dcap1n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
-            dcap2n2 = postrack2->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+            dcap2n2 = GetPairDCA(postrack2,iTrkP2,negtrack2,iTrkN2,dcaMax);
             if(dcap2n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
 
 
@@ -1410,9 +1422,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
 	//printf("********** %d %d %d\n",postrack1->GetID(),negtrack1->GetID(),negtrack2->GetID());
 
-	dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	dcap1n2 = GetPairDCA(postrack1,iTrkP1,negtrack2,iTrkN2,dcaMax);
 	if(dcap1n2>dcaMax) { negtrack2=0; continue; }
-	dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	dcan1n2 = GetPairDCA(negtrack1,iTrkN1,negtrack2,iTrkN2,dcaMax);
 	if(dcan1n2>dcaMax) { negtrack2=0; continue; }
 
 	threeTrackArray->AddAt(negtrack1,0);
@@ -3775,6 +3787,50 @@ void AliAnalysisVertexingHF::SetParametersAtVertex(AliESDtrack* esdt, const AliE
   return;
 }
 //-----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::InitPairDCACache(Int_t nSeleTrks,const UChar_t *seleFlags){
+  /// Reset the cache of the DCAs between displaced tracks for a new event.
+  /// All the track pairs of the 2, 3 and 4 prong loops are formed with
+  /// displaced tracks whose parameters have been set back to the primary
+  /// vertex: the DCA of a given ordered pair is the same for all the
+  /// combinations in which it appears.
+
+  fNTracksPairDCA=0;
+  fPairDCAValues.clear();
+  fPairDCAIndex.assign(nSeleTrks,-1);
+  for(Int_t iTrk=0; iTrk<nSeleTrks; iTrk++) {
+    if(TESTBIT(seleFlags[iTrk],kBitDispl)) fPairDCAIndex[iTrk]=fNTracksPairDCA++;
+  }
+  if(fNTracksPairDCA>fMaxTracksForPairDCACache) {
+    AliDebug(1,Form(" %d displaced tracks, no cache of the pair DCAs",fNTracksPairDCA));
+    fNTracksPairDCA=0;
+    return;
+  }
+  fPairDCAStatus.assign(fNTracksPairDCA*fNTracksPairDCA,kPairDCAUnknown);
+}
+//-----------------------------------------------------------------------------
+Double_t AliAnalysisVertexingHF::GetPairDCA(AliESDtrack *trk1,Int_t iTrk1,AliESDtrack *trk2,Int_t iTrk2,Double_t dcaMax){
+  /// DCA between two selected tracks (trk1->GetDCA(trk2)) with their
+  /// parameters at the primary vertex, taken from the cache if it was already
+  /// computed in this event. Only the values below dcaMax are kept: for the
+  /// pairs above the cut a value above dcaMax is returned.
+
+  Double_t xdummy,ydummy;
+  if(fNTracksPairDCA==0 || fPairDCAIndex[iTrk1]<0 || fPairDCAIndex[iTrk2]<0) return trk1->GetDCA(trk2,fBzkG,xdummy,ydummy);
+
+  Int_t iPair=fPairDCAIndex[iTrk1]*fNTracksPairDCA+fPairDCAIndex[iTrk2];
+  if(fPairDCAStatus[iPair]==kPairDCAAboveCut) return kVeryBig;
+  if(fPairDCAStatus[iPair]==kPairDCAStored) return fPairDCAValues[iPair];
+
+  Double_t dca=trk1->GetDCA(trk2,fBzkG,xdummy,ydummy);
+  if(dca>dcaMax) {
+    fPairDCAStatus[iPair]=kPairDCAAboveCut;
+  } else {
+    fPairDCAStatus[iPair]=kPairDCAStored;
+    fPairDCAValues[iPair]=dca;
+  }
+  return dca;
+}
+//-----------------------------------------------------------------------------
 void AliAnalysisVertexingHF::SetMasses(){
   /// Set the hadron mass values from TDatabasePDG
 
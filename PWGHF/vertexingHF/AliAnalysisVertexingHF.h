@@ -13,6 +13,9 @@
 /// \author Contact: andrea.dainese@pd.infn.it
 //-------------------------------------------------------------------------
 
+#include <vector>
+#include <map>
+
 #include <TNamed.h>
 #include <TList.h>
 
@@ -179,6 +182,10 @@ class AliAnalysisVertexingHF : public TNamed {
   void SetCutsDStartoKpipi(AliRDHFCutsDStartoKpipi* cuts) { fCutsDStartoKpipi = cuts; }
   AliRDHFCutsDStartoKpipi* GetCutsDStartoKpipi() const { return fCutsDStartoKpipi; }
   void SetMassCutBeforeVertexing(Bool_t flag) { fMassCutBeforeVertexing=flag; }
+  /// the DCA of each pair of displaced tracks is computed once per event
+  /// if there are at most maxTracks displaced tracks (0 = always recompute)
+  void SetMaxTracksForPairDCACache(Int_t maxTracks) { fMaxTracksForPairDCACache=maxTracks; }
+  Int_t GetMaxTracksForPairDCACache() const { return fMaxTracksForPairDCACache; }
 
   void SetMasses();
   Bool_t CheckCutsConsistency();
@@ -250,6 +257,7 @@ class AliAnalysisVertexingHF : public TNamed {
  private:
   //
   enum { kBitDispl = 0, kBitSoftPi = 1, kBit3Prong = 2, kBitPionCompat = 3, kBitKaonCompat = 4, kBitProtonCompat = 5, kBitBachelor = 6};
+  enum { kPairDCAUnknown = 0, kPairDCAAboveCut = 1, kPairDCAStored = 2 };
 
   Bool_t fInputAOD; /// input from AOD (kTRUE) or ESD (kFALSE)
   Int_t fAODMapSize; /// size of fAODMap
@@ -355,6 +363,12 @@ class AliAnalysisVertexingHF : public TNamed {
   Double_t fMassPhi;
   Double_t fMassK;
 
+  Int_t fMaxTracksForPairDCACache; /// max. number of displaced tracks for the cache of the pair DCAs
+  Int_t fNTracksPairDCA; //! number of displaced tracks in the cache of the pair DCAs (0 = no cache)
+  std::vector<Int_t> fPairDCAIndex; //! index in the cache of the pair DCAs for each selected track (-1 = not displaced)
+  std::vector<UChar_t> fPairDCAStatus; //! status of each ordered pair of displaced tracks (kPairDCA*)
+  std::map<Int_t,Double_t> fPairDCAValues; //! DCA of the pairs below the DCA cut
+
   //
   void AddRefs(AliAODVertex *v,AliAODRecoDecayHF *rd,const AliVEvent *event,
 	       const TObjArray *trkArray) const;
@@ -420,6 +434,8 @@ class AliAnalysisVertexingHF : public TNamed {
 				   Int_t &nSeleTrks,
 				   UChar_t *seleFlags,Int_t *evtNumber);
   void SetParametersAtVertex(AliESDtrack* esdt, const AliExternalTrackParam* extpar) const;
+  void InitPairDCACache(Int_t nSeleTrks,const UChar_t *seleFlags);
+  Double_t GetPairDCA(AliESDtrack *trk1,Int_t iTrk1,AliESDtrack *trk2,Int_t iTrk2,Double_t dcaMax);
 
   Bool_t SingleTrkCuts(AliESDtrack *trk,Float_t centralityperc, Bool_t &okDisplaced,Bool_t &okSoftPi, Bool_t &ok3prong, Bool_t &okBachelor) const;
 
@@ -429,7 +445,7 @@ class AliAnalysisVertexingHF : public TNamed {
 				  TObjArray *twoTrackArrayV0);
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisVertexingHF,30);  // Reconstruction of HF decay candidates
+  ClassDef(AliAnalysisVertexingHF,31);  // Reconstruction of HF decay candidates
   /// \endcond
 };
 
@@ -13,6 +13,9 @@
 // Developers: F. Bellini (fbellini@cern.ch)
 
 #include <Riostream.h>
+#include <algorithm>
+#include <list>
+#include <map>
 
 #include <TH1.h>
 #include <TList.h>
@@ -54,6 +57,57 @@
 
 ClassImp(AliRsnMiniAnalysisTask)
 
+namespace {
+   /// Bounded cache of the mini-events read from the event buffer during mixing.
+   /// When the cache is full, the least recently used event is replaced.
+   class AliRsnMiniEventCache {
+   public:
+      AliRsnMiniEventCache(TTree *buffer, AliRsnMiniEvent **cursor, Int_t size) :
+         fBuffer(buffer), fCursor(cursor), fSize(size), fOrder(), fEvents() {}
+      ~AliRsnMiniEventCache() {
+         for (std::map<Int_t, Slot>::iterator it = fEvents.begin(); it != fEvents.end(); ++it) delete it->second.fEvent;
+      }
+
+      AliRsnMiniEvent *Get(Int_t entry) {
+         if (fSize <= 0) {
+            fBuffer->GetEntry(entry);
+            return *fCursor;
+         }
+         std::map<Int_t, Slot>::iterator it = fEvents.find(entry);
+         if (it != fEvents.end()) {
+            fOrder.splice(fOrder.begin(), fOrder, it->second.fOrder);
+            return it->second.fEvent;
+         }
+         AliRsnMiniEvent *event = 0x0;
+         if ((Int_t)fEvents.size() >= fSize) {
+            std::map<Int_t, Slot>::iterator last = fEvents.find(fOrder.back());
+            event = last->second.fEvent;
+            fEvents.erase(last);
+            fOrder.pop_back();
+         } else {
+            event = new AliRsnMiniEvent();
+         }
+         fBuffer->GetEntry(entry);
+         *event = **fCursor;
+         fOrder.push_front(entry);
+         Slot slot = {event, fOrder.begin()};
+         fEvents[entry] = slot;
+         return event;
+      }
+
+   private:
+      struct Slot {
+         AliRsnMiniEvent          *fEvent;  // copy of the buffered event
+         std::list<Int_t>::iterator fOrder; // position in the use order
+      };
+      TTree            *fBuffer;  // event buffer
+      AliRsnMiniEvent **fCursor;  // event the buffer is read into
+      Int_t             fSize;    // maximum number of cached events
+      std::list<Int_t>  fOrder;   // cached entries, most recently used first
+      std::map<Int_t, Slot> fEvents; // cached events
+   };
+}
+
 //__________________________________________________________________________________________________
 /// Default constructor
 AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask() :
@@ -99,6 +153,7 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask() :
    fMiniEvent(0x0),
    fBigOutput(kFALSE),
    fMixPrintRefresh(-1),
+   fMixCacheSize(1000),
    fCheckDecay(kTRUE),
    fMaxNDaughters(-1),
    fCheckP(kFALSE),
@@ -171,6 +226,7 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask(const char *name, Bool_t useMC,Bo
    fMiniEvent(0x0),
    fBigOutput(kFALSE),
    fMixPrintRefresh(-1),
+   fMixCacheSize(1000),
    fCheckDecay(kTRUE),
    fMaxNDaughters(-1),
    fCheckP(kFALSE),
@@ -242,6 +298,7 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask(const AliRsnMiniAnalysisTask &cop
    fMiniEvent(0x0),
    fBigOutput(copy.fBigOutput),
    fMixPrintRefresh(copy.fMixPrintRefresh),
+   fMixCacheSize(copy.fMixCacheSize),
    fCheckDecay(copy.fCheckDecay),
    fMaxNDaughters(copy.fMaxNDaughters),
    fCheckP(copy.fCheckP),
@@ -314,6 +371,7 @@ AliRsnMiniAnalysisTask &AliRsnMiniAnalysisTask::operator=(const AliRsnMiniAnalys
    fESDtrackCuts = copy.fESDtrackCuts;
    fBigOutput = copy.fBigOutput;
    fMixPrintRefresh = copy.fMixPrintRefresh;
+   fMixCacheSize = copy.fMixCacheSize;
    fCheckDecay = copy.fCheckDecay;
    fMaxNDaughters = copy.fMaxNDaughters;
    fCheckP = copy.fCheckP;
@@ -586,10 +644,18 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    // prepare variables
    Int_t ievt, nEvents = (Int_t)fEvBuffer->GetEntries();
    Int_t idef, nDefs   = fHistograms.GetEntries();
-   Int_t imix, iloop, ifill;
+   Int_t imix, ifill;
    AliRsnMiniOutput *def = 0x0;
    AliRsnMiniOutput::EComputation compType;
 
+   // event variables used to find the mixing partners
+   std::vector<Float_t> mixVz, mixMult, mixAngle;
+   if (fNMix > 0) {
+      mixVz.reserve(nEvents);
+      mixMult.reserve(nEvents);
+      mixAngle.reserve(nEvents);
+   }
+
    Int_t printNum = fMixPrintRefresh;
    if (printNum < 0) {
       if (nEvents>1e5) printNum=nEvents/100;
@@ -609,6 +675,11 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
          AliInfo(Form("[%s] Std.Event %d/%d",GetName(), ievt,nEvents));
          timer.Stop(); timer.Print(); fflush(stdout); timer.Start(kFALSE);
       }
+      if (fNMix > 0) {
+         mixVz.push_back(fMiniEvent->Vz());
+         mixMult.push_back(fMiniEvent->Mult());
+         mixAngle.push_back(fMiniEvent->Angle());
+      }
       // fill
       for (idef = 0; idef < nDefs; idef++) {
          def = (AliRsnMiniOutput *)fHistograms[idef];
@@ -654,83 +725,46 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
       return;
    }
 
-   // initialize mixing counter
-   Int_t    nmatched[nEvents];
-   TString *smatched = new TString[nEvents];
-   for (ievt = 0; ievt < nEvents; ievt++) {
-      smatched[ievt] = "|";
-      nmatched[ievt] = 0;
-   }
-
-
    AliInfo(Form("[%s] Std.Event %d/%d",GetName(), nEvents,nEvents));
    timer.Stop(); timer.Print(); timer.Start(); fflush(stdout);
 
    // search for good matchings
-   for (ievt = 0; ievt < nEvents; ievt++) {
-      if (printNum&&(ievt%printNum==0)) {
-         AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),ievt,nEvents));
-         timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
-      }
-      if (nmatched[ievt] >= fNMix) continue;
-      fEvBuffer->GetEntry(ievt);
-      AliRsnMiniEvent evMain(*fMiniEvent);
-      for (iloop = 1; iloop < nEvents; iloop++) {
-         imix = ievt + iloop;
-         if (imix >= nEvents) imix -= nEvents;
-         if (imix == ievt) continue;
-         // text next entry
-         fEvBuffer->GetEntry(imix);
-         // skip if events are not matched
-         if (!EventsMatch(&evMain, fMiniEvent)) continue;
-         // check that the array of good matches for mixed does not already contain main event
-         if (smatched[imix].Contains(Form("|%d|", ievt))) continue;
-         // check that the found good events has not enough matches already
-         if (nmatched[imix] >= fNMix) continue;
-         // add new mixing candidate
-         smatched[ievt].Append(Form("%d|", imix));
-         nmatched[ievt]++;
-         nmatched[imix]++;
-         if (nmatched[ievt] >= fNMix) break;
-      }
-      AliDebugClass(1, Form("Matches for event %5d = %d [%s] (missing are declared above)", evMain.ID(), nmatched[ievt], smatched[ievt].Data()));
-   }
+   std::vector< std::vector<Int_t> > matched;
+   FindMixingPartners(mixVz, mixMult, mixAngle, matched);
 
    AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout); timer.Start();
 
    // perform mixing
-   TObjArray *list = 0x0;
-   TObjString *os = 0x0;
+   // the mixed events are read through a cache, since the partners of
+   // consecutive events are often the same
+   AliRsnMiniEventCache cache(fEvBuffer, &fMiniEvent, fMixCacheSize);
+   AliRsnMiniEvent *evMix = 0x0;
    for (ievt = 0; ievt < nEvents; ievt++) {
       if (printNum&&(ievt%printNum==0)) {
          AliInfo(Form("[%s] EventMixing %d/%d",GetName(),ievt,nEvents));
          timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
       }
+      if (matched[ievt].empty()) continue;
       ifill = 0;
       fEvBuffer->GetEntry(ievt);
       AliRsnMiniEvent evMain(*fMiniEvent);
-      list = smatched[ievt].Tokenize("|");
-      TObjArrayIter next(list);
-      while ( (os = (TObjString *)next()) ) {
-         imix = os->GetString().Atoi();
-         fEvBuffer->GetEntry(imix);
+      for (UInt_t i = 0; i < matched[ievt].size(); i++) {
+         imix = matched[ievt][i];
+         evMix = cache.Get(imix);
          for (idef = 0; idef < nDefs; idef++) {
             def = (AliRsnMiniOutput *)fHistograms[idef];
             if (!def) continue;
             if (!def->IsTrackPairMix()) continue;
-            ifill += def->FillPair(&evMain, fMiniEvent, &fValues, kTRUE);
+            ifill += def->FillPair(&evMain, evMix, &fValues, kTRUE);
             if (!def->IsSymmetric()) {
                AliDebugClass(2, "Reflecting non symmetric pair");
-               ifill += def->FillPair(fMiniEvent, &evMain, &fValues, kFALSE);
+               ifill += def->FillPair(evMix, &evMain, &fValues, kFALSE);
             }
          }
       }
-      delete list;
    }
 
-   delete [] smatched;
-
    AliInfo(Form("[%s] EventMixing %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout);
 
@@ -1677,33 +1711,34 @@ void AliRsnMiniAnalysisTask::SetDselection(UShort_t originDselection)
 Bool_t AliRsnMiniAnalysisTask::EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEvent *event2)
 {
    if (!event1 || !event2) return kFALSE;
+   return EventsMatch(event1->Vz(), event1->Mult(), event1->Angle(), event2->Vz(), event2->Mult(), event2->Angle());
+}
+
+//__________________________________________________________________________________________________
+/// Check if two events are compatible, given their vertex z, multiplicity and angle.
+///
+/// \return kTRUE if the events are compatible for mixing
+///
+Bool_t AliRsnMiniAnalysisTask::EventsMatch(Float_t vz1, Float_t mult1, Float_t angle1, Float_t vz2, Float_t mult2, Float_t angle2) const
+{
    Int_t ivz1, ivz2, imult1, imult2, iangle1, iangle2;
    Double_t dv, dm, da;
 
    if (fContinuousMix) {
-      dv = TMath::Abs(event1->Vz()    - event2->Vz()   );
-      dm = TMath::Abs(event1->Mult()  - event2->Mult() );
-      da = TMath::Abs(event1->Angle() - event2->Angle());
-      if (dv > fMaxDiffVz) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Vz = %f", event1->ID(), event2->ID(), dv));
-         return kFALSE;
-      }
-      if (dm > fMaxDiffMult ) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Mult = %f", event1->ID(), event2->ID(), dm));
-         return kFALSE;
-      }
-      if (da > fMaxDiffAngle) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Angle = %f", event1->ID(), event2->ID(), da));
-         return kFALSE;
-      }
+      dv = TMath::Abs(vz1    - vz2   );
+      dm = TMath::Abs(mult1  - mult2 );
+      da = TMath::Abs(angle1 - angle2);
+      if (dv > fMaxDiffVz) return kFALSE;
+      if (dm > fMaxDiffMult ) return kFALSE;
+      if (da > fMaxDiffAngle) return kFALSE;
       return kTRUE;
    } else {
-      ivz1 = (Int_t)(event1->Vz() / fMaxDiffVz);
-      ivz2 = (Int_t)(event2->Vz() / fMaxDiffVz);
-      imult1 = (Int_t)(event1->Mult() / fMaxDiffMult);
-      imult2 = (Int_t)(event2->Mult() / fMaxDiffMult);
-      iangle1 = (Int_t)(event1->Angle() / fMaxDiffAngle);
-      iangle2 = (Int_t)(event2->Angle() / fMaxDiffAngle);
+      ivz1 = (Int_t)(vz1 / fMaxDiffVz);
+      ivz2 = (Int_t)(vz2 / fMaxDiffVz);
+      imult1 = (Int_t)(mult1 / fMaxDiffMult);
+      imult2 = (Int_t)(mult2 / fMaxDiffMult);
+      iangle1 = (Int_t)(angle1 / fMaxDiffAngle);
+      iangle2 = (Int_t)(angle2 / fMaxDiffAngle);
       if (ivz1 != ivz2) return kFALSE;
       if (imult1 != imult2) return kFALSE;
       if (iangle1 != iangle2) return kFALSE;
@@ -1711,6 +1746,116 @@ Bool_t AliRsnMiniAnalysisTask::EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEv
    }
 }
 
+//__________________________________________________________________________________________________
+/// Find the mixing partners of all buffered events.
+///
+/// Each event is matched with up to fNMix compatible events, searched in the
+/// order of the buffer starting from the following event (and restarting from
+/// the first one at the end), skipping the events which already have fNMix
+/// partners or which already selected the event as a partner.
+/// Only the events which can be compatible are looked at: in binned mixing the
+/// events of the same bin, in continuous mixing the events in the same or in the
+/// neighbouring intervals of vertex z (with a width slightly larger than fMaxDiffVz).
+///
+/// \param vz, mult, angle Vertex z, multiplicity and angle of the buffered events
+/// \param matched Partners selected by each event
+///
+void AliRsnMiniAnalysisTask::FindMixingPartners(const std::vector<Float_t> &vz, const std::vector<Float_t> &mult, const std::vector<Float_t> &angle, std::vector< std::vector<Int_t> > &matched)
+{
+   Int_t ievt, imix, nEvents = vz.size();
+   Int_t printNum = fMixPrintRefresh;
+   if (printNum < 0) {
+      if (nEvents>1e5) printNum=nEvents/100;
+      else if (nEvents>1e4) printNum=nEvents/10;
+      else printNum = 0;
+   }
+   TStopwatch timer;
+   timer.Start();
+
+   matched.assign(nEvents, std::vector<Int_t>());
+   std::vector<Int_t> nmatched(nEvents, 0);
+
+   // group the events, in buffer order:
+   // binned mixing --> one group per bin
+   // continuous mixing --> one group per interval of vertex z,
+   // or a single group if the intervals cannot be defined
+   typedef std::pair<Int_t, std::pair<Int_t, Int_t> > Group_t;
+   std::map<Group_t, std::vector<Int_t> > groups;
+   std::vector<Int_t> eventGroup(nEvents, 0);
+   Double_t width = fMaxDiffVz * 1.001;
+   Bool_t useIntervals = kTRUE;
+   if (fContinuousMix) {
+      if (!(width > 0.0) || !TMath::Finite(width)) useIntervals = kFALSE;
+      for (ievt = 0; ievt < nEvents && useIntervals; ievt++)
+         if (!TMath::Finite(vz[ievt]) || TMath::Abs(vz[ievt] / width) > 1E9) useIntervals = kFALSE;
+   }
+   for (ievt = 0; ievt < nEvents; ievt++) {
+      Group_t group(0, std::make_pair(0, 0));
+      if (!fContinuousMix) {
+         group.first = (Int_t)(vz[ievt] / fMaxDiffVz);
+         group.second.first = (Int_t)(mult[ievt] / fMaxDiffMult);
+         group.second.second = (Int_t)(angle[ievt] / fMaxDiffAngle);
+      } else if (useIntervals) {
+         group.first = (Int_t)TMath::Floor(vz[ievt] / width);
+         eventGroup[ievt] = group.first;
+      }
+      groups[group].push_back(ievt);
+   }
+
+   for (ievt = 0; ievt < nEvents; ievt++) {
+      if (printNum&&(ievt%printNum==0)) {
+         AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),ievt,nEvents));
+         timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
+      }
+      if (nmatched[ievt] >= fNMix) continue;
+
+      // groups which can contain compatible events
+      const std::vector<Int_t> *lists[3];
+      Int_t ilist, nlists = 0;
+      if (!fContinuousMix) {
+         Group_t group((Int_t)(vz[ievt] / fMaxDiffVz), std::make_pair((Int_t)(mult[ievt] / fMaxDiffMult), (Int_t)(angle[ievt] / fMaxDiffAngle)));
+         lists[nlists++] = &groups[group];
+      } else {
+         for (Int_t i = -1; i <= 1; i++) {
+            if (!useIntervals && i != 0) continue;
+            std::map<Group_t, std::vector<Int_t> >::iterator it = groups.find(Group_t(eventGroup[ievt] + i, std::make_pair(0, 0)));
+            if (it != groups.end()) lists[nlists++] = &it->second;
+         }
+      }
+
+      // loop on the events of these groups in buffer order,
+      // first after the event itself, then from the beginning of the buffer
+      Bool_t done = kFALSE;
+      for (Int_t pass = 0; pass < 2 && !done; pass++) {
+         std::vector<Int_t>::const_iterator pos[3], end[3];
+         for (ilist = 0; ilist < nlists; ilist++) {
+            pos[ilist] = (pass == 0) ? std::upper_bound(lists[ilist]->begin(), lists[ilist]->end(), ievt) : lists[ilist]->begin();
+            end[ilist] = (pass == 0) ? lists[ilist]->end() : std::lower_bound(lists[ilist]->begin(), lists[ilist]->end(), ievt);
+         }
+         while (!done) {
+            Int_t next = -1;
+            for (ilist = 0; ilist < nlists; ilist++)
+               if (pos[ilist] != end[ilist] && (next < 0 || *pos[ilist] < *pos[next])) next = ilist;
+            if (next < 0) break;
+            imix = *pos[next];
+            ++pos[next];
+            // skip if events are not matched
+            if (fContinuousMix && !EventsMatch(vz[ievt], mult[ievt], angle[ievt], vz[imix], mult[imix], angle[imix])) continue;
+            // check that the array of good matches for mixed does not already contain main event
+            if (std::find(matched[imix].begin(), matched[imix].end(), ievt) != matched[imix].end()) continue;
+            // check that the found good events has not enough matches already
+            if (nmatched[imix] >= fNMix) continue;
+            // add new mixing candidate
+            matched[ievt].push_back(imix);
+            nmatched[ievt]++;
+            nmatched[imix]++;
+            if (nmatched[ievt] >= fNMix) done = kTRUE;
+         }
+      }
+      AliDebugClass(1, Form("Matches for event %5d = %d (missing are declared above)", ievt, nmatched[ievt]));
+   }
+}
+
 //---------------------------------------------------------------------
 /// Patch to be used with 2011 Pb-Pb data for flat centrality distribution
 ///
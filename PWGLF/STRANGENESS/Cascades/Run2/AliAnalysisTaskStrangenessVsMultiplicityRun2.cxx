@@ -63,6 +63,10 @@ class AliESDv0;
 class AliAODv0;
 
 #include <Riostream.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
 #include "TList.h"
 #include "TH1.h"
 #include "TH2.h"
@@ -123,6 +127,332 @@ using std::endl;
 
 ClassImp(AliAnalysisTaskStrangenessVsMultiplicityRun2)
 
+//________________________________________________________________________
+// Cut sweeps: description of the thresholds which can be swept
+namespace {
+    //Kind of threshold
+    enum ESweepKind {
+        kSweepLower = 0,      //passes if value > cut
+        kSweepUpper,          //passes if value < cut
+        kSweepLowerOrNegative //passes if cut < 0 or value > cut
+    };
+    
+    //V0 cuts which can be swept
+    enum EV0SweepCut {
+        kV0SweepV0Radius = 0,
+        kV0SweepMaxV0Radius,
+        kV0SweepDCANegToPV,
+        kV0SweepDCAPosToPV,
+        kV0SweepDCAV0Daughters,
+        kV0SweepV0CosPA,
+        kV0SweepProperLifetime,
+        kV0SweepLeastNumberOfCrossedRows,
+        kV0SweepLeastNumberOfCrossedRowsOverFindable,
+        kV0SweepTPCdEdx,
+        kV0SweepMinTrackLength,
+        kV0SweepMinCrossedRowsOverLength,
+        kNV0SweepCuts
+    };
+    
+    //Cascade cuts which can be swept
+    enum ECascadeSweepCut {
+        kCascSweepDCANegToPV = 0,
+        kCascSweepDCAPosToPV,
+        kCascSweepDCAV0Daughters,
+        kCascSweepV0CosPA,
+        kCascSweepV0Radius,
+        kCascSweepDCAV0ToPV,
+        kCascSweepV0Mass,
+        kCascSweepDCABachToPV,
+        kCascSweepDCACascDaughters,
+        kCascSweepCascCosPA,
+        kCascSweepCascRadius,
+        kCascSweepProperLifetime,
+        kCascSweepLeastNumberOfClusters,
+        kCascSweepTPCdEdx,
+        kCascSweepDCABachToBaryon,
+        kCascSweepBachBaryonCosPA,
+        kCascSweepMinTrackLength,
+        kCascSweepMinCrossedRowsOverLength,
+        kCascSweepLeastNumberOfCrossedRows,
+        kNCascadeSweepCuts
+    };
+    
+    //Kind of each cut, and whether the cut is compared in single precision
+    const Int_t kV0SweepKind[kNV0SweepCuts] = {
+        kSweepLower, kSweepUpper, kSweepLower, kSweepLower, kSweepUpper, kSweepLower,
+        kSweepUpper, kSweepLower, kSweepLower, kSweepUpper, kSweepLowerOrNegative, kSweepLowerOrNegative
+    };
+    const Bool_t kV0SweepFloat[kNV0SweepCuts] = {
+        kFALSE, kFALSE, kFALSE, kFALSE, kFALSE, kTRUE,
+        kFALSE, kFALSE, kFALSE, kFALSE, kFALSE, kFALSE
+    };
+    const Int_t kCascadeSweepKind[kNCascadeSweepCuts] = {
+        kSweepLower, kSweepLower, kSweepUpper, kSweepLower, kSweepLower, kSweepLower, kSweepUpper,
+        kSweepLower, kSweepUpper, kSweepLower, kSweepLower, kSweepUpper, kSweepLower, kSweepUpper,
+        kSweepLower, kSweepUpper, kSweepLowerOrNegative, kSweepLowerOrNegative, kSweepLowerOrNegative
+    };
+    const Bool_t kCascadeSweepFloat[kNCascadeSweepCuts] = {
+        kFALSE, kFALSE, kFALSE, kTRUE, kFALSE, kFALSE, kFALSE,
+        kFALSE, kTRUE, kTRUE, kFALSE, kFALSE, kFALSE, kFALSE,
+        kFALSE, kTRUE, kFALSE, kFALSE, kFALSE
+    };
+    
+    //All the selection parameters of a configuration, starting with the cuts which can be swept
+    void GetSweepKey( AliV0Result *lRes, std::vector<Double_t> &lKey ){
+        lKey.clear();
+        lKey.push_back( lRes->GetCutV0Radius() );
+        lKey.push_back( lRes->GetCutMaxV0Radius() );
+        lKey.push_back( lRes->GetCutDCANegToPV() );
+        lKey.push_back( lRes->GetCutDCAPosToPV() );
+        lKey.push_back( lRes->GetCutDCAV0Daughters() );
+        lKey.push_back( lRes->GetCutV0CosPA() );
+        lKey.push_back( lRes->GetCutProperLifetime() );
+        lKey.push_back( lRes->GetCutLeastNumberOfCrossedRows() );
+        lKey.push_back( lRes->GetCutLeastNumberOfCrossedRowsOverFindable() );
+        lKey.push_back( lRes->GetCutTPCdEdx() );
+        lKey.push_back( lRes->GetCutMinTrackLength() );
+        lKey.push_back( lRes->GetCutMinCrossedRowsOverLength() );
+        
+        lKey.push_back( lRes->GetMassHypothesis() );
+        lKey.push_back( lRes->GetUseOnTheFly() );
+        lKey.push_back( lRes->GetCutMinEtaTracks() );
+        lKey.push_back( lRes->GetCutMaxEtaTracks() );
+        lKey.push_back( lRes->GetCutMinRapidity() );
+        lKey.push_back( lRes->GetCutMaxRapidity() );
+        lKey.push_back( lRes->GetCutUseVarV0CosPA() );
+        lKey.push_back( lRes->GetCutVarV0CosPAExp0Const() );
+        lKey.push_back( lRes->GetCutVarV0CosPAExp0Slope() );
+        lKey.push_back( lRes->GetCutVarV0CosPAExp1Const() );
+        lKey.push_back( lRes->GetCutVarV0CosPAExp1Slope() );
+        lKey.push_back( lRes->GetCutVarV0CosPAConst() );
+        lKey.push_back( lRes->GetCutMinBaryonMomentum() );
+        lKey.push_back( lRes->GetCutArmenteros() );
+        lKey.push_back( lRes->GetCutArmenterosParameter() );
+        lKey.push_back( lRes->GetCutUseITSRefitTracks() );
+        lKey.push_back( lRes->GetCutMaxChi2PerCluster() );
+        lKey.push_back( lRes->GetCutUseParametricLength() );
+        lKey.push_back( lRes->GetCut276TeVLikedEdx() );
+        lKey.push_back( lRes->GetCutAtLeastOneTOF() );
+        lKey.push_back( lRes->GetCutIsCowboy() );
+        lKey.push_back( lRes->GetCutITSorTOF() );
+    }
+    void GetSweepKey( AliCascadeResult *lRes, std::vector<Double_t> &lKey ){
+        lKey.clear();
+        lKey.push_back( lRes->GetCutDCANegToPV() );
+        lKey.push_back( lRes->GetCutDCAPosToPV() );
+        lKey.push_back( lRes->GetCutDCAV0Daughters() );
+        lKey.push_back( lRes->GetCutV0CosPA() );
+        lKey.push_back( lRes->GetCutV0Radius() );
+        lKey.push_back( lRes->GetCutDCAV0ToPV() );
+        lKey.push_back( lRes->GetCutV0Mass() );
+        lKey.push_back( lRes->GetCutDCABachToPV() );
+        lKey.push_back( lRes->GetCutDCACascDaughters() );
+        lKey.push_back( lRes->GetCutCascCosPA() );
+        lKey.push_back( lRes->GetCutCascRadius() );
+        lKey.push_back( lRes->GetCutProperLifetime() );
+        lKey.push_back( lRes->GetCutLeastNumberOfClusters() );
+        lKey.push_back( lRes->GetCutTPCdEdx() );
+        lKey.push_back( lRes->GetCutDCABachToBaryon() );
+        lKey.push_back( lRes->GetCutBachBaryonCosPA() );
+        lKey.push_back( lRes->GetCutMinTrackLength() );
+        lKey.push_back( lRes->GetCutMinCrossedRowsOverLength() );
+        lKey.push_back( lRes->GetCutLeastNumberOfCrossedRows() );
+        
+        lKey.push_back( lRes->GetMassHypothesis() );
+        lKey.push_back( lRes->GetSwapBachelorCharge() );
+        lKey.push_back( lRes->GetCutMinEtaTracks() );
+        lKey.push_back( lRes->GetCutMaxEtaTracks() );
+        lKey.push_back( lRes->GetCutMinRapidity() );
+        lKey.push_back( lRes->GetCutMaxRapidity() );
+        lKey.push_back( lRes->GetCutV0MassSigma() );
+        lKey.push_back( lRes->GetCutUseTOFUnchecked() );
+        lKey.push_back( lRes->GetCutXiRejection() );
+        lKey.push_back( lRes->GetCutMinV0Lifetime() );
+        lKey.push_back( lRes->GetCutMaxV0Lifetime() );
+        lKey.push_back( lRes->GetCutUseITSRefitTracks() );
+        lKey.push_back( lRes->GetCutMaxChi2PerCluster() );
+        lKey.push_back( lRes->GetCutUseParametricLength() );
+        lKey.push_back( lRes->GetCutUse276TeVV0CosPA() );
+        lKey.push_back( lRes->GetCutDCACascadeToPV() );
+        lKey.push_back( lRes->GetCutAtLeastOneTOF() );
+        lKey.push_back( lRes->GetCutUseITSRefitNegative() );
+        lKey.push_back( lRes->GetCutUseITSRefitPositive() );
+        lKey.push_back( lRes->GetCutUseITSRefitBachelor() );
+        lKey.push_back( lRes->GetCutIsCowboy() );
+        lKey.push_back( lRes->GetCutIsCascadeCowboy() );
+        lKey.push_back( lRes->GetCutITSorTOF() );
+        lKey.push_back( lRes->GetCutUseVarCascCosPA() );
+        lKey.push_back( lRes->GetCutVarCascCosPAExp0Const() );
+        lKey.push_back( lRes->GetCutVarCascCosPAExp0Slope() );
+        lKey.push_back( lRes->GetCutVarCascCosPAExp1Const() );
+        lKey.push_back( lRes->GetCutVarCascCosPAExp1Slope() );
+        lKey.push_back( lRes->GetCutVarCascCosPAConst() );
+        lKey.push_back( lRes->GetCutUseVarV0CosPA() );
+        lKey.push_back( lRes->GetCutVarV0CosPAExp0Const() );
+        lKey.push_back( lRes->GetCutVarV0CosPAExp0Slope() );
+        lKey.push_back( lRes->GetCutVarV0CosPAExp1Const() );
+        lKey.push_back( lRes->GetCutVarV0CosPAExp1Slope() );
+        lKey.push_back( lRes->GetCutVarV0CosPAConst() );
+        lKey.push_back( lRes->GetCutUseVarBBCosPA() );
+        lKey.push_back( lRes->GetCutVarBBCosPAExp0Const() );
+        lKey.push_back( lRes->GetCutVarBBCosPAExp0Slope() );
+        lKey.push_back( lRes->GetCutVarBBCosPAExp1Const() );
+        lKey.push_back( lRes->GetCutVarBBCosPAExp1Slope() );
+        lKey.push_back( lRes->GetCutVarBBCosPAConst() );
+        lKey.push_back( lRes->GetCutUseVarDCACascDau() );
+        lKey.push_back( lRes->GetCutVarDCACascDauExp0Const() );
+        lKey.push_back( lRes->GetCutVarDCACascDauExp0Slope() );
+        lKey.push_back( lRes->GetCutVarDCACascDauExp1Const() );
+        lKey.push_back( lRes->GetCutVarDCACascDauExp1Slope() );
+        lKey.push_back( lRes->GetCutVarDCACascDauConst() );
+    }
+    
+    //Swept cut accessors
+    Double_t GetSweepCut( AliV0Result *lRes, Int_t lCut ){
+        switch( lCut ){
+            case kV0SweepV0Radius:                             return lRes->GetCutV0Radius();
+            case kV0SweepMaxV0Radius:                          return lRes->GetCutMaxV0Radius();
+            case kV0SweepDCANegToPV:                           return lRes->GetCutDCANegToPV();
+            case kV0SweepDCAPosToPV:                           return lRes->GetCutDCAPosToPV();
+            case kV0SweepDCAV0Daughters:                       return lRes->GetCutDCAV0Daughters();
+            case kV0SweepV0CosPA:                              return lRes->GetCutV0CosPA();
+            case kV0SweepProperLifetime:                       return lRes->GetCutProperLifetime();
+            case kV0SweepLeastNumberOfCrossedRows:             return lRes->GetCutLeastNumberOfCrossedRows();
+            case kV0SweepLeastNumberOfCrossedRowsOverFindable: return lRes->GetCutLeastNumberOfCrossedRowsOverFindable();
+            case kV0SweepTPCdEdx:                              return lRes->GetCutTPCdEdx();
+            case kV0SweepMinTrackLength:                       return lRes->GetCutMinTrackLength();
+            case kV0SweepMinCrossedRowsOverLength:             return lRes->GetCutMinCrossedRowsOverLength();
+        }
+        return 0;
+    }
+    Double_t GetSweepCut( AliCascadeResult *lRes, Int_t lCut ){
+        switch( lCut ){
+            case kCascSweepDCANegToPV:               return lRes->GetCutDCANegToPV();
+            case kCascSweepDCAPosToPV:               return lRes->GetCutDCAPosToPV();
+            case kCascSweepDCAV0Daughters:           return lRes->GetCutDCAV0Daughters();
+            case kCascSweepV0CosPA:                  return lRes->GetCutV0CosPA();
+            case kCascSweepV0Radius:                 return lRes->GetCutV0Radius();
+            case kCascSweepDCAV0ToPV:                return lRes->GetCutDCAV0ToPV();
+            case kCascSweepV0Mass:                   return lRes->GetCutV0Mass();
+            case kCascSweepDCABachToPV:              return lRes->GetCutDCABachToPV();
+            case kCascSweepDCACascDaughters:         return lRes->GetCutDCACascDaughters();
+            case kCascSweepCascCosPA:                return lRes->GetCutCascCosPA();
+            case kCascSweepCascRadius:               return lRes->GetCutCascRadius();
+            case kCascSweepProperLifetime:           return lRes->GetCutProperLifetime();
+            case kCascSweepLeastNumberOfClusters:    return lRes->GetCutLeastNumberOfClusters();
+            case kCascSweepTPCdEdx:                  return lRes->GetCutTPCdEdx();
+            case kCascSweepDCABachToBaryon:          return lRes->GetCutDCABachToBaryon();
+            case kCascSweepBachBaryonCosPA:          return lRes->GetCutBachBaryonCosPA();
+            case kCascSweepMinTrackLength:           return lRes->GetCutMinTrackLength();
+            case kCascSweepMinCrossedRowsOverLength: return lRes->GetCutMinCrossedRowsOverLength();
+            case kCascSweepLeastNumberOfCrossedRows: return lRes->GetCutLeastNumberOfCrossedRows();
+        }
+        return 0;
+    }
+    void SetSweepCut( AliV0Result *lRes, Int_t lCut, Double_t lValue ){
+        switch( lCut ){
+            case kV0SweepV0Radius:                             lRes->SetCutV0Radius( lValue ); break;
+            case kV0SweepMaxV0Radius:                          lRes->SetCutMaxV0Radius( lValue ); break;
+            case kV0SweepDCANegToPV:                           lRes->SetCutDCANegToPV( lValue ); break;
+            case kV0SweepDCAPosToPV:                           lRes->SetCutDCAPosToPV( lValue ); break;
+            case kV0SweepDCAV0Daughters:                       lRes->SetCutDCAV0Daughters( lValue ); break;
+            case kV0SweepV0CosPA:                              lRes->SetCutV0CosPA( lValue ); break;
+            case kV0SweepProperLifetime:                       lRes->SetCutProperLifetime( lValue ); break;
+            case kV0SweepLeastNumberOfCrossedRows:             lRes->SetCutLeastNumberOfCrossedRows( lValue ); break;
+            case kV0SweepLeastNumberOfCrossedRowsOverFindable: lRes->SetCutLeastNumberOfCrossedRowsOverFindable( lValue ); break;
+            case kV0SweepTPCdEdx:                              lRes->SetCutTPCdEdx( lValue ); break;
+            case kV0SweepMinTrackLength:                       lRes->SetCutMinTrackLength( lValue ); break;
+            case kV0SweepMinCrossedRowsOverLength:             lRes->SetCutMinCrossedRowsOverLength( lValue ); break;
+        }
+    }
+    void SetSweepCut( AliCascadeResult *lRes, Int_t lCut, Double_t lValue ){
+        switch( lCut ){
+            case kCascSweepDCANegToPV:               lRes->SetCutDCANegToPV( lValue ); break;
+            case kCascSweepDCAPosToPV:               lRes->SetCutDCAPosToPV( lValue ); break;
+            case kCascSweepDCAV0Daughters:           lRes->SetCutDCAV0Daughters( lValue ); break;
+            case kCascSweepV0CosPA:                  lRes->SetCutV0CosPA( lValue ); break;
+            case kCascSweepV0Radius:                 lRes->SetCutV0Radius( lValue ); break;
+            case kCascSweepDCAV0ToPV:                lRes->SetCutDCAV0ToPV( lValue ); break;
+            case kCascSweepV0Mass:                   lRes->SetCutV0Mass( lValue ); break;
+            case kCascSweepDCABachToPV:              lRes->SetCutDCABachToPV( lValue ); break;
+            case kCascSweepDCACascDaughters:         lRes->SetCutDCACascDaughters( lValue ); break;
+            case kCascSweepCascCosPA:                lRes->SetCutCascCosPA( lValue ); break;
+            case kCascSweepCascRadius:               lRes->SetCutCascRadius( lValue ); break;
+            case kCascSweepProperLifetime:           lRes->SetCutProperLifetime( lValue ); break;
+            case kCascSweepLeastNumberOfClusters:    lRes->SetCutLeastNumberOfClusters( lValue ); break;
+            case kCascSweepTPCdEdx:                  lRes->SetCutTPCdEdx( lValue ); break;
+            case kCascSweepDCABachToBaryon:          lRes->SetCutDCABachToBaryon( lValue ); break;
+            case kCascSweepBachBaryonCosPA:          lRes->SetCutBachBaryonCosPA( lValue ); break;
+            case kCascSweepMinTrackLength:           lRes->SetCutMinTrackLength( lValue ); break;
+            case kCascSweepMinCrossedRowsOverLength: lRes->SetCutMinCrossedRowsOverLength( lValue ); break;
+            case kCascSweepLeastNumberOfCrossedRows: lRes->SetCutLeastNumberOfCrossedRows( lValue ); break;
+        }
+    }
+    
+    //A cut can be swept if it acts as a plain threshold for this configuration
+    Bool_t IsSweepable( AliV0Result *lRes, Int_t lCut ){
+        if( GetSweepCut( lRes, lCut ) != GetSweepCut( lRes, lCut ) ) return kFALSE; //NaN
+        if( lCut == kV0SweepMinTrackLength ) return !lRes->GetCutUseParametricLength();
+        return kTRUE;
+    }
+    Bool_t IsSweepable( AliCascadeResult *lRes, Int_t lCut ){
+        if( GetSweepCut( lRes, lCut ) != GetSweepCut( lRes, lCut ) ) return kFALSE; //NaN
+        if( lCut == kCascSweepMinTrackLength ) return !lRes->GetCutUseParametricLength();
+        if( lCut == kCascSweepBachBaryonCosPA ) return !lRes->GetCutUseVarBBCosPA();
+        return kTRUE;
+    }
+    
+    //Bit pattern of the key, for exact comparisons
+    std::vector<ULong64_t> GetSweepKeyBits( const std::vector<Double_t> &lKey, Int_t lSkip ){
+        std::vector<ULong64_t> lBits(lKey.size(), 0);
+        for( size_t i=0; i<lKey.size(); i++ ) if( (Int_t)i != lSkip ) memcpy( &lBits[i], &lKey[i], sizeof(Double_t) );
+        return lBits;
+    }
+    
+    //Group the configurations: for each cut in turn, the configurations not yet grouped
+    //with identical parameters except for this cut form a sweep. lGroupCut is -1 for the
+    //configurations left alone.
+    template<class T> void GroupConfigurations( const std::vector<T*> &lConfigs, Int_t lNCuts, const TString &lExclude, Bool_t lUseSweeps,
+                                               std::vector<Int_t> &lGroupCut, std::vector< std::vector<Int_t> > &lGroups ){
+        lGroupCut.clear();
+        lGroups.clear();
+        std::vector<Bool_t> lGrouped( lConfigs.size(), kFALSE );
+        std::vector< std::vector<Double_t> > lKeys( lConfigs.size() );
+        for( size_t i=0; i<lConfigs.size(); i++ ){
+            GetSweepKey( lConfigs[i], lKeys[i] );
+            //the configuration saved to the tree is checked on its own
+            if( !lUseSweeps || lExclude.EqualTo( lConfigs[i]->GetName() ) ) lGrouped[i] = kTRUE;
+        }
+        for( Int_t lCut=0; lCut<lNCuts; lCut++ ){
+            std::map< std::vector<ULong64_t>, std::vector<Int_t> > lBuckets;
+            for( size_t i=0; i<lConfigs.size(); i++ )
+                if( !lGrouped[i] && IsSweepable( lConfigs[i], lCut ) ) lBuckets[ GetSweepKeyBits( lKeys[i], lCut ) ].push_back( i );
+            for( std::map< std::vector<ULong64_t>, std::vector<Int_t> >::iterator it = lBuckets.begin(); it != lBuckets.end(); ++it ){
+                if( it->second.size() < 2 ) continue;
+                lGroupCut.push_back( lCut );
+                lGroups.push_back( it->second );
+                for( size_t j=0; j<it->second.size(); j++ ) lGrouped[ it->second[j] ] = kTRUE;
+            }
+        }
+        //Remaining configurations, in their original order
+        std::vector<Int_t> lSingle;
+        for( size_t i=0; i<lConfigs.size(); i++ ){
+            if( !lUseSweeps || lExclude.EqualTo( lConfigs[i]->GetName() ) || !lGrouped[i] ){
+                lSingle.assign( 1, i );
+                lGroupCut.push_back( -1 );
+                lGroups.push_back( lSingle );
+            }
+        }
+    }
+    
+    //Largest of two values, NaN if any of them is NaN
+    Double_t SweepMax( Double_t a, Double_t b ){
+        if( a != a || b != b ) return a + b;
+        return TMath::Max( a, b );
+    }
+}
+
 AliAnalysisTaskStrangenessVsMultiplicityRun2::AliAnalysisTaskStrangenessVsMultiplicityRun2()
 : AliAnalysisTaskSE(), fListHist(0), fListK0Short(0), fListLambda(0), fListAntiLambda(0),
 fListXiMinus(0), fListXiPlus(0), fListOmegaMinus(0), fListOmegaPlus(0),
@@ -175,6 +505,7 @@ fkSandboxMode ( kFALSE ),
 //---> Fill tree with specific config
 fkSaveSpecificConfig(kFALSE),
 fkConfigToSave(""),
+fkUseCutSweeps(kTRUE),
 
 //---> Variables for fTreeEvent
 fCentrality(0),
@@ -535,6 +866,7 @@ fkSandboxMode ( kFALSE ),
 //---> Fill tree with specific config
 fkSaveSpecificConfig(kFALSE),
 fkConfigToSave(""),
+fkUseCutSweeps(kTRUE),
 
 //---> Variables for fTreeEvent
 fCentrality(0),
@@ -1491,6 +1823,9 @@ void AliAnalysisTaskStrangenessVsMultiplicityRun2::UserCreateOutputObjects()
         lCscRslt->InitializeProtonProfile();
     }
     
+    //Group configurations differing by a single threshold
+    BuildCutSweeps();
+    
     AliWarning( Form("Initialized %i cascade output objects!", lTotalCfgs));
     
     //Regular Output: Slots 1-8
@@ -2219,26 +2554,18 @@ void AliAnalysisTaskStrangenessVsMultiplicityRun2::UserExec(Option_t *)
         TH3F *histoout         = 0x0;
         AliV0Result *lV0Result = 0x0;
         
-        //pointers to valid results
-        AliV0Result *lPointers[50000];
-        Long_t lValidConfigurations=0;
-        
-        for( Int_t icfg=0; icfg<fListK0Short->GetEntries(); icfg++ ){
-            lPointers[lValidConfigurations] = (AliV0Result*) fListK0Short->At(icfg);
-            lValidConfigurations++;
-        }
-        for( Int_t icfg=0; icfg<fListLambda->GetEntries(); icfg++ ){
-            lPointers[lValidConfigurations] = (AliV0Result*) fListLambda->At(icfg);
-            lValidConfigurations++;
-        }
-        for( Int_t icfg=0; icfg<fListAntiLambda->GetEntries(); icfg++ ){
-            lPointers[lValidConfigurations] = (AliV0Result*) fListAntiLambda->At(icfg);
-            lValidConfigurations++;
-        }
-        
-        for(Int_t lcfg=0; lcfg<lValidConfigurations; lcfg++){
-            lV0Result = lPointers[lcfg];
+        //Configurations grouped in cut sweeps (see BuildCutSweeps): the selections are
+        //checked once per group with the swept cut open, then the swept cut is applied
+        //to all configurations of the group at once
+        for(size_t lcfg=0; lcfg<fV0Sweeps.size(); lcfg++){
+            const CutSweep &lSweep = fV0Sweeps[lcfg];
+            lV0Result = (AliV0Result*) lSweep.fConfig;
             histoout  = lV0Result->GetHistogram();
+            Double_t lSweptCut = 0;
+            if( lSweep.fCut >= 0 ){
+                lSweptCut = GetSweepCut( lV0Result, lSweep.fCut );
+                SetSweepCut( lV0Result, lSweep.fCut, lSweep.fOpenValue );
+            }
             
             Float_t lMass = 0;
             Float_t lRap  = 0;
@@ -2386,8 +2713,10 @@ void AliAnalysisTaskStrangenessVsMultiplicityRun2::UserExec(Option_t *)
                 )//end major if
             {
                 //This satisfies all my conditionals! Fill histogram
-                histoout -> Fill ( fCentrality, fTreeVariablePt, lMass );
+                if( lSweep.fCut < 0 ) histoout -> Fill ( fCentrality, fTreeVariablePt, lMass );
+                else FillCutSweep( lSweep, GetV0SweepValue( lSweep.fCut, lPDGMass, lNegdEdx, lPosdEdx, lLeastNcrOverLength ), fTreeVariablePt, lMass );
             }
+            if( lSweep.fCut >= 0 ) SetSweepCut( lV0Result, lSweep.fCut, lSweptCut );
         }
         //+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
         // End Superlight adaptive output mode
@@ -3273,35 +3602,21 @@ void AliAnalysisTaskStrangenessVsMultiplicityRun2::UserExec(Option_t *)
         TH3F *histoout         = 0x0;
         AliCascadeResult *lCascadeResult = 0x0;
         
-        //pointers to valid results
-        AliCascadeResult *lPointers[50000];
-        Long_t lValidConfigurations=0;
-        
-        if( lValidXiMinus )
-            for( Int_t icfg=0; icfg<fListXiMinus->GetEntries(); icfg++ ){
-                lPointers[lValidConfigurations] = (AliCascadeResult*) fListXiMinus->At(icfg);
-                lValidConfigurations++;
-            }
-        if( lValidXiPlus )
-            for( Int_t icfg=0; icfg<fListXiPlus->GetEntries(); icfg++ ){
-                lPointers[lValidConfigurations] = (AliCascadeResult*) fListXiPlus->At(icfg);
-                lValidConfigurations++;
-            }
-        if( lValidOmegaMinus )
-            for( Int_t icfg=0; icfg<fListOmegaMinus->GetEntries(); icfg++ ){
-                lPointers[lValidConfigurations] = (AliCascadeResult*) fListOmegaMinus->At(icfg);
-                lValidConfigurations++;
-            }
-        if( lValidOmegaPlus )
-            for( Int_t icfg=0; icfg<fListOmegaPlus->GetEntries(); icfg++ ){
-                lPointers[lValidConfigurations] = (AliCascadeResult*) fListOmegaPlus->At(icfg);
-                lValidConfigurations++;
-            }
+        //valid output lists
+        Bool_t lValidList[4] = {lValidXiMinus, lValidXiPlus, lValidOmegaMinus, lValidOmegaPlus};
         
-        for(Int_t lcfg=0; lcfg<lValidConfigurations; lcfg++){
-            lCascadeResult = lPointers[lcfg];
+        //Configurations grouped in cut sweeps (see BuildCutSweeps), as for V0s
+        for(size_t lcfg=0; lcfg<fCascadeSweeps.size(); lcfg++){
+            const CutSweep &lSweep = fCascadeSweeps[lcfg];
+            if( !lValidList[lSweep.fList] ) continue;
+            lCascadeResult = (AliCascadeResult*) lSweep.fConfig;
             Bool_t lTheOne = fkConfigToSave.EqualTo( lCascadeResult->GetName() );
             histoout  = lCascadeResult->GetHistogram();
+            Double_t lSweptCut = 0;
+            if( lSweep.fCut >= 0 ){
+                lSweptCut = GetSweepCut( lCascadeResult, lSweep.fCut );
+                SetSweepCut( lCascadeResult, lSweep.fCut, lSweep.fOpenValue );
+            }
             
             Float_t lMass = 0;
             Float_t lV0Mass = 0;
@@ -3643,8 +3958,10 @@ void AliAnalysisTaskStrangenessVsMultiplicityRun2::UserExec(Option_t *)
             {
                 //This satisfies all my conditionals! Fill histogram
                 if( lTheOne && fkSaveSpecificConfig ) fTreeCascade->Fill();
-                histoout -> Fill ( fCentrality, fTreeCascVarPt, lMass );
+                if( lSweep.fCut < 0 ) histoout -> Fill ( fCentrality, fTreeCascVarPt, lMass );
+                else FillCutSweep( lSweep, GetCascadeSweepValue( lSweep.fCut, lPDGMass, lV0Mass, lNegdEdx, lPosdEdx, lBachdEdx, lLeastNcrOverLength, lLeastNbrCrossedRows ), fTreeCascVarPt, lMass );
             }
+            if( lSweep.fCut >= 0 ) SetSweepCut( lCascadeResult, lSweep.fCut, lSweptCut );
         }
         //+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
         // End Superlight adaptive output mode
@@ -6647,3 +6964,152 @@ void AliAnalysisTaskStrangenessVsMultiplicityRun2::CheckChargeV0(AliESDv0 *v0)
 }
 
 
+
+//________________________________________________________________________
+void AliAnalysisTaskStrangenessVsMultiplicityRun2::BuildCutSweeps()
+{
+    //Groups the configurations of each output list which only differ by one threshold
+    //(see CutSweep). Disabled with SetUseCutSweeps(kFALSE): one group per configuration.
+    fV0Sweeps.clear();
+    fCascadeSweeps.clear();
+    std::vector<Int_t> lGroupCut;
+    std::vector< std::vector<Int_t> > lGroups;
+    
+    TList *lV0Lists[3] = {fListK0Short, fListLambda, fListAntiLambda};
+    for( Int_t ilist=0; ilist<3; ilist++ ){
+        std::vector<AliV0Result*> lConfigs;
+        for( Int_t icfg=0; icfg<lV0Lists[ilist]->GetEntries(); icfg++ ) lConfigs.push_back( (AliV0Result*) lV0Lists[ilist]->At(icfg) );
+        GroupConfigurations( lConfigs, kNV0SweepCuts, fkConfigToSave, fkUseCutSweeps, lGroupCut, lGroups );
+        for( size_t igr=0; igr<lGroups.size(); igr++ ){
+            CutSweep lSweep;
+            lSweep.fConfig = lConfigs[ lGroups[igr][0] ];
+            lSweep.fList = ilist;
+            lSweep.fCut = lGroupCut[igr];
+            lSweep.fKind = lSweep.fCut < 0 ? kSweepLower : kV0SweepKind[lSweep.fCut];
+            lSweep.fOpenValue = lSweep.fKind == kSweepUpper ? std::numeric_limits<Double_t>::infinity() : -std::numeric_limits<Double_t>::infinity();
+            std::vector< std::pair<Double_t, TH3F*> > lEntries;
+            for( size_t j=0; j<lGroups[igr].size(); j++ ){
+                AliV0Result *lRes = lConfigs[ lGroups[igr][j] ];
+                Double_t lThreshold = lSweep.fCut < 0 ? 0 : GetSweepCut( lRes, lSweep.fCut );
+                //cut compared in single precision in the selection
+                if( lSweep.fCut >= 0 && kV0SweepFloat[lSweep.fCut] ) lThreshold = (Float_t) lThreshold;
+                lEntries.push_back( std::make_pair( lThreshold, lRes->GetHistogram() ) );
+            }
+            std::stable_sort( lEntries.begin(), lEntries.end() );
+            for( size_t j=0; j<lEntries.size(); j++ ){
+                lSweep.fThresholds.push_back( lEntries[j].first );
+                lSweep.fHistos.push_back( lEntries[j].second );
+            }
+            fV0Sweeps.push_back( lSweep );
+        }
+    }
+    
+    TList *lCascadeLists[4] = {fListXiMinus, fListXiPlus, fListOmegaMinus, fListOmegaPlus};
+    for( Int_t ilist=0; ilist<4; ilist++ ){
+        std::vector<AliCascadeResult*> lConfigs;
+        for( Int_t icfg=0; icfg<lCascadeLists[ilist]->GetEntries(); icfg++ ) lConfigs.push_back( (AliCascadeResult*) lCascadeLists[ilist]->At(icfg) );
+        GroupConfigurations( lConfigs, kNCascadeSweepCuts, fkConfigToSave, fkUseCutSweeps, lGroupCut, lGroups );
+        for( size_t igr=0; igr<lGroups.size(); igr++ ){
+            CutSweep lSweep;
+            lSweep.fConfig = lConfigs[ lGroups[igr][0] ];
+            lSweep.fList = ilist;
+            lSweep.fCut = lGroupCut[igr];
+            lSweep.fKind = lSweep.fCut < 0 ? kSweepLower : kCascadeSweepKind[lSweep.fCut];
+            lSweep.fOpenValue = lSweep.fKind == kSweepUpper ? std::numeric_limits<Double_t>::infinity() : -std::numeric_limits<Double_t>::infinity();
+            std::vector< std::pair<Double_t, TH3F*> > lEntries;
+            for( size_t j=0; j<lGroups[igr].size(); j++ ){
+                AliCascadeResult *lRes = lConfigs[ lGroups[igr][j] ];
+                Double_t lThreshold = lSweep.fCut < 0 ? 0 : GetSweepCut( lRes, lSweep.fCut );
+                //cut compared in single precision in the selection
+                if( lSweep.fCut >= 0 && kCascadeSweepFloat[lSweep.fCut] ) lThreshold = (Float_t) lThreshold;
+                lEntries.push_back( std::make_pair( lThreshold, lRes->GetHistogram() ) );
+            }
+            std::stable_sort( lEntries.begin(), lEntries.end() );
+            for( size_t j=0; j<lEntries.size(); j++ ){
+                lSweep.fThresholds.push_back( lEntries[j].first );
+                lSweep.fHistos.push_back( lEntries[j].second );
+            }
+            fCascadeSweeps.push_back( lSweep );
+        }
+    }
+    
+    Long_t lNGroups = 0, lNGrouped = 0;
+    for( size_t igr=0; igr<fV0Sweeps.size(); igr++ )
+        if( fV0Sweeps[igr].fCut >= 0 ){ lNGroups++; lNGrouped += fV0Sweeps[igr].fHistos.size(); }
+    for( size_t igr=0; igr<fCascadeSweeps.size(); igr++ )
+        if( fCascadeSweeps[igr].fCut >= 0 ){ lNGroups++; lNGrouped += fCascadeSweeps[igr].fHistos.size(); }
+    AliInfo( Form("Cut sweeps: %li configurations in %li groups, %li V0 and %li cascade checks per candidate",
+                  lNGrouped, lNGroups, (Long_t) fV0Sweeps.size(), (Long_t) fCascadeSweeps.size()) );
+}
+
+//________________________________________________________________________
+void AliAnalysisTaskStrangenessVsMultiplicityRun2::FillCutSweep(const CutSweep &lSweep, Double_t lValue, Double_t lPt, Double_t lMass)
+{
+    //Fills the histograms of the configurations whose swept cut is passed by lValue
+    const std::vector<Double_t> &lThr = lSweep.fThresholds;
+    size_t lFirst = 0, lLast = lThr.size();
+    switch( lSweep.fKind ){
+        case kSweepLower: //value > cut
+            lLast = std::lower_bound( lThr.begin(), lThr.end(), lValue ) - lThr.begin();
+            break;
+        case kSweepUpper: //value < cut
+            lFirst = std::upper_bound( lThr.begin(), lThr.end(), lValue ) - lThr.begin();
+            break;
+        case kSweepLowerOrNegative: //cut < 0 or value > cut
+            lLast = std::lower_bound( lThr.begin(), lThr.end(), lValue ) - lThr.begin();
+            lFirst = std::lower_bound( lThr.begin(), lThr.end(), 0.0 ) - lThr.begin();
+            if( lFirst > lLast ) lLast = lFirst;
+            lFirst = 0;
+            break;
+    }
+    for( size_t i=lFirst; i<lLast; i++ ) lSweep.fHistos[i] -> Fill ( fCentrality, lPt, lMass );
+}
+
+//________________________________________________________________________
+Double_t AliAnalysisTaskStrangenessVsMultiplicityRun2::GetV0SweepValue(Int_t lCut, Float_t lPDGMass, Float_t lNegdEdx, Float_t lPosdEdx, Float_t lLeastNcrOverLength) const
+{
+    //Variable compared to the swept cut, as in the V0 selection
+    switch( lCut ){
+        case kV0SweepV0Radius:                             return fTreeVariableV0Radius;
+        case kV0SweepMaxV0Radius:                          return fTreeVariableV0Radius;
+        case kV0SweepDCANegToPV:                           return fTreeVariableDcaNegToPrimVertex;
+        case kV0SweepDCAPosToPV:                           return fTreeVariableDcaPosToPrimVertex;
+        case kV0SweepDCAV0Daughters:                       return fTreeVariableDcaV0Daughters;
+        case kV0SweepV0CosPA:                              return fTreeVariableV0CosineOfPointingAngle;
+        case kV0SweepProperLifetime:                       return (Float_t) (fTreeVariableDistOverTotMom*lPDGMass);
+        case kV0SweepLeastNumberOfCrossedRows:             return fTreeVariableLeastNbrCrossedRows;
+        case kV0SweepLeastNumberOfCrossedRowsOverFindable: return fTreeVariableLeastRatioCrossedRowsOverFindable;
+        case kV0SweepTPCdEdx:                              return SweepMax( TMath::Abs(lNegdEdx), TMath::Abs(lPosdEdx) );
+        case kV0SweepMinTrackLength:                       return fTreeVariableMinTrackLength;
+        case kV0SweepMinCrossedRowsOverLength:             return lLeastNcrOverLength;
+    }
+    return 0;
+}
+
+//________________________________________________________________________
+Double_t AliAnalysisTaskStrangenessVsMultiplicityRun2::GetCascadeSweepValue(Int_t lCut, Float_t lPDGMass, Float_t lV0Mass, Float_t lNegdEdx, Float_t lPosdEdx, Float_t lBachdEdx, Float_t lLeastNcrOverLength, Int_t lLeastNbrCrossedRows) const
+{
+    //Variable compared to the swept cut, as in the cascade selection
+    switch( lCut ){
+        case kCascSweepDCANegToPV:               return fTreeCascVarDCANegToPrimVtx;
+        case kCascSweepDCAPosToPV:               return fTreeCascVarDCAPosToPrimVtx;
+        case kCascSweepDCAV0Daughters:           return fTreeCascVarDCAV0Daughters;
+        case kCascSweepV0CosPA:                  return fTreeCascVarV0CosPointingAngle;
+        case kCascSweepV0Radius:                 return fTreeCascVarV0Radius;
+        case kCascSweepDCAV0ToPV:                return fTreeCascVarDCAV0ToPrimVtx;
+        case kCascSweepV0Mass:                   return TMath::Abs(lV0Mass-1.116);
+        case kCascSweepDCABachToPV:              return fTreeCascVarDCABachToPrimVtx;
+        case kCascSweepDCACascDaughters:         return fTreeCascVarDCACascDaughters;
+        case kCascSweepCascCosPA:                return fTreeCascVarCascCosPointingAngle;
+        case kCascSweepCascRadius:               return fTreeCascVarCascRadius;
+        case kCascSweepProperLifetime:           return (Float_t) (fTreeCascVarDistOverTotMom*lPDGMass);
+        case kCascSweepLeastNumberOfClusters:    return fTreeCascVarLeastNbrClusters;
+        case kCascSweepTPCdEdx:                  return SweepMax( SweepMax( TMath::Abs(lNegdEdx), TMath::Abs(lPosdEdx) ), TMath::Abs(lBachdEdx) );
+        case kCascSweepDCABachToBaryon:          return fTreeCascVarDCABachToBaryon;
+        case kCascSweepBachBaryonCosPA:          return fTreeCascVarWrongCosPA;
+        case kCascSweepMinTrackLength:           return fTreeCascVarMinTrackLength;
+        case kCascSweepMinCrossedRowsOverLength: return lLeastNcrOverLength;
+        case kCascSweepLeastNumberOfCrossedRows: return lLeastNbrCrossedRows;
+    }
+    return 0;
+}
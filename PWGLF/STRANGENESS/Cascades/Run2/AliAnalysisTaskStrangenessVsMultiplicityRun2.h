@@ -46,6 +46,8 @@ class AliV0Result;
 class AliCascadeResult;
 class AliExternalTrackParam;
 
+#include <vector>
+
 //#include "TString.h"
 //#include "AliESDtrackCuts.h"
 #include "AliAnalysisTaskSE.h"
@@ -229,6 +231,9 @@ public:
         fkSaveSpecificConfig = kTRUE; 
     }
 //---------------------------------------------------------------------------------------
+    //Cut sweeps: configurations differing only in one threshold are checked together
+    void SetUseCutSweeps(Bool_t lOpt = kTRUE) { fkUseCutSweeps = lOpt; }
+//---------------------------------------------------------------------------------------
     
 private:
     // Note : In ROOT, "//!" means "do not stream the data from Master node to Worker node" ...
@@ -306,6 +311,9 @@ private:
     Bool_t fkSaveSpecificConfig;
     TString fkConfigToSave; 
     
+    //if true, configurations differing only in one threshold are checked together
+    Bool_t fkUseCutSweeps;
+    
 //===========================================================================================
 //   Variables for Event Tree
 //===========================================================================================
@@ -663,11 +671,37 @@ private:
     TH1D *fHistCentrality; //!
     TH2D *fHistEventMatrix; //!
 
+//===========================================================================================
+//   Cut sweeps
+//===========================================================================================
+    //Group of configurations identical except for one threshold ("swept cut"):
+    //the other selections are checked once with the first configuration, with its
+    //swept cut opened, and the configurations passing the swept cut are found by
+    //binary search in the sorted thresholds. A configuration which cannot be grouped
+    //is a group on its own (fCut = -1).
+    struct CutSweep {
+        TObject *fConfig;                  //configuration used for the checks
+        Int_t fList;                       //output list of the configurations
+        Int_t fCut;                        //swept cut (-1: single configuration)
+        Int_t fKind;                       //kind of threshold of the swept cut
+        Double_t fOpenValue;               //swept cut value letting every candidate pass
+        std::vector<Double_t> fThresholds; //thresholds of the configurations, increasing
+        std::vector<TH3F*> fHistos;        //histograms of the configurations, same order
+    };
+    std::vector<CutSweep> fV0Sweeps;       //!
+    std::vector<CutSweep> fCascadeSweeps;  //!
+
+    void BuildCutSweeps();
+    void FillCutSweep(const CutSweep &lSweep, Double_t lValue, Double_t lPt, Double_t lMass);
+    Double_t GetV0SweepValue(Int_t lCut, Float_t lPDGMass, Float_t lNegdEdx, Float_t lPosdEdx, Float_t lLeastNcrOverLength) const;
+    Double_t GetCascadeSweepValue(Int_t lCut, Float_t lPDGMass, Float_t lV0Mass, Float_t lNegdEdx, Float_t lPosdEdx, Float_t lBachdEdx, Float_t lLeastNcrOverLength, Int_t lLeastNbrCrossedRows) const;
+
     AliAnalysisTaskStrangenessVsMultiplicityRun2(const AliAnalysisTaskStrangenessVsMultiplicityRun2&);            // not implemented
     AliAnalysisTaskStrangenessVsMultiplicityRun2& operator=(const AliAnalysisTaskStrangenessVsMultiplicityRun2&); // not implemented
 
-    ClassDef(AliAnalysisTaskStrangenessVsMultiplicityRun2, 4);
+    ClassDef(AliAnalysisTaskStrangenessVsMultiplicityRun2, 5);
     //1: first implementation
+    //5: cut sweeps
 };
 
 #endif
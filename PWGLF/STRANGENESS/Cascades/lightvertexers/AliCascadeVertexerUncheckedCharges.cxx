@@ -25,12 +25,30 @@
 //modified by I. Belikov 24/11/2006 : static setter for the default cuts
 
 #include "TRandom3.h"
+#include "TArrayD.h"
 #include "AliESDEvent.h"
 #include "AliESDcascade.h"
 #include "AliCascadeVertexerUncheckedCharges.h"
 
 ClassImp(AliCascadeVertexerUncheckedCharges)
 
+//________________________________________________________________________
+// Pre-filter of the V0-bachelor pairs: straight-line DCA of PropagateToDCA,
+// evaluated from the cached bachelor position and momentum before the track
+// is copied and propagated. Returns -1 for (almost) parallel lines, for which
+// the pre-filter is not applied.
+static Double_t GetStraightLineDCA(const Double_t r1[3], const Double_t p1[3],
+                                   const Double_t r2[3], const Double_t p2[3]) {
+    Double_t ax= p1[1]*p2[2] - p1[2]*p2[1];
+    Double_t ay=-p1[0]*p2[2] + p1[2]*p2[0];
+    Double_t az= p1[0]*p2[1] - p1[1]*p2[0];
+    Double_t norm=TMath::Sqrt(ax*ax + ay*ay + az*az);
+    Double_t p1norm=TMath::Sqrt(p1[0]*p1[0] + p1[1]*p1[1] + p1[2]*p1[2]);
+    Double_t p2norm=TMath::Sqrt(p2[0]*p2[0] + p2[1]*p2[1] + p2[2]*p2[2]);
+    if (!(norm > 1e-6*p1norm*p2norm)) return -1.;
+    return TMath::Abs((r2[0]-r1[0])*ax + (r2[1]-r1[1])*ay + (r2[2]-r1[2])*az)/norm;
+}
+
 //A set of loose cuts
 Double_t
 AliCascadeVertexerUncheckedCharges::fgChi2max=33.;   //maximal allowed chi2
@@ -98,6 +116,8 @@ Int_t AliCascadeVertexerUncheckedCharges::V0sTracks2CascadeVertices(AliESDEvent
     // stores relevant tracks in another array
     Int_t nentr=(Int_t)event->GetNumberOfTracks();
     TArrayI trk(nentr); Int_t ntr=0;
+    //Pre-filter: position and momentum of the bachelor candidates
+    TArrayD trkR(3*nentr), trkP(3*nentr);
     for (i=0; i<nentr; i++) {
         AliESDtrack *esdtr=event->GetTrack(i);
         
@@ -111,6 +131,8 @@ Int_t AliCascadeVertexerUncheckedCharges::V0sTracks2CascadeVertices(AliESDEvent
         
         if (TMath::Abs(esdtr->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDBachMin) continue;
         
+        esdtr->GetXYZ(trkR.GetArray()+3*ntr);
+        esdtr->GetPxPyPz(trkP.GetArray()+3*ntr);
         trk[ntr++]=i;
     }
     
@@ -136,6 +158,9 @@ Int_t AliCascadeVertexerUncheckedCharges::V0sTracks2CascadeVertices(AliESDEvent
         //Only disregard if it does not pass any of the desired hypotheses
         if (TMath::Abs(lMassAsLambda-massLambda)>fMassWin &&
             TMath::Abs(lMassAsAntiLambda-massLambda)>fMassWin) continue;
+        Double_t v0R[3], v0P[3];
+        v0.GetXYZ(v0R[0],v0R[1],v0R[2]);
+        v0.GetPxPyPz(v0P[0],v0P[1],v0P[2]);
         
         for (Int_t j=0; j<ntr; j++) {//loop on tracks
             Int_t bidx=trk[j];
@@ -147,6 +172,9 @@ Int_t AliCascadeVertexerUncheckedCharges::V0sTracks2CascadeVertices(AliESDEvent
             AliESDtrack *btrk=event->GetTrack(bidx);
             
             //Do not check charges!
+            //Pre-filter: straight lines too far apart
+            if (GetStraightLineDCA(trkR.GetArray()+3*j,trkP.GetArray()+3*j,v0R,v0P) > fDCAmax + 1e-6) continue;
+            
             AliESDv0 *pv0=&v0;
             AliExternalTrackParam bt(*btrk), *pbt=&bt;
             
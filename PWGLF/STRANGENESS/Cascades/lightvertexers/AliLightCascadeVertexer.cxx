@@ -24,12 +24,30 @@
 //modified by R. Vernet  3/7/2006 : causality
 //modified by I. Belikov 24/11/2006 : static setter for the default cuts
 
+#include "TArrayD.h"
 #include "AliESDEvent.h"
 #include "AliESDcascade.h"
 #include "AliLightCascadeVertexer.h"
 
 ClassImp(AliLightCascadeVertexer)
 
+//________________________________________________________________________
+// Pre-filter of the V0-bachelor pairs: straight-line DCA of PropagateToDCA,
+// evaluated from the cached bachelor position and momentum before the track
+// is copied and propagated. Returns -1 for (almost) parallel lines, for which
+// the pre-filter is not applied.
+static Double_t GetStraightLineDCA(const Double_t r1[3], const Double_t p1[3],
+                                   const Double_t r2[3], const Double_t p2[3]) {
+    Double_t ax= p1[1]*p2[2] - p1[2]*p2[1];
+    Double_t ay=-p1[0]*p2[2] + p1[2]*p2[0];
+    Double_t az= p1[0]*p2[1] - p1[1]*p2[0];
+    Double_t norm=TMath::Sqrt(ax*ax + ay*ay + az*az);
+    Double_t p1norm=TMath::Sqrt(p1[0]*p1[0] + p1[1]*p1[1] + p1[2]*p1[2]);
+    Double_t p2norm=TMath::Sqrt(p2[0]*p2[0] + p2[1]*p2[1] + p2[2]*p2[2]);
+    if (!(norm > 1e-6*p1norm*p2norm)) return -1.;
+    return TMath::Abs((r2[0]-r1[0])*ax + (r2[1]-r1[1])*ay + (r2[2]-r1[2])*az)/norm;
+}
+
 //A set of loose cuts
 Double_t 
   AliLightCascadeVertexer::fgChi2max=33.;   //maximal allowed chi2 
@@ -140,6 +158,8 @@ Int_t AliLightCascadeVertexer::V0sTracks2CascadeVertices(AliESDEvent *event) {
    // stores relevant tracks in another array
    Int_t nentr=(Int_t)event->GetNumberOfTracks();
    TArrayI trk(nentr); Int_t ntr=0;
+   //Pre-filter: position and momentum of the bachelor candidates
+   TArrayD trkR(3*nentr), trkP(3*nentr);
    for (i=0; i<nentr; i++) {
        AliESDtrack *esdtr=event->GetTrack(i);
        ULong_t status=esdtr->GetStatus();
@@ -152,6 +172,8 @@ Int_t AliLightCascadeVertexer::V0sTracks2CascadeVertices(AliESDEvent *event) {
 
        if (TMath::Abs(esdtr->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDBachMin) continue;
 
+       esdtr->GetXYZ(trkR.GetArray()+3*ntr);
+       esdtr->GetPxPyPz(trkP.GetArray()+3*ntr);
        trk[ntr++]=i;
    }   
 
@@ -166,6 +188,9 @@ Int_t AliLightCascadeVertexer::V0sTracks2CascadeVertices(AliESDEvent *event) {
       AliESDv0 v0(*v);
       v0.ChangeMassHypothesis(kLambda0); // the v0 must be Lambda 
       if (TMath::Abs(v0.GetEffMass()-massLambda)>fMassWin) continue; 
+      Double_t v0R[3], v0P[3];
+      v0.GetXYZ(v0R[0],v0R[1],v0R[2]);
+      v0.GetPxPyPz(v0P[0],v0P[1],v0P[2]);
 
       for (Int_t j=0; j<ntr; j++) {//loop on tracks
 	 Int_t bidx=trk[j];
@@ -178,6 +203,9 @@ Int_t AliLightCascadeVertexer::V0sTracks2CascadeVertices(AliESDEvent *event) {
          if (!fSwitchCharges && btrk->GetSign()>0) continue;  // bachelor's charge
          if ( fSwitchCharges && btrk->GetSign()<0) continue;  // bachelor's charge
           
+         //Pre-filter: straight lines too far apart
+         if (GetStraightLineDCA(trkR.GetArray()+3*j,trkP.GetArray()+3*j,v0R,v0P) > fDCAmax + 1e-6) continue;
+
     	 AliESDv0 *pv0=&v0;
          AliExternalTrackParam bt(*btrk), *pbt=&bt;
 
@@ -217,6 +245,9 @@ Int_t AliLightCascadeVertexer::V0sTracks2CascadeVertices(AliESDEvent *event) {
       AliESDv0 v0(*v);
       v0.ChangeMassHypothesis(kLambda0Bar); //the v0 must be anti-Lambda 
       if (TMath::Abs(v0.GetEffMass()-massLambda)>fMassWin) continue; 
+      Double_t v0R[3], v0P[3];
+      v0.GetXYZ(v0R[0],v0R[1],v0R[2]);
+      v0.GetPxPyPz(v0P[0],v0P[1],v0P[2]);
 
       for (Int_t j=0; j<ntr; j++) {//loop on tracks
 	 Int_t bidx=trk[j];
@@ -229,6 +260,9 @@ Int_t AliLightCascadeVertexer::V0sTracks2CascadeVertices(AliESDEvent *event) {
          if (!fSwitchCharges && btrk->GetSign()<0) continue;  // bachelor's charge
          if ( fSwitchCharges && btrk->GetSign()>0) continue;  // bachelor's charge
           
+         //Pre-filter: straight lines too far apart
+         if (GetStraightLineDCA(trkR.GetArray()+3*j,trkP.GetArray()+3*j,v0R,v0P) > fDCAmax + 1e-6) continue;
+
 	 AliESDv0 *pv0=&v0;
          AliExternalTrackParam bt(*btrk), *pbt=&bt;
 
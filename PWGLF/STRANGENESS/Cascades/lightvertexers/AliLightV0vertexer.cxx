@@ -25,12 +25,48 @@
 //          This is still being tested! Use at your own risk!
 //-------------------------------------------------------------------------
 
+#include "TArrayD.h"
 #include "AliESDEvent.h"
 #include "AliESDv0.h"
 #include "AliLightV0vertexer.h"
 
 ClassImp(AliLightV0vertexer)
 
+//________________________________________________________________________
+// Pre-filter of the track pairs: AliExternalTrackParam::GetDCA returns
+// sqrt(dm*sqrt(dy2*dz2)), dm being the minimum over the two helices of the
+// distance squared weighted with dy2 (transverse) and dz2 (longitudinal),
+// the sums of the SigmaY2 and SigmaZ2 of the tracks. The transverse distance
+// of two points of the helices can not be smaller than the gap between their
+// projections (circles) in the transverse plane, so the DCA is at least
+// gap*(dz2/dy2)^(1/4). Pairs for which this bound exceeds the maximal DCA
+// are rejected before the minimisation.
+static Bool_t GetTransverseCircle(const AliExternalTrackParam *t, Double_t b,
+                                  Double_t &xc, Double_t &yc, Double_t &r) {
+    Double_t h[6]; t->GetHelixParameters(h,b);
+    if (TMath::Abs(h[4]) < 1e-10) return kFALSE; //(almost) straight track: no pre-filter
+    xc = h[5] - TMath::Sin(h[2])/h[4];
+    yc = h[0] + TMath::Cos(h[2])/h[4];
+    r  = TMath::Abs(1./h[4]);
+    return kTRUE;
+}
+
+static Bool_t AreCirclesApart(Double_t xc1, Double_t yc1, Double_t r1,
+                              Double_t xc2, Double_t yc2, Double_t r2,
+                              Double_t dy2, Double_t dz2, Double_t dcamax) {
+    Double_t d=TMath::Sqrt((xc1-xc2)*(xc1-xc2) + (yc1-yc2)*(yc1-yc2));
+    Double_t dist=0.;
+    if (d > r1+r2) dist=d-r1-r2;                           //separated circles
+    else if (d < TMath::Abs(r1-r2)) dist=TMath::Abs(r1-r2)-d; //one inside the other
+    //safety margin for the rounding in the helix evaluation
+    Double_t dcacut=dcamax + 1e-4 + 1e-9*(r1+r2+d);
+    if (dist <= dcacut) return kFALSE;
+    if (!(dy2 > 0.) || !(dz2 > 0.)) return kFALSE;
+    //lower bound of the covariance weighted DCA, never above the gap
+    if (dz2 < dy2) dist*=TMath::Power(dz2/dy2, 0.25);
+    return dist > dcacut;
+}
+
 
 //A set of very loose cuts
 Double_t AliLightV0vertexer::fgChi2max=33.; //max chi2
@@ -63,6 +99,12 @@ Int_t AliLightV0vertexer::Tracks2V0vertices(AliESDEvent *event) {
     TArrayI neg(nentr);
     TArrayI pos(nentr);
     
+    //Pre-filter: impact parameter and transverse circle of each selected track
+    TArrayD negD(nentr), negXc(nentr), negYc(nentr), negR(nentr);
+    TArrayD posD(nentr), posXc(nentr), posYc(nentr), posR(nentr);
+    TArrayD negSy2(nentr), negSz2(nentr), posSy2(nentr), posSz2(nentr);
+    TArrayI negCircle(nentr), posCircle(nentr);
+    
     Int_t nneg=0, npos=0, nvtx=0;
     
     Int_t i;
@@ -80,8 +122,19 @@ Int_t AliLightV0vertexer::Tracks2V0vertices(AliESDEvent *event) {
         if (TMath::Abs(d)<fDPmin) continue;
         if (TMath::Abs(d)>fRmax) continue;
         
-        if (esdTrack->GetSign() < 0.) neg[nneg++]=i;
-        else pos[npos++]=i;
+        Double_t xc=0, yc=0, r=0;
+        Bool_t circle=GetTransverseCircle(esdTrack,b,xc,yc,r);
+        if (esdTrack->GetSign() < 0.) {
+            negD[nneg]=TMath::Abs(d); negCircle[nneg]=circle;
+            negXc[nneg]=xc; negYc[nneg]=yc; negR[nneg]=r;
+            negSy2[nneg]=esdTrack->GetSigmaY2(); negSz2[nneg]=esdTrack->GetSigmaZ2();
+            neg[nneg++]=i;
+        } else {
+            posD[npos]=TMath::Abs(d); posCircle[npos]=circle;
+            posXc[npos]=xc; posYc[npos]=yc; posR[npos]=r;
+            posSy2[npos]=esdTrack->GetSigmaY2(); posSz2[npos]=esdTrack->GetSigmaZ2();
+            pos[npos++]=i;
+        }
     }
     
     
@@ -90,14 +143,18 @@ Int_t AliLightV0vertexer::Tracks2V0vertices(AliESDEvent *event) {
         AliESDtrack *ntrk=event->GetTrack(nidx);
         
         for (Int_t k=0; k<npos; k++) {
-            Int_t pidx=pos[k];
-            AliESDtrack *ptrk=event->GetTrack(pidx);
+            //Track pre-selection (clusters) already applied above
+            
+            if (negD[i]<fDNmin)
+                if (posD[k]<fDNmin) continue;
             
-            //Track pre-selection: clusters
-            if (ptrk->GetTPCNcls() < fMinClusters ) continue;
+            //Pre-filter: transverse circles too far apart
+            if (negCircle[i] && posCircle[k] &&
+                AreCirclesApart(negXc[i],negYc[i],negR[i],posXc[k],posYc[k],posR[k],
+                                negSy2[i]+posSy2[k],negSz2[i]+posSz2[k],fDCAmax)) continue;
             
-            if (TMath::Abs(ntrk->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDNmin)
-                if (TMath::Abs(ptrk->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDNmin) continue;
+            Int_t pidx=pos[k];
+            AliESDtrack *ptrk=event->GetTrack(pidx);
             
             Double_t xn, xp, dca=ntrk->GetDCA(ptrk,b,xn,xp);
             if (dca > fDCAmax) continue;
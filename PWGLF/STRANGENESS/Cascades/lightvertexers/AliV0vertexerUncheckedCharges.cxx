@@ -28,12 +28,48 @@
 //          This is still being tested! Use at your own risk!
 //-------------------------------------------------------------------------
 
+#include "TArrayD.h"
 #include "AliESDEvent.h"
 #include "AliESDv0.h"
 #include "AliV0vertexerUncheckedCharges.h"
 
 ClassImp(AliV0vertexerUncheckedCharges)
 
+//________________________________________________________________________
+// Pre-filter of the track pairs: AliExternalTrackParam::GetDCA returns
+// sqrt(dm*sqrt(dy2*dz2)), dm being the minimum over the two helices of the
+// distance squared weighted with dy2 (transverse) and dz2 (longitudinal),
+// the sums of the SigmaY2 and SigmaZ2 of the tracks. The transverse distance
+// of two points of the helices can not be smaller than the gap between their
+// projections (circles) in the transverse plane, so the DCA is at least
+// gap*(dz2/dy2)^(1/4). Pairs for which this bound exceeds the maximal DCA
+// are rejected before the minimisation.
+static Bool_t GetTransverseCircle(const AliExternalTrackParam *t, Double_t b,
+                                  Double_t &xc, Double_t &yc, Double_t &r) {
+    Double_t h[6]; t->GetHelixParameters(h,b);
+    if (TMath::Abs(h[4]) < 1e-10) return kFALSE; //(almost) straight track: no pre-filter
+    xc = h[5] - TMath::Sin(h[2])/h[4];
+    yc = h[0] + TMath::Cos(h[2])/h[4];
+    r  = TMath::Abs(1./h[4]);
+    return kTRUE;
+}
+
+static Bool_t AreCirclesApart(Double_t xc1, Double_t yc1, Double_t r1,
+                              Double_t xc2, Double_t yc2, Double_t r2,
+                              Double_t dy2, Double_t dz2, Double_t dcamax) {
+    Double_t d=TMath::Sqrt((xc1-xc2)*(xc1-xc2) + (yc1-yc2)*(yc1-yc2));
+    Double_t dist=0.;
+    if (d > r1+r2) dist=d-r1-r2;                           //separated circles
+    else if (d < TMath::Abs(r1-r2)) dist=TMath::Abs(r1-r2)-d; //one inside the other
+    //safety margin for the rounding in the helix evaluation
+    Double_t dcacut=dcamax + 1e-4 + 1e-9*(r1+r2+d);
+    if (dist <= dcacut) return kFALSE;
+    if (!(dy2 > 0.) || !(dz2 > 0.)) return kFALSE;
+    //lower bound of the covariance weighted DCA, never above the gap
+    if (dz2 < dy2) dist*=TMath::Power(dz2/dy2, 0.25);
+    return dist > dcacut;
+}
+
 
 //A set of very loose cuts
 Double_t AliV0vertexerUncheckedCharges::fgChi2max=33.; //max chi2
@@ -65,6 +101,11 @@ Int_t AliV0vertexerUncheckedCharges::Tracks2V0vertices(AliESDEvent *event) {
     
     TArrayI trackarray(nentr);
     
+    //Pre-filter: impact parameter and transverse circle of each selected track
+    TArrayD trackD(nentr), trackXc(nentr), trackYc(nentr), trackR(nentr);
+    TArrayD trackSy2(nentr), trackSz2(nentr);
+    TArrayI trackCircle(nentr);
+    
     Int_t ntracks=0, nvtx=0;
     
     Int_t i;
@@ -83,6 +124,11 @@ Int_t AliV0vertexerUncheckedCharges::Tracks2V0vertices(AliESDEvent *event) {
         if (TMath::Abs(d)>fRmax) continue;
         
         //Disregard charges
+        Double_t xc=0, yc=0, r=0;
+        trackCircle[ntracks]=GetTransverseCircle(esdTrack,b,xc,yc,r);
+        trackD[ntracks]=TMath::Abs(d);
+        trackXc[ntracks]=xc; trackYc[ntracks]=yc; trackR[ntracks]=r;
+        trackSy2[ntracks]=esdTrack->GetSigmaY2(); trackSz2[ntracks]=esdTrack->GetSigmaZ2();
         trackarray[ntracks++]=i;
     }
     
@@ -95,14 +141,18 @@ Int_t AliV0vertexerUncheckedCharges::Tracks2V0vertices(AliESDEvent *event) {
         for (Int_t k=0; k<ntracks; k++) {
             if( i==k ) continue; //don't combine a track with itself, please
             
+            if (trackD[i]<fDNmin)
+                if (trackD[k]<fDNmin) continue;
+            
+            //Pre-filter: transverse circles too far apart
+            if (trackCircle[i] && trackCircle[k] &&
+                AreCirclesApart(trackXc[i],trackYc[i],trackR[i],trackXc[k],trackYc[k],trackR[k],
+                                trackSy2[i]+trackSy2[k],trackSz2[i]+trackSz2[k],fDCAmax)) continue;
+            
             //originally: positive (now track 2) 
             Int_t idx2=trackarray[k];
             AliESDtrack *trk2=event->GetTrack(idx2);
             
-            
-            if (TMath::Abs(trk1->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDNmin)
-                if (TMath::Abs(trk2->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDNmin) continue;
-            
             Double_t xn, xp, dca=trk1->GetDCA(trk2,b,xn,xp);
             if (dca > fDCAmax) continue;
             if ((xn+xp) > 2*fRmax) continue;
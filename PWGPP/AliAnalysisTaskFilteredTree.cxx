@@ -35,6 +35,8 @@
 */
 
 #include "iostream"
+#include "RConfigure.h"
+#include "TROOT.h"
 #include "TSystem.h"
 #include <TPDGCode.h>
 #include <TDatabasePDG.h>
@@ -43,6 +45,7 @@
 #include "TTreeStream.h"
 #include "TTree.h"
 #include "TH1F.h"
+#include "TH2.h"
 #include "TH3.h"
 #include "TCanvas.h"
 #include "TList.h"
@@ -124,12 +127,22 @@ ClassImp(AliAnalysisTaskFilteredTree)
   , fProcessAll(kFALSE)
   , fProcessCosmics(kFALSE)
   , fProcessITSTPCmatchOut(kFALSE)  // swittch to process ITS/TPC standalone tracks
+  , fStreamAutoFlush()
+  , fNumberOfWriterThreads(0)
+  , fImplicitMTEnabled(kFALSE)
   , fHighPtTree(0)
   , fV0Tree(0)
   , fdEdxTree(0)
   , fLaserTree(0)
   , fMCEffTree(0)
   , fCosmicPairsTree(0)
+  , fHighPtStream(0)
+  , fV0Stream(0)
+  , fdEdxStream(0)
+  , fLaserStream(0)
+  , fMCEffStream(0)
+  , fCosmicPairsStream(0)
+  , fStreamCounters(0)
   , fSelectedTracksMask(0)   //! histogram of the selected tracks
   , fSelectedPIDMask(0)   //! histogram of the selected tracks
   , fSelectedV0Mask(0)       //! histogram of the selected V0s
@@ -170,6 +183,7 @@ AliAnalysisTaskFilteredTree::~AliAnalysisTaskFilteredTree()
   delete fFilteredTreeAcceptanceCuts;
   delete fFilteredTreeRecAcceptanceCuts;
   delete fEsdTrackCuts;
+  DisableImplicitMT();
 }
 
 //____________________________________________________________________________
@@ -210,15 +224,64 @@ void AliAnalysisTaskFilteredTree::UserCreateOutputObjects()
   //get the output file to make sure the trees will be associated to it
   OpenFile(1);
   fTreeSRedirector = new TTreeSRedirector();
+  // Pool of threads used by ROOT to compress the baskets of the output trees. The pool is global:
+  // an already enabled one is reused as it is, otherwise it is created here and disabled again once
+  // the streams are written (FinishTaskOutput)
+  if (fNumberOfWriterThreads > 0) {
+#ifdef R__USE_IMT
+    if (!ROOT::IsImplicitMTEnabled()) {
+      ROOT::EnableImplicitMT(fNumberOfWriterThreads);
+      fImplicitMTEnabled = kTRUE;
+    }
+#else
+    AliWarning("ROOT built without implicit MT support: the baskets are compressed on the event loop");
+#endif
+  }
 
   //
   // Create trees
-  fV0Tree = ((*fTreeSRedirector)<<"V0s").GetTree();
-  fHighPtTree = ((*fTreeSRedirector)<<"highPt").GetTree();
-  fdEdxTree = ((*fTreeSRedirector)<<"dEdx").GetTree();
-  fLaserTree = ((*fTreeSRedirector)<<"Laser").GetTree();
-  fMCEffTree = ((*fTreeSRedirector)<<"MCEffTree").GetTree();
-  fCosmicPairsTree = ((*fTreeSRedirector)<<"CosmicPairs").GetTree();
+  // The streams are registered once - the event loop fills them through the handles instead of the name lookup
+  fV0Stream = &((*fTreeSRedirector)<<"V0s");
+  fHighPtStream = &((*fTreeSRedirector)<<"highPt");
+  fdEdxStream = &((*fTreeSRedirector)<<"dEdx");
+  fLaserStream = &((*fTreeSRedirector)<<"Laser");
+  fMCEffStream = &((*fTreeSRedirector)<<"MCEffTree");
+  fCosmicPairsStream = &((*fTreeSRedirector)<<"CosmicPairs");
+  fV0Tree = fV0Stream->GetTree();
+  fHighPtTree = fHighPtStream->GetTree();
+  fdEdxTree = fdEdxStream->GetTree();
+  fLaserTree = fLaserStream->GetTree();
+  fMCEffTree = fMCEffStream->GetTree();
+  fCosmicPairsTree = fCosmicPairsStream->GetTree();
+  TTree *streamTrees[kNOutputStreams] = {fV0Tree, fHighPtTree, fdEdxTree, fLaserTree, fMCEffTree, fCosmicPairsTree};
+  for (Int_t i=0; i<kNOutputStreams; i++) {
+    // each stream buffers its own cluster of entries before the baskets are compressed
+    if (fStreamAutoFlush[i]!=0) streamTrees[i]->SetAutoFlush(fStreamAutoFlush[i]);
+#ifdef R__USE_IMT
+    streamTrees[i]->SetImplicitMT(fNumberOfWriterThreads > 0);
+#endif
+  }
+
+  //if set, use the environment variables to set the downscaling factors
+  //AliAnalysisTaskFilteredTree_fLowPtTrackDownscaligF
+  //AliAnalysisTaskFilteredTree_fLowPtV0DownscaligF
+  //AliAnalysisTaskFilteredTree_fFriendDownscaling
+  TString env;
+  env = gSystem->Getenv("AliAnalysisTaskFilteredTree_fLowPtTrackDownscaligF");
+  if (!env.IsNull()){
+    fLowPtTrackDownscaligF=env.Atof();
+    AliInfo(Form("fLowPtTrackDownscaligF=%f",fLowPtTrackDownscaligF));
+  }
+  env = gSystem->Getenv("AliAnalysisTaskFilteredTree_fLowPtV0DownscaligF");
+  if (!env.IsNull()){
+    fLowPtV0DownscaligF=env.Atof();
+    AliInfo(Form("fLowPtV0DownscaligF=%f",fLowPtV0DownscaligF));
+  }
+  env = gSystem->Getenv("AliAnalysisTaskFilteredTree_fFriendDownscaling");
+  if (!env.IsNull()){
+    fFriendDownscaling=env.Atof();
+    AliInfo(Form(" fFriendDownscaling=%f",fFriendDownscaling));
+  }
 
   if (!fDummyTrack)  {
     fDummyTrack=new AliESDtrack();
@@ -278,6 +341,12 @@ void AliAnalysisTaskFilteredTree::UserCreateOutputObjects()
   fSelectedTracksMask=new TH1F("selectedTracksMask","selectedTracksMask",32,0,32);
   fSelectedPIDMask=new TH1F("selectedPIDMask","selectedPIDMask",32,0,32);
   fSelectedV0Mask=new TH1F("selectedV0Mask","selectedV0Mask",64,0,64);
+  const char *streamNames[kNOutputStreams] = {"V0s", "highPt", "dEdx", "Laser", "MCEffTree", "CosmicPairs"};
+  fStreamCounters=new TH2D("streamCounters","entries and bytes per output stream",kNOutputStreams,0,kNOutputStreams,3,0,3);
+  for (Int_t i=0; i<kNOutputStreams; i++) fStreamCounters->GetXaxis()->SetBinLabel(i+1,streamNames[i]);
+  fStreamCounters->GetYaxis()->SetBinLabel(1,"entries");
+  fStreamCounters->GetYaxis()->SetBinLabel(2,"totBytes");
+  fStreamCounters->GetYaxis()->SetBinLabel(3,"zipBytes");
 
   fPtResPhiPtTPC = new TH3D("fPtResPhiPtTPC","pt rel. resolution from cov. matrix TPC tracks",nbinsPt,binsPt,nbinsPhi,binsPhi,nbins1PtRes,bins1PtRes);
   fPtResPhiPtTPCc = new TH3D("fPtResPhiPtTPCc","pt rel. resolution from cov. matrix TPC constrained tracks",nbinsPt,binsPt,nbinsPhi,binsPhi,nbins1PtRes,bins1PtRes);
@@ -298,6 +367,7 @@ void AliAnalysisTaskFilteredTree::UserCreateOutputObjects()
   fOutput->Add(fSelectedTracksMask);
   fOutput->Add(fSelectedPIDMask);
   fOutput->Add(fSelectedV0Mask);
+  fOutput->Add(fStreamCounters);
 
 
   fOutput->Add(fPtResPhiPtTPC);
@@ -370,27 +440,6 @@ void AliAnalysisTaskFilteredTree::UserExec(Option_t *)
   fESDtool->CalculateEventVariables();
   fESDtool->SetMCEvent(fMC);
   fESDtool->DumpEventVariables();
-
-  //if set, use the environment variables to set the downscaling factors
-  //AliAnalysisTaskFilteredTree_fLowPtTrackDownscaligF
-  //AliAnalysisTaskFilteredTree_fLowPtV0DownscaligF
-  //AliAnalysisTaskFilteredTree_fFriendDownscaling
-  TString env;
-  env = gSystem->Getenv("AliAnalysisTaskFilteredTree_fLowPtTrackDownscaligF");
-  if (!env.IsNull()){
-    fLowPtTrackDownscaligF=env.Atof();
-    AliInfo(Form("fLowPtTrackDownscaligF=%f",fLowPtTrackDownscaligF));
-  }
-  env = gSystem->Getenv("AliAnalysisTaskFilteredTree_fLowPtV0DownscaligF");
-  if (!env.IsNull()){
-    fLowPtV0DownscaligF=env.Atof();
-    AliInfo(Form("fLowPtV0DownscaligF=%f",fLowPtTrackDownscaligF));
-  }
-  env = gSystem->Getenv("AliAnalysisTaskFilteredTree_fFriendDownscaling");
-  if (!env.IsNull()){
-    fFriendDownscaling=env.Atof();
-    AliInfo(Form(" fFriendDownscaling=%f",fFriendDownscaling));
-  }
   //
   //
   //
@@ -526,8 +575,8 @@ void AliAnalysisTaskFilteredTree::ProcessCosmics(AliESDEvent *const event, AliES
 	}
       }
       if (fFriendDownscaling<=0){
-	if (((*fTreeSRedirector)<<"CosmicPairs").GetTree()){
-	  TTree * tree = ((*fTreeSRedirector)<<"CosmicPairs").GetTree();
+	if (fCosmicPairsTree){
+	  TTree * tree = fCosmicPairsTree;
 	  if (tree){
 	    Double_t sizeAll=tree->GetZipBytes();
 	    TBranch * br= tree->GetBranch("friendTrack0.fPoints");
@@ -543,7 +592,7 @@ void AliAnalysisTaskFilteredTree::ProcessCosmics(AliESDEvent *const event, AliES
       }
       if(!fFillTree) return;
       if(!fTreeSRedirector) return;
-      (*fTreeSRedirector)<<"CosmicPairs"<<
+      (*fCosmicPairsStream)<<
         "gid="<<gid<<                         // global id of track
         "fileName.="<<&fCurrentFileName<<     // file name
         "runNumber="<<runNumber<<             // run number	    
@@ -750,11 +799,11 @@ void AliAnalysisTaskFilteredTree::Process(AliESDEvent *const esdEvent, AliMCEven
       // vertex
       // TPC-ITS tracks
       //
-      TObjString triggerClass = esdEvent->GetFiredTriggerClasses().Data();
       if(!fFillTree) return;
       if(!fTreeSRedirector) return;
+      TObjString triggerClass = esdEvent->GetFiredTriggerClasses().Data();
       downscaleCounter++;
-      (*fTreeSRedirector)<<"highPt"<<
+      (*fHighPtStream)<<
         "gid="<<gid<<
         "selectionPtMask="<<selectionPtMask<<
         "fileName.="<<&fCurrentFileName<<            
@@ -813,7 +862,7 @@ void AliAnalysisTaskFilteredTree::ProcessLaser(AliESDEvent *const esdEvent, AliM
       Bool_t skipTrack=gRandom->Rndm()>1/(1+TMath::Abs(fFriendDownscaling));
       if (skipTrack) continue;
       if (esdFriend) {if (!esdFriend->TestSkipBit()) friendTrack = (AliESDfriendTrack*)track->GetFriendTrack();} //this guy can be NULL      
-      (*fTreeSRedirector)<<"Laser"<<
+      (*fLaserStream)<<
         "gid="<<gid<<                          // global identifier of event
         "fileName.="<<&fCurrentFileName<<              //
         "runNumber="<<runNumber<<
@@ -1456,8 +1505,8 @@ void AliAnalysisTaskFilteredTree::ProcessAll(AliESDEvent *const esdEvent, AliMCE
 	  friendTrackStore = (gRandom->Rndm()<1./fFriendDownscaling)? friendTrack:0;
 	}
 	if (fFriendDownscaling<=0){
-	  if (((*fTreeSRedirector)<<"highPt").GetTree()){
-	    TTree * tree = ((*fTreeSRedirector)<<"highPt").GetTree();
+	  if (fHighPtTree){
+	    TTree * tree = fHighPtTree;
 	    if (tree){
 	      Double_t sizeAll=tree->GetZipBytes();
 	      TBranch * br= tree->GetBranch("friendTrack.fPoints");
@@ -1518,7 +1567,7 @@ void AliAnalysisTaskFilteredTree::ProcessAll(AliESDEvent *const esdEvent, AliMCE
 	}
         if(fTreeSRedirector && dumpToTree && fFillTree) {
 	  downscaleCounter++;
-          (*fTreeSRedirector)<<"highPt"<<
+          (*fHighPtStream)<<
 	    "downscaleCounter="<<downscaleCounter<<
 	    "weight="<<weight<<                              // downsampling used
 	    "fLowPtTrackDownscaligF="<<fLowPtTrackDownscaligF<<
@@ -1571,7 +1620,7 @@ void AliAnalysisTaskFilteredTree::ProcessAll(AliESDEvent *const esdEvent, AliMCE
             "centralityF="<<centralityF;
 	  // info for 2 track resolution studies and matching efficency studies 
 	  //
-	  (*fTreeSRedirector)<<"highPt"<<
+	  (*fHighPtStream)<<
 	    "paramITS.="<<&paramITS<<                // nearest ITS track  -   chi2 distance at vertex
 	    "paramITSC.="<<&paramITSC<<              // nearest ITS track  -  to constrained track   chi2 distance at vertex
 	    "paramComb.="<<&paramComb<<              // nearest comb. tack -   chi2 distance at inner wall
@@ -1589,7 +1638,7 @@ void AliAnalysisTaskFilteredTree::ProcessAll(AliESDEvent *const esdEvent, AliMCE
             if (!refPHOS) refPHOS = &refDummy;
             TVectorF vtxMCS(3,vtxMC.GetArray());
 	    downscaleCounter++;
-            (*fTreeSRedirector)<<"highPt"<<
+            (*fHighPtStream)<<
               "weightMC="<<weightMC<<                              // downsampling used
               "multMCTrueTracks="<<multMCTrueTracks<<   // mC track multiplicities
               "multMCTracksAll="<<  multMCTracksAll<<   //  mcEvent->GetNumberOfTracks();
@@ -1633,7 +1682,7 @@ void AliAnalysisTaskFilteredTree::ProcessAll(AliESDEvent *const esdEvent, AliMCE
           }
           //finish writing the entry
           AliInfo("writing tree highPt");
-          (*fTreeSRedirector)<<"highPt"<<"\n";
+          (*fHighPtStream)<<"\n";
         }
         //AliSysInfo::AddStamp("filteringTask",iTrack,numberOfTracks,numberOfFriendTracks,(friendTrackStore)?0:1);
         delete tpcInnerC;
@@ -1889,7 +1938,7 @@ void AliAnalysisTaskFilteredTree::ProcessMCEff(AliESDEvent *const esdEvent, AliM
       //
       if(fTreeSRedirector && fFillTree) {
 	downscaleCounter++;
-        (*fTreeSRedirector)<<"MCEffTree"<<
+        (*fMCEffStream)<<
           "fileName.="<<&fCurrentFileName<<
           "gid="<<gid<<                             // global iD to correlate with event properties
           "weight="<<weight<<                       // weight used in downsampling
@@ -2103,22 +2152,6 @@ void AliAnalysisTaskFilteredTree::ProcessV0(AliESDEvent *const esdEvent, AliMCEv
           friendTrackStore1 = 0;
         }
       }
-      if (fFriendDownscaling<=0){
-        if (((*fTreeSRedirector)<<"V0s").GetTree()){
-          TTree * tree = ((*fTreeSRedirector)<<"V0s").GetTree();
-          if (tree){
-            Double_t sizeAll=tree->GetZipBytes();
-            TBranch * br= tree->GetBranch("friendTrack0.fPoints");
-            Double_t sizeFriend=(br!=NULL)?br->GetZipBytes():0;
-            br= tree->GetBranch("friendTrack0.fCalibContainer");
-            if (br) sizeFriend+=br->GetZipBytes();
-            if (sizeFriend*TMath::Abs(fFriendDownscaling)>sizeAll) {
-              friendTrackStore0=0;
-              friendTrackStore1=0;
-            }
-          }
-        }
-      }
 
       //
       // Bool_t isDownscaled = IsV0Downscaled(v0);                   // old selection mask
@@ -2133,10 +2166,27 @@ void AliAnalysisTaskFilteredTree::ProcessV0(AliESDEvent *const esdEvent, AliMCEv
       AliKFParticle kfparticle; //
       Int_t type=GetKFParticle(v0,esdEvent,kfparticle);
       if (type==0) continue;
-      TObjString triggerClass = esdEvent->GetFiredTriggerClasses().Data();
 
       if(!fFillTree) return;
       if(!fTreeSRedirector) return;
+      // friend volume check only for the V0s passing the downscaling
+      if (fFriendDownscaling<=0){
+        if (fV0Tree){
+          TTree * tree = fV0Tree;
+          if (tree){
+            Double_t sizeAll=tree->GetZipBytes();
+            TBranch * br= tree->GetBranch("friendTrack0.fPoints");
+            Double_t sizeFriend=(br!=NULL)?br->GetZipBytes():0;
+            br= tree->GetBranch("friendTrack0.fCalibContainer");
+            if (br) sizeFriend+=br->GetZipBytes();
+            if (sizeFriend*TMath::Abs(fFriendDownscaling)>sizeAll) {
+              friendTrackStore0=0;
+              friendTrackStore1=0;
+            }
+          }
+        }
+      }
+      TObjString triggerClass = esdEvent->GetFiredTriggerClasses().Data();
 
       TVectorD tofClInfo0(6);                        // starting at 2014 - TOF infdo not part of the AliESDtrack
       TVectorD tofClInfo1(6);                        // starting at 2014 - TOF infdo not part of the AliESDtrack
@@ -2177,7 +2227,7 @@ void AliAnalysisTaskFilteredTree::ProcessV0(AliESDEvent *const esdEvent, AliMCEv
         if (fESDtool->IsPileup(track0->GetLabel())) isPileUpMC+=1;
         if (fESDtool->IsPileup(track1->GetLabel())) isPileUpMC+=2;
       }
-      (*fTreeSRedirector)<<"V0s"<<
+      (*fV0Stream)<<
                          "gid="<<gid<<                         //  global id of event
                          "fLowPtV0DownscaligF="<<fLowPtV0DownscaligF<<
                          "weight="<<weight<<                         // downsaplin weight for given particle
@@ -2336,7 +2386,7 @@ void AliAnalysisTaskFilteredTree::ProcessdEdx(AliESDEvent *const esdEvent, AliMC
       }
 	
       downscaleCounter++;
-      (*fTreeSRedirector)<<"dEdx"<<           // high dEdx tree
+      (*fdEdxStream)<<           // high dEdx tree
         "gid="<<gid<<                         // global id
         "fileName.="<<&fCurrentFileName<<     // file name
         "runNumber="<<runNumber<<
@@ -2782,8 +2832,33 @@ void AliAnalysisTaskFilteredTree::FinishTaskOutput()
         AliAnalysisManager::kProofAnalysis)
       deleteTrees=kFALSE;
   }
+  // throughput of the output streams (zipped bytes of the flushed clusters only)
+  TTree *streamTrees[kNOutputStreams] = {fV0Tree, fHighPtTree, fdEdxTree, fLaserTree, fMCEffTree, fCosmicPairsTree};
+  if (fTreeSRedirector && fStreamCounters) for (Int_t i=0; i<kNOutputStreams; i++) {
+    if (!streamTrees[i]) continue;
+    fStreamCounters->SetBinContent(i+1,1,streamTrees[i]->GetEntries());
+    fStreamCounters->SetBinContent(i+1,2,streamTrees[i]->GetTotBytes());
+    fStreamCounters->SetBinContent(i+1,3,streamTrees[i]->GetZipBytes());
+    AliInfo(Form("Stream %s: entries=%lld totBytes=%lld zipBytes=%lld",fStreamCounters->GetXaxis()->GetBinLabel(i+1),
+                 streamTrees[i]->GetEntries(),streamTrees[i]->GetTotBytes(),streamTrees[i]->GetZipBytes()));
+  }
   if (deleteTrees) delete fTreeSRedirector;
   fTreeSRedirector=NULL;
+  fHighPtStream=fV0Stream=fdEdxStream=fLaserStream=fMCEffStream=fCosmicPairsStream=NULL;
+  DisableImplicitMT();
+}
+
+//_____________________________________________________________________________
+void AliAnalysisTaskFilteredTree::DisableImplicitMT()
+{
+  //
+  // Disable the implicit MT pool if it was enabled by this task
+  //
+  if (!fImplicitMTEnabled) return;
+#ifdef R__USE_IMT
+  ROOT::DisableImplicitMT();
+#endif
+  fImplicitMTEnabled=kFALSE;
 }
 
 //_____________________________________________________________________________
@@ -22,6 +22,10 @@
    3.) "Laser"      - dump laser tracks with space points if exists
    4.) "CosmicTree" - cosmic track candidate (random or triggered) + esdTracks(up/down)+ optional points
    5.) "dEdx"       - tree with high dEdx tpc tracks
+
+   Output streams - trees are filled through the stream handles registered in UserCreateOutputObjects
+     cluster size per stream: SetStreamAutoFlush, parallel basket compression: SetNumberOfWriterThreads
+     entries and bytes written per stream are stored in the histogram "streamCounters"
 */
 class AliESDEvent;
 class AliMCEvent;
@@ -42,7 +46,9 @@ class TList;
 class TObjArray;
 class TTree;
 class TTreeSRedirector;
+class TTreeStream;
 class TParticle;
+class TH2D;
 class TH3D;
 class AliESDtools;
 #include <string>
@@ -117,6 +123,11 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
   void SetLowPtTrackDownscaligF(Double_t fact) { fLowPtTrackDownscaligF = fact; }
   void SetLowPtV0DownscaligF(Double_t fact)    { fLowPtV0DownscaligF = fact; }
   void SetFriendDownscaling(Double_t fact)    { fFriendDownscaling = fact; }
+  //
+  // output streams (trees filled through the TTreeSRedirector)
+  enum EOutputStream { kV0Stream=0, kHighPtStream, kdEdxStream, kLaserStream, kMCEffStream, kCosmicPairsStream, kNOutputStreams };
+  void SetStreamAutoFlush(EOutputStream stream, Long64_t n) { fStreamAutoFlush[stream] = n; } // cluster size of the stream (entries if >0, bytes if <0, 0 - ROOT default)
+  void SetNumberOfWriterThreads(Int_t n) { fNumberOfWriterThreads = n; }                   // threads compressing the baskets of the streams (ROOT IMT)
   
   void   SetProcessCosmics(Bool_t flag) { fProcessCosmics = flag; }
   Bool_t GetProcessCosmics() { return fProcessCosmics; }
@@ -177,6 +188,9 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
   
   Bool_t fProcessCosmics; // look for cosmic pairs from random trigger
   Bool_t fProcessITSTPCmatchOut;  // switch to process ITS/TPC standalone tracks
+  Long64_t fStreamAutoFlush[kNOutputStreams]; // cluster size of each output stream (entries if >0, bytes if <0, 0 - ROOT default)
+  Int_t fNumberOfWriterThreads;   // number of threads compressing the baskets of the output streams, 0: compression on the event loop
+  Bool_t fImplicitMTEnabled;      //! the ROOT implicit MT pool was enabled by this task, to be disabled at the end
 
   TTree* fHighPtTree;       //! list send on output slot 0
   TTree* fV0Tree;           //! list send on output slot 0
@@ -184,6 +198,13 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
   TTree* fLaserTree;        //! list send on output slot 0
   TTree* fMCEffTree;        //! list send on output slot 0
   TTree* fCosmicPairsTree;  //! list send on output slot 0
+  TTreeStream* fHighPtStream;       //! pre-registered stream of the highPt tree
+  TTreeStream* fV0Stream;           //! pre-registered stream of the V0s tree
+  TTreeStream* fdEdxStream;         //! pre-registered stream of the dEdx tree
+  TTreeStream* fLaserStream;        //! pre-registered stream of the Laser tree
+  TTreeStream* fMCEffStream;        //! pre-registered stream of the MCEffTree tree
+  TTreeStream* fCosmicPairsStream;  //! pre-registered stream of the CosmicPairs tree
+  TH2D * fStreamCounters;   //! entries and bytes written per output stream
   TH1F * fSelectedTracksMask;   //! histogram of the selected tracks
   TH1F * fSelectedPIDMask;   //! histogram of the selected tracks
   TH1F * fSelectedV0Mask;   //! histogram of the selected tracks
@@ -202,9 +223,11 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
   TObjString fCurrentFileName; // cached value of current file name
   AliESDtrack* fDummyTrack; //! dummy track for tree init
 
+  void DisableImplicitMT();
+
   AliAnalysisTaskFilteredTree(const AliAnalysisTaskFilteredTree&); // not implemented
   AliAnalysisTaskFilteredTree& operator=(const AliAnalysisTaskFilteredTree&); // not implemented
-  ClassDef(AliAnalysisTaskFilteredTree, 1); // example of analysis
+  ClassDef(AliAnalysisTaskFilteredTree, 3); // example of analysis
 };
 
 #endif
@@ -43,6 +43,12 @@
   tree->Draw("AliESDtools::SDumpEventVariables()","AliESDtools::SCalculateEventVariables(Entry$)");
   tools->SetStreamer(0);
   delete pcstream;
+  /// 3.) Batch mode: calculate cached variables once per event and read them as friend tree columns
+  ///     ranges of consecutive entries can be processed in independent jobs and chained in the entry order
+  tools.MakeEventVariablesFriend("eventCache_0.root",0,5000);
+  tools.MakeEventVariablesFriend("eventCache_1.root",5000,5000);
+  AliESDtools::AddEventVariablesFriend(tree,"eventCache_0.root eventCache_1.root");
+  tree->Scan("cache.trackMatchEff.fElements[0]:cache.trackCounters.fElements[4]:cache.meanTPCVertexA:Entry$");
 */
 
 
@@ -1205,6 +1211,79 @@ Int_t AliESDtools::DumpEventVariables() {
   if ( eventInfoMC) delete eventInfoMC;
   return 0;
 }
+/// Batch mode: calculate the cached event and track variables for a range of entries in one pass
+/// and store them in the tree "eventCache" to be used as friend of the ESD tree
+///   * the columns are the vectors used by the static functions (GetTrackCounters, GetVertexInfo, ...)
+///   * ranges of consecutive entries can be processed in independent jobs (the tool uses static instance)
+///     and the outputs chained in the entry order - see AddEventVariablesFriend
+/// \param outputName - output file name
+/// \param firstEntry - first entry of the range
+/// \param nEntries   - number of entries (-1 - up to the end of the tree)
+/// \return           - number of processed entries
+Int_t AliESDtools::MakeEventVariablesFriend(const char *outputName, Int_t firstEntry, Int_t nEntries) {
+  if (fESDtree==nullptr || fEvent==nullptr || fTaskMode) {
+    ::Error("AliESDtools::MakeEventVariablesFriend","Tool not initialized in the tree query mode");
+    return 0;
+  }
+  Int_t lastEntry = fESDtree->GetEntries();
+  if (nEntries>=0 && firstEntry+nEntries<lastEntry) lastEntry=firstEntry+nEntries;
+  if (firstEntry<0 || firstEntry>=lastEntry) {
+    ::Error("AliESDtools::MakeEventVariablesFriend","Invalid entry range %d-%d",firstEntry,lastEntry);
+    return 0;
+  }
+  fgInstance=this;
+  TStopwatch timer;
+  TTreeSRedirector *pcstream = new TTreeSRedirector(outputName,"recreate");
+  for (Int_t entry=firstEntry; entry<lastEntry; entry++){
+    LoadESD(entry,0);
+    CalculateEventVariables();
+    Double_t meanTPCVertexA=fHisTPCVertexA->GetMean();
+    Double_t meanTPCVertexC=fHisTPCVertexC->GetMean();
+    (*pcstream)<<"eventCache"<<
+                     "entry="                << entry                    <<  // entry number in the ESD tree
+                     "trackCounters.="       << fCacheTrackCounters      <<  // track counter
+                     "trackTPCCountersZ.="   << fCacheTrackTPCCountersZ  <<  // track counter in z bins
+                     "trackdEdxRatio.="      << fCacheTrackdEdxRatio     <<  // dEdx counter
+                     "trackNcl.="            << fCacheTrackNcl           <<  // nCluster counter
+                     "trackChi2.="           << fCacheTrackChi2          <<  // Chi2 counter
+                     "trackMatchEff.="       << fCacheTrackMatchEff      <<  // matching efficiency
+                     "tpcVertexInfo.="       << fTPCVertexInfo           <<  // TPC vertex information
+                     "itsVertexInfo.="       << fITSVertexInfo           <<  // ITS vertex information for pile up rejection
+                     "meanTPCVertexA="       << meanTPCVertexA           <<  // mean of the TPC vertex histogram A side
+                     "meanTPCVertexC="       << meanTPCVertexC           <<  // mean of the TPC vertex histogram C side
+                     "\n";
+    if (fVerbose>0 && (entry-firstEntry)%1000==0) ::Info("AliESDtools::MakeEventVariablesFriend","Entry %d",entry);
+  }
+  delete pcstream;
+  timer.Stop();
+  if (fVerbose>0) {
+    ::Info("AliESDtools::MakeEventVariablesFriend","%d entries stored in %s",lastEntry-firstEntry,outputName);
+    timer.Print();
+  }
+  return lastEntry-firstEntry;
+}
+
+/// Add the trees "eventCache" made by MakeEventVariablesFriend as friend of the ESD tree
+/// Friend entries are aligned by the entry number - the files have to cover the ESD tree from the entry 0
+/// in the entry order
+/// \param tree      - input ESD tree
+/// \param fileNames - whitespace separated list of files (in the entry order)
+/// \param alias     - alias of the friend tree
+/// \return          - number of entries in the friend tree
+Int_t AliESDtools::AddEventVariablesFriend(TTree *tree, const char *fileNames, const char *alias) {
+  if (!tree) return 0;
+  TChain *chain = new TChain("eventCache");
+  TObjArray *files = TString(fileNames).Tokenize(" \t\n");
+  for (Int_t i=0; i<files->GetEntries(); i++) chain->AddFile(files->At(i)->GetName());
+  delete files;
+  Int_t entries = chain->GetEntries();
+  if (entries!=tree->GetEntries()) {
+    ::Warning("AliESDtools::AddEventVariablesFriend","Number of cached entries %d differs from the tree entries %lld",entries,tree->GetEntries());
+  }
+  tree->AddFriend(chain,alias);
+  return entries;
+}
+
 /// Set default tree aliases and corresponding metadata for anotation
 /// \param tree - input tree
 /// \return
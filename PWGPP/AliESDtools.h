@@ -37,6 +37,9 @@ class AliESDtools : public TNamed {
   //
   Int_t DumpEventVariables();
   static Int_t SDumpEventVariables(){return fgInstance->DumpEventVariables();}
+  // batch mode - cached variables stored as friend tree columns
+  Int_t MakeEventVariablesFriend(const char *outputName, Int_t firstEntry=0, Int_t nEntries=-1);
+  static Int_t AddEventVariablesFriend(TTree *tree, const char *fileNames, const char *alias="cache");
   // static functions for querying cached variables in TTree formula
   static Int_t    SCalculateEventVariables(Int_t entry){LoadESD(entry,0); return fgInstance->CalculateEventVariables();}
   static Double_t GetTrackCounters(Int_t index, Int_t toolIndex){return (*fgInstance->fCacheTrackCounters)[index];}
@@ -18,7 +18,11 @@
  * Convert Run 2 ESDs to Run 3 prototype AODs (AliAO2D.root).
  */
 
+#include <RConfigure.h>
 #include <TChain.h>
+#include <TEnv.h>
+#include <TROOT.h>
+#include <TSystem.h>
 #include <TTree.h>
 #include <TMath.h>
 #include "AliAnalysisTask.h"
@@ -74,6 +78,16 @@ ULong64_t GetEventIdAsLong(AliVHeader *header)
 
 } // namespace
 
+AliAnalysisTaskAO2Dconverter::AliAnalysisTaskAO2Dconverter()
+    : AliAnalysisTaskSE()
+{
+  // Same "not set" values as the named constructor (0 is a valid setting for both)
+  for (Int_t i = 0; i < kTrees; i++)
+    fTreeCompression[i] = -1;
+  for (Int_t i = 0; i < kPrecisionGroups; i++)
+    fMantissaBits[i] = -1;
+}
+
 AliAnalysisTaskAO2Dconverter::AliAnalysisTaskAO2Dconverter(const char* name)
     : AliAnalysisTaskSE(name)
     , fTrackFilter(Form("AO2Dconverter%s", name), Form("fTrackFilter%s", name))
@@ -104,8 +118,11 @@ AliAnalysisTaskAO2Dconverter::AliAnalysisTaskAO2Dconverter(const char* name)
   DefineOutput(1, TList::Class());
   for (Int_t i = 0; i < kTrees; i++) {
     fTreeStatus[i] = kTRUE;
+    fTreeCompression[i] = -1;
     DefineOutput(2 + i, TTree::Class());
   }
+  for (Int_t i = 0; i < kPrecisionGroups; i++)
+    fMantissaBits[i] = -1;
 }
 
 AliAnalysisTaskAO2Dconverter::~AliAnalysisTaskAO2Dconverter()
@@ -123,12 +140,132 @@ const TString AliAnalysisTaskAO2Dconverter::TreeTitle[kTrees] = { "Collision tre
 
 const TClass* AliAnalysisTaskAO2Dconverter::Generator[kGenerators] = { AliGenEventHeader::Class(), AliGenCocktailEventHeader::Class(), AliGenDPMjetEventHeader::Class(), AliGenEpos3EventHeader::Class(), AliGenEposEventHeader::Class(), AliGenEventHeaderTunedPbPb::Class(), AliGenGeVSimEventHeader::Class(), AliGenHepMCEventHeader::Class(), AliGenHerwigEventHeader::Class(), AliGenHijingEventHeader::Class(), AliGenPythiaEventHeader::Class(), AliGenToyEventHeader::Class() };
 
+const TString AliAnalysisTaskAO2Dconverter::PrecisionName[kPrecisionGroups] = {
+  "CollisionPosition",
+  "CollisionPositionCov",
+  "TrackX",
+  "TrackAlpha",
+  "TrackSnp",
+  "TrackTgl",
+  "Track1Pt",
+  "TrackCovDiag",
+  "TrackCovOffDiag",
+  "TrackSignal",
+  "Tracklets",
+  "McParticleW",
+  "McParticlePos",
+  "McParticleMom",
+  "CaloAmp",
+  "CaloTime",
+  "MuonTr1P",
+  "MuonTrThetaX",
+  "MuonTrThetaY",
+  "MuonTrZmu",
+  "MuonTrBend",
+  "MuonTrNonBend",
+  "MuonTrCov",
+  "MuonCl",
+  "MuonClErr",
+  "ADTime",
+};
+
+// Bits of mantissa kept by the default truncation (SetTruncation)
+const Int_t AliAnalysisTaskAO2Dconverter::DefaultMantissaBits[kPrecisionGroups] = {19, 10, 19, 19, 15, 15, 13, 15, 7, 15, 15, 19, 19, 19, 15, 15, 13, 15, 15, 19, 19, 19, 7, 15, 7, 11};
+
 TTree* AliAnalysisTaskAO2Dconverter::CreateTree(TreeIndex t)
 {
   fTree[t] = new TTree(TreeName[t], TreeTitle[t]);
+  fTree[t]->SetAutoFlush(fTreeAutoFlush[t] != 0 ? fTreeAutoFlush[t] : fNumberOfEventsPerCluster);
+#ifdef R__USE_IMT
+  // With implicit MT the baskets of the branches are compressed in parallel when a cluster is flushed
+  fTree[t]->SetImplicitMT(fNumberOfWriterThreads > 0);
+#endif
   return fTree[t];
 }
 
+void AliAnalysisTaskAO2Dconverter::SetFixedPoint(PrecisionGroup g, Float_t min, Float_t max, Int_t bits)
+{
+  if (bits < 1 || bits > 24 || max <= min)
+    AliFatal(Form("Invalid fixed point settings for %s: [%g, %g] with %d bits", PrecisionName[g].Data(), min, max, bits));
+  fFixedPointBits[g] = bits;
+  fFixedPointMin[g] = min;
+  fFixedPointMax[g] = max;
+}
+
+Bool_t AliAnalysisTaskAO2Dconverter::LoadPrecisionProfile(const char* filename)
+{
+  // Read the precision profile from a TEnv file. Each line sets one group:
+  //   TrackCovDiag:  12                  (bits of mantissa)
+  //   CaloTime:      fixed -100 100 12   (fixed point in [-100, 100] with 12 bits)
+  // Groups which are not listed are left unchanged
+  if (gSystem->AccessPathName(filename)) {
+    AliError(Form("Precision profile %s not found", filename));
+    return kFALSE;
+  }
+  TEnv env(filename);
+  for (Int_t i = 0; i < kPrecisionGroups; i++) {
+    TString value = env.GetValue(PrecisionName[i], "");
+    value = value.Strip(TString::kBoth);
+    if (value.IsNull())
+      continue;
+    Float_t min = 0, max = 0;
+    Int_t bits = -1;
+    if (value.BeginsWith("fixed")) {
+      if (sscanf(value.Data(), "fixed %f %f %d", &min, &max, &bits) != 3) {
+        AliError(Form("Cannot parse the fixed point settings of %s: %s", PrecisionName[i].Data(), value.Data()));
+        return kFALSE;
+      }
+      SetFixedPoint((PrecisionGroup)i, min, max, bits);
+    } else {
+      if (!value.IsDigit() || (bits = value.Atoi()) > 23) {
+        AliError(Form("Invalid number of mantissa bits for %s: %s", PrecisionName[i].Data(), value.Data()));
+        return kFALSE;
+      }
+      SetMantissaBits((PrecisionGroup)i, bits);
+    }
+  }
+  return kTRUE;
+}
+
+void AliAnalysisTaskAO2Dconverter::InitPrecision()
+{
+  // Set up the precision masks used to truncate the corresponding float data members
+  // No compression for ZDC and Run2 VZERO for the moment
+  for (Int_t i = 0; i < kPrecisionGroups; i++) {
+    Int_t bits = fMantissaBits[i] >= 0 ? TMath::Min(fMantissaBits[i], 23) : (fTruncate ? DefaultMantissaBits[i] : 23);
+    fPrecisionMask[i] = 0xFFFFFFFF << (23 - bits);
+    fPrecisionStep[i] = fFixedPointBits[i] > 0 ? (fFixedPointMax[i] - fFixedPointMin[i]) / ((1 << fFixedPointBits[i]) - 1) : 0;
+    fMaxRelError[i] = 0;
+    fNTruncated[i] = 0;
+  }
+}
+
+void AliAnalysisTaskAO2Dconverter::PrintPrecisionReport() const
+{
+  Printf("AliAnalysisTaskAO2Dconverter: precision of the float members");
+  Printf("%-22s %-24s %14s %14s", "group", "precision", "values", "max rel. error");
+  for (Int_t i = 0; i < kPrecisionGroups; i++) {
+    TString precision = fPrecisionStep[i] > 0
+      ? Form("fixed [%g, %g] %d bits", fFixedPointMin[i], fFixedPointMax[i], fFixedPointBits[i])
+      : Form("%d bits mantissa", 23 - TMath::Nint(TMath::Log2(~fPrecisionMask[i] + 1.)));
+    Printf("%-22s %-24s %14llu %14.3g", PrecisionName[i].Data(), precision.Data(), fNTruncated[i], fMaxRelError[i]);
+  }
+}
+
+void AliAnalysisTaskAO2Dconverter::ConfigureTree(TreeIndex t)
+{
+  // Apply the basket size and compression settings to the branches of the tree
+  if (!fTree[t] || !fTreeStatus[t])
+    return;
+  if (fTreeBasketSize[t] > 0)
+    fTree[t]->SetBasketSize("*", fTreeBasketSize[t]);
+  if (fTreeCompression[t] >= 0) {
+    TIter next(fTree[t]->GetListOfBranches());
+    while (TBranch* branch = (TBranch*)next())
+      branch->SetCompressionSettings(fTreeCompression[t]);
+  }
+}
+
 void AliAnalysisTaskAO2Dconverter::PostTree(TreeIndex t)
 {
   if (!fTreeStatus[t])
@@ -167,6 +304,17 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   fOffsetV0ID = 0;
   fOffsetLabel = 0;
 
+  InitPrecision();
+
+  // Pool of threads used by ROOT to compress the baskets of the output trees
+  if (fNumberOfWriterThreads > 0) {
+#ifdef R__USE_IMT
+    ROOT::EnableImplicitMT(fNumberOfWriterThreads);
+#else
+    AliWarning("ROOT built without implicit MT support: the baskets are compressed on the event loop");
+#endif
+  }
+
   // create output objects
   OpenFile(1); // Necessary for large outputs
 
@@ -188,7 +336,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associate branches for fEventTree
   TTree* tEvents = CreateTree(kEvents);
-  tEvents->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kEvents]) {
     tEvents->Branch("fBCsID", &collision.fBCsID, "fBCsID/I");
     tEvents->Branch("fPosX", &collision.fPosX, "fPosX/F");
@@ -210,7 +357,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   
   // Extra information for debugging for event table
   TTree* tEventsExtra = CreateTree(kEventsExtra);
-  tEventsExtra->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kEventsExtra]) {
     TString sstart = TString::Format("fStart[%d]/I", kTrees);
     TString sentries = TString::Format("fNentries[%d]/I", kTrees);
@@ -221,7 +367,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associate branches for fEventTree
   TTree* tBC = CreateTree(kBC);
-  tBC->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kBC]) {
     tBC->Branch("fRunNumber", &bc.fRunNumber, "fRunNumber/I");
     tBC->Branch("fGlobalBC", &bc.fGlobalBC, "fGlobalBC/l");
@@ -231,7 +376,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   
   // Associate branches for fTrackTree
   TTree* tTracks = CreateTree(kTracks);
-  tTracks->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kTracks]) {
     tTracks->Branch("fCollisionsID", &tracks.fCollisionsID, "fCollisionsID/I");
     tTracks->Branch("fTrackType", &tracks.fTrackType, "fTrackType/b");
@@ -283,7 +427,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associate branches for Calo
   TTree* tCalo = CreateTree(kCalo);
-  tCalo->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kCalo]) {
     tCalo->Branch("fBCsID", &calo.fBCsID, "fBCsID/I");
     tCalo->Branch("fCellNumber", &calo.fCellNumber, "fCellNumber/S");
@@ -295,7 +438,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   PostTree(kCalo);
 
   TTree *tCaloTrigger = CreateTree(kCaloTrigger);
-  tCaloTrigger->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kCaloTrigger]) {
     tCaloTrigger->Branch("fBCsID", &calotrigger.fBCsID, "fBCsID/I");
     tCaloTrigger->Branch("fFastOrAbsID", &calotrigger.fFastOrAbsID, "fFastOrAbsID/S");
@@ -309,7 +451,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associuate branches for MUON tracks
   TTree* tMuon = CreateTree(kMuon);
-  tMuon->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kMuon]) {
     tMuon->Branch("fBCsID", &muons.fBCsID, "fBCsID/I");
 //    tMuon->Branch("fClusterIndex", &muons.fClusterIndex, "fClusterIndex/I");
@@ -328,7 +469,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associate branches for MUON tracks
   TTree* tMuonCls = CreateTree(kMuonCls);
-  tMuonCls->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kMuonCls]) {
     tMuonCls->Branch("fMuonsID",&mucls.fMuonsID,"fMuonsID/I");
     tMuonCls->Branch("fX",&mucls.fX,"fX/F");
@@ -343,7 +483,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associuate branches for ZDC
   TTree* tZdc = CreateTree(kZdc);
-  tZdc->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kZdc]) {
     tZdc->Branch("fBCsID",           &zdc.fBCsID          , "fBCsID/I");
     tZdc->Branch("fEnergyZEM1",      &zdc.fEnergyZEM1     , "fEnergyZEM1/F");
@@ -368,7 +507,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associuate branches for VZERO
   TTree* tVzero = CreateTree(kRun2V0);
-  tVzero->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kRun2V0]) {
     tVzero->Branch("fBCsID", &vzero.fBCsID, "fBCsID/I");
     tVzero->Branch("fAdc", vzero.fAdc, "fAdc[64]/F");
@@ -385,7 +523,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associate branches for FDD (AD)
   TTree* tFDD = CreateTree(kFDD);
-  tFDD->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kFDD]) {
     tFDD->Branch("fBCsID", &fdd.fBCsID, "fBCsID/I");
     tFDD->Branch("fAmplitude", fdd.fAmplitude, "fAmplitude[8]/F");
@@ -398,7 +535,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   
   // Associuate branches for V0s
   TTree* tV0s = CreateTree(kV0s);
-  tV0s->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kV0s]) {
     tV0s->Branch("fPosTrackID", &v0s.fPosTrackID, "fPosTrackID/I");
     tV0s->Branch("fNegTrackID", &v0s.fNegTrackID, "fNegTrackID/I");
@@ -407,7 +543,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associuate branches for cascades
   TTree* tCascades = CreateTree(kCascades);
-  tCascades->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kCascades]) {
     tCascades->Branch("fV0sID", &cascs.fV0sID, "fV0sID/I");
     tCascades->Branch("fTracksID", &cascs.fTracksID, "fTracksID/I");
@@ -417,7 +552,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 #ifdef USE_TOF_CLUST
   // Associate branches for TOF
   TTree* TOF = CreateTree(kTOF);
-  TOF->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kTOF]) {
     TOF->Branch("fTOFChannel", &tofClusters.fTOFChannel, "fTOFChannel/I");
     TOF->Branch("fTOFncls", &tofClusters.fTOFncls, "fTOFncls/S");
@@ -430,7 +564,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   if (fTaskMode == kMC) {
     TTree * tMCvtx = CreateTree(kMcCollision);
-    tMCvtx->SetAutoFlush(fNumberOfEventsPerCluster);
     if(fTreeStatus[kMcCollision]) {
       tMCvtx->Branch("fBCsID", &mccollision.fBCsID, "fBCsID/I");
       tMCvtx->Branch("fGeneratorsID", &mccollision.fGeneratorsID, "fGeneratorsID/S");
@@ -445,7 +578,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
     // Associate branches for Kinematics
     TTree* Kinematics = CreateTree(kMcParticle);
-    Kinematics->SetAutoFlush(fNumberOfEventsPerCluster);
     if (fTreeStatus[kMcParticle]) {
       Kinematics->Branch("fMcCollisionsID", &mcparticle.fMcCollisionsID, "fMcCollisionsID/I");
 
@@ -473,7 +605,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
     // MC labels of each reconstructed track
     TTree* tLabels = CreateTree(kMcTrackLabel);
-    tLabels->SetAutoFlush(fNumberOfEventsPerCluster);
     if (fTreeStatus[kMcTrackLabel]) {
       tLabels->Branch("fLabel", &mctracklabel.fLabel, "fLabel/i");
       tLabels->Branch("fLabelMask", &mctracklabel.fLabelMask, "fLabelMask/s");
@@ -482,7 +613,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
     // MC labels of each reconstructed calo cluster
     TTree* tCaloLabels = CreateTree(kMcCaloLabel);
-    tCaloLabels->SetAutoFlush(fNumberOfEventsPerCluster);
     if (fTreeStatus[kMcCaloLabel]) {
       tCaloLabels->Branch("fLabel", &mccalolabel.fLabel, "fLabel/i");
       tCaloLabels->Branch("fLabelMask", &mccalolabel.fLabelMask, "fLabelMask/s");
@@ -491,7 +621,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
     // MC labels of each reconstructed calo cluster
     TTree* tCollisionLabels = CreateTree(kMcCollisionLabel);
-    tCollisionLabels->SetAutoFlush(fNumberOfEventsPerCluster);
     if (fTreeStatus[kMcCaloLabel]) {
       tCollisionLabels->Branch("fLabel", &mccollisionlabel.fLabel, "fLabel/i");
       tCollisionLabels->Branch("fLabelMask", &mccollisionlabel.fLabelMask, "fLabelMask/s");
@@ -500,6 +629,9 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 }
 
 
+  for (Int_t i = 0; i < kTrees; i++)
+    ConfigureTree((TreeIndex)i);
+
   Prune(); //Removing all unwanted branches (if any)
 }
 
@@ -528,82 +660,6 @@ void AliAnalysisTaskAO2Dconverter::Prune()
 
 void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
 {
-  // Set up the precision masks used to truncate the corresponding float data members
-
-  // Without truncation
-  
-  UInt_t mCollisionPosition = 0xFFFFFFFF;    // Position in x,y,z
-  UInt_t mCollisionPositionCov = 0xFFFFFFFF; // Covariance matrix and chi2
-
-  UInt_t mTrackX =  0xFFFFFFFF;
-  UInt_t mTrackAlpha = 0xFFFFFFFF;
-  UInt_t mtrackSnp = 0xFFFFFFFF;
-  UInt_t mTrackTgl = 0xFFFFFFFF;
-  UInt_t mTrack1Pt = 0xFFFFFFFF; // Including the momentun at the inner wall of TPC
-  UInt_t mTrackCovDiag = 0xFFFFFFFF; // Including the chi2
-  UInt_t mTrackCovOffDiag = 0xFFFFFFFF;
-  UInt_t mTrackSignal = 0xFFFFFFFF; // PID signals and track length
-
-  UInt_t mTracklets = 0xFFFFFFFF; // tracklet members
-
-  UInt_t mMcParticleW   = 0xFFFFFFFF; // Precision for weight
-  UInt_t mMcParticlePos = 0xFFFFFFFF; // Precision for (x,y,z,t)
-  UInt_t mMcParticleMom = 0xFFFFFFFF; // Precision for (Px,Py,Pz,E)
-
-  UInt_t mCaloAmp = 0xFFFFFFFF;
-  UInt_t mCaloTime = 0xFFFFFFFF;
-
-  UInt_t mMuonTr1P = 0xFFFFFFFF;
-  UInt_t mMuonTrThetaX = 0xFFFFFFFF;
-  UInt_t mMuonTrThetaY = 0xFFFFFFFF;
-  UInt_t mMuonTrZmu = 0xFFFFFFFF;
-  UInt_t mMuonTrBend = 0xFFFFFFFF;
-  UInt_t mMuonTrNonBend = 0xFFFFFFFF;
-  UInt_t mMuonTrCov = 0xFFFFFFFF; // Covariance matrix and chi2
-
-  UInt_t mMuonCl = 0xFFFFFFFF; // Position and charge
-  UInt_t mMuonClErr = 0xFFFFFFFF;
-
-  UInt_t mADTime = 0xFFFFFFFF;
-  
-  // No compression for ZDC and Run2 VZERO for the moment
-
-  if (fTruncate) {
-    mCollisionPosition = 0xFFFFFFF0; // 19 bits mantissa
-    mCollisionPositionCov = 0xFFFFE000; // 10 bits mantissa
-
-    mTrackX =  0xFFFFFFF0; // 19 bits
-    mTrackAlpha = 0xFFFFFFF0; // 19 bits
-    mtrackSnp = 0xFFFFFF00; // 15 bits
-    mTrackTgl = 0xFFFFFF00; // 15 bits
-    mTrack1Pt = 0xFFFFFC00; // 13 bits
-    mTrackCovDiag = 0xFFFFFF00; // 15 bits
-    mTrackCovOffDiag = 0xFFFF0000; // 7 bits
-    mTrackSignal = 0xFFFFFF00; // 15 bits
-
-    mTracklets = 0xFFFFFF00; // 15 bits
-
-    mMcParticleW   = 0xFFFFFFF0; // 19 bits
-    mMcParticlePos = 0xFFFFFFF0; // 19 bits
-    mMcParticleMom = 0xFFFFFFF0; // 19 bits
-
-    mCaloAmp = 0xFFFFFF00; // 15 bits
-    mCaloTime = 0xFFFFFF00; // 15 bits
-
-    mMuonTr1P = 0xFFFFFC00; // 13 bits 
-    mMuonTrThetaX = 0xFFFFFF00; // 15 bits
-    mMuonTrThetaY = 0xFFFFFF00; // 15 bits
-    mMuonTrZmu = 0xFFFFFFF0; // 19 bits
-    mMuonTrBend = 0xFFFFFFF0; // 19 bits
-    mMuonTrNonBend = 0xFFFFFFF0; // 19 bits
-    mMuonTrCov = 0xFFFF0000; // 7 bits
-
-    mMuonCl = 0xFFFFFF00; // 15 bits
-    mMuonClErr = 0xFFFF0000; // 7 bits
-    
-    mADTime = 0xFFFFF000; // 11 bits
-  }
-  
   // Initialisation
 
   const char *kPileupRejType[2] = {"PU_rej", "PU_TPC_rej"};
@@ -691,21 +747,21 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
 
   eventextra.fNentries[kEvents] = 1;  // one entry per vertex
   collision.fBCsID = eventID;
-  collision.fPosX = AliMathBase::TruncateFloatFraction(pvtx->GetX(), mCollisionPosition);
-  collision.fPosY = AliMathBase::TruncateFloatFraction(pvtx->GetY(), mCollisionPosition);
-  collision.fPosZ = AliMathBase::TruncateFloatFraction(pvtx->GetZ(), mCollisionPosition);
+  collision.fPosX = Truncate(pvtx->GetX(), kCollisionPosition);
+  collision.fPosY = Truncate(pvtx->GetY(), kCollisionPosition);
+  collision.fPosZ = Truncate(pvtx->GetZ(), kCollisionPosition);
 
   Double_t covmatrix[6];
   pvtx->GetCovMatrix(covmatrix);
 
-  collision.fCovXX = AliMathBase::TruncateFloatFraction(covmatrix[0], mCollisionPositionCov);
-  collision.fCovXY = AliMathBase::TruncateFloatFraction(covmatrix[1], mCollisionPositionCov);
-  collision.fCovXZ = AliMathBase::TruncateFloatFraction(covmatrix[2], mCollisionPositionCov);
-  collision.fCovYY = AliMathBase::TruncateFloatFraction(covmatrix[3], mCollisionPositionCov);
-  collision.fCovYZ = AliMathBase::TruncateFloatFraction(covmatrix[4], mCollisionPositionCov);
-  collision.fCovZZ = AliMathBase::TruncateFloatFraction(covmatrix[5], mCollisionPositionCov);
+  collision.fCovXX = Truncate(covmatrix[0], kCollisionPositionCov);
+  collision.fCovXY = Truncate(covmatrix[1], kCollisionPositionCov);
+  collision.fCovXZ = Truncate(covmatrix[2], kCollisionPositionCov);
+  collision.fCovYY = Truncate(covmatrix[3], kCollisionPositionCov);
+  collision.fCovYZ = Truncate(covmatrix[4], kCollisionPositionCov);
+  collision.fCovZZ = Truncate(covmatrix[5], kCollisionPositionCov);
 
-  collision.fChi2 = AliMathBase::TruncateFloatFraction(pvtx->GetChi2(), mCollisionPositionCov);
+  collision.fChi2 = Truncate(pvtx->GetChi2(), kCollisionPositionCov);
   collision.fN = (pvtx->GetNDF()+3)/2;
 
   Float_t eventTime[10];
@@ -738,8 +794,8 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   }
 
   // Recalculate unique event time and its resolution
-  collision.fCollisionTime = AliMathBase::TruncateFloatFraction(TMath::Mean(10,eventTime,eventTimeWeight), mCollisionPosition); // Weighted mean of times per momentum interval
-  collision.fCollisionTimeRes = AliMathBase::TruncateFloatFraction(TMath::Sqrt(9./10.)*TMath::Mean(10,eventTimeRes), mCollisionPositionCov); // PH bad approximation
+  collision.fCollisionTime = Truncate(TMath::Mean(10,eventTime,eventTimeWeight), kCollisionPosition); // Weighted mean of times per momentum interval
+  collision.fCollisionTimeRes = Truncate(TMath::Sqrt(9./10.)*TMath::Mean(10,eventTimeRes), kCollisionPositionCov); // PH bad approximation
 
   //---------------------------------------------------------------------------
   // BC data
@@ -784,22 +840,22 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
     tracks.fCollisionsID = eventID;
     tracks.fTrackType = TrackTypeEnum::GlobalTrack;
 
-    tracks.fX = AliMathBase::TruncateFloatFraction(track->GetX(), mTrackX);
-    tracks.fAlpha = AliMathBase::TruncateFloatFraction(track->GetAlpha(), mTrackAlpha);
+    tracks.fX = Truncate(track->GetX(), kTrackX);
+    tracks.fAlpha = Truncate(track->GetAlpha(), kTrackAlpha);
 
     tracks.fY = track->GetY(); // no lossy compression
     tracks.fZ = track->GetZ();
-    tracks.fSnp = AliMathBase::TruncateFloatFraction(track->GetSnp(), mtrackSnp);
-    tracks.fTgl = AliMathBase::TruncateFloatFraction(track->GetTgl(), mTrackTgl);
-    tracks.fSigned1Pt = AliMathBase::TruncateFloatFraction(track->GetSigned1Pt(), mTrack1Pt);
+    tracks.fSnp = Truncate(track->GetSnp(), kTrackSnp);
+    tracks.fTgl = Truncate(track->GetTgl(), kTrackTgl);
+    tracks.fSigned1Pt = Truncate(track->GetSigned1Pt(), kTrack1Pt);
 
     // Modified covariance matrix
     // First sigmas on the diagonal
-    tracks.fSigmaY = AliMathBase::TruncateFloatFraction(TMath::Sqrt(track->GetSigmaY2()), mTrackCovDiag);
-    tracks.fSigmaZ = AliMathBase::TruncateFloatFraction(TMath::Sqrt(track->GetSigmaZ2()), mTrackCovDiag);
-    tracks.fSigmaSnp = AliMathBase::TruncateFloatFraction(TMath::Sqrt(track->GetSigmaSnp2()), mTrackCovDiag);
-    tracks.fSigmaTgl = AliMathBase::TruncateFloatFraction(TMath::Sqrt(track->GetSigmaTgl2()), mTrackCovDiag);
-    tracks.fSigma1Pt = AliMathBase::TruncateFloatFraction(TMath::Sqrt(track->GetSigma1Pt2()), mTrackCovDiag);
+    tracks.fSigmaY = Truncate(TMath::Sqrt(track->GetSigmaY2()), kTrackCovDiag);
+    tracks.fSigmaZ = Truncate(TMath::Sqrt(track->GetSigmaZ2()), kTrackCovDiag);
+    tracks.fSigmaSnp = Truncate(TMath::Sqrt(track->GetSigmaSnp2()), kTrackCovDiag);
+    tracks.fSigmaTgl = Truncate(TMath::Sqrt(track->GetSigmaTgl2()), kTrackCovDiag);
+    tracks.fSigma1Pt = Truncate(TMath::Sqrt(track->GetSigma1Pt2()), kTrackCovDiag);
     //
     tracks.fRhoZY = (Char_t)(128.*track->GetSigmaZY()/tracks.fSigmaZ/tracks.fSigmaY);
     tracks.fRhoSnpY = (Char_t)(128.*track->GetSigmaSnpY()/tracks.fSigmaSnp/tracks.fSigmaY);
@@ -813,7 +869,7 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
     tracks.fRho1PtTgl = (Char_t)(128.*track->GetSigma1PtTgl()/tracks.fSigma1Pt/tracks.fSigmaTgl);
 
     const AliExternalTrackParam *intp = track->GetTPCInnerParam();
-    tracks.fTPCinnerP = AliMathBase::TruncateFloatFraction((intp ? intp->GetP() : 0), mTrack1Pt); // Set the momentum to 0 if the track did not reach TPC
+    tracks.fTPCinnerP = Truncate((intp ? intp->GetP() : 0), kTrack1Pt); // Set the momentum to 0 if the track did not reach TPC
 
     tracks.fFlags = track->GetStatus();
 
@@ -829,15 +885,15 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
       if (track->GetTRDslice(i)>0)
         tracks.fTRDPattern |= 0x1<<i; // flag tracklet on this layer
 
-    tracks.fITSChi2NCl = AliMathBase::TruncateFloatFraction((track->GetITSNcls() ? track->GetITSchi2() / track->GetITSNcls() : 0), mTrackCovOffDiag);
-    tracks.fTPCChi2NCl = AliMathBase::TruncateFloatFraction((track->GetTPCNcls() ? track->GetTPCchi2() / track->GetTPCNcls() : 0), mTrackCovOffDiag);
-    tracks.fTRDChi2 = AliMathBase::TruncateFloatFraction(track->GetTRDchi2(), mTrackCovOffDiag);
-    tracks.fTOFChi2 = AliMathBase::TruncateFloatFraction(track->GetTOFchi2(), mTrackCovOffDiag);
+    tracks.fITSChi2NCl = Truncate((track->GetITSNcls() ? track->GetITSchi2() / track->GetITSNcls() : 0), kTrackCovOffDiag);
+    tracks.fTPCChi2NCl = Truncate((track->GetTPCNcls() ? track->GetTPCchi2() / track->GetTPCNcls() : 0), kTrackCovOffDiag);
+    tracks.fTRDChi2 = Truncate(track->GetTRDchi2(), kTrackCovOffDiag);
+    tracks.fTOFChi2 = Truncate(track->GetTOFchi2(), kTrackCovOffDiag);
 
-    tracks.fTPCSignal = AliMathBase::TruncateFloatFraction(track->GetTPCsignal(), mTrackSignal);
-    tracks.fTRDSignal = AliMathBase::TruncateFloatFraction(track->GetTRDsignal(), mTrackSignal);
-    tracks.fTOFSignal = AliMathBase::TruncateFloatFraction(track->GetTOFsignal(), mTrackSignal);
-    tracks.fLength = AliMathBase::TruncateFloatFraction(track->GetIntegratedLength(), mTrackSignal);
+    tracks.fTPCSignal = Truncate(track->GetTPCsignal(), kTrackSignal);
+    tracks.fTRDSignal = Truncate(track->GetTRDsignal(), kTrackSignal);
+    tracks.fTOFSignal = Truncate(track->GetTOFsignal(), kTrackSignal);
+    tracks.fLength = Truncate(track->GetIntegratedLength(), kTrackSignal);
 
     // Speed of ligth in TOF units
     const Float_t cspeed = 0.029979246f;
@@ -848,10 +904,10 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
         (track->GetIntegratedLength() /
          TOFResponse.GetExpectedSignal(track, tof_pid) / cspeed);
 
-    tracks.fTOFExpMom = AliMathBase::TruncateFloatFraction(
+    tracks.fTOFExpMom = Truncate(
         AliPID::ParticleMass(tof_pid) * exp_beta * cspeed /
             TMath::Sqrt(1. - (exp_beta * exp_beta)),
-        mTrack1Pt);
+        kTrack1Pt);
 
     if (fTaskMode == kMC) {
       // Separate tables (trees) for the MC labels
@@ -944,7 +1000,7 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
       // inversion formulas for snp and alpha
       tracks.fSnp = 0.;
       alpha = phi;
-      tracks.fAlpha = AliMathBase::TruncateFloatFraction(alpha, mTracklets);
+      tracks.fAlpha = Truncate(alpha, kTracklets);
 
       // inversion formulas for tgl
       x = (TMath::Tan(theta/2.)-1.) / (TMath::Tan(theta/2.)+1.);
@@ -952,7 +1008,7 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
         tgl = TMath::Sqrt((TMath::Power((1.+TMath::Power(x,2))/(1.-TMath::Power(x,2)),2))-1.);
       else 
         tgl = - TMath::Sqrt((TMath::Power((1.+TMath::Power(x,2))/(1.-TMath::Power(x,2)),2))-1.);
-      tracks.fTgl = AliMathBase::TruncateFloatFraction(tgl, mTracklets);
+      tracks.fTgl = Truncate(tgl, kTracklets);
     
       // set global track parameters to NAN
       tracks.fX = NAN;
@@ -1028,8 +1084,8 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
     
     cells->GetCell(ice, cellNumber, amplitude, time, mclabel, efrac);
     calo.fCellNumber = cellNumber;
-    calo.fAmplitude = AliMathBase::TruncateFloatFraction(amplitude, mCaloAmp);
-    calo.fTime = AliMathBase::TruncateFloatFraction(time, mCaloAmp);
+    calo.fAmplitude = Truncate(amplitude, kCaloAmp);
+    calo.fTime = Truncate(time, kCaloAmp);
     calo.fCaloType = cells->GetType(); // common for all cells
     calo.fCellType = cells->GetHighGain(ice) ? 0. : 1.; 
     FillTree(kCalo);
@@ -1055,9 +1111,9 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
     geo->GetTriggerMapping()->GetAbsFastORIndexFromPositionInEMCAL(col, row, fastorID);
     calotrigger.fFastOrAbsID = fastorID;
     calotriggers->GetAmplitude(calotrigger.fL0Amplitude);
-    calotrigger.fL0Amplitude = AliMathBase::TruncateFloatFraction(calotrigger.fL0Amplitude, mCaloAmp);
+    calotrigger.fL0Amplitude = Truncate(calotrigger.fL0Amplitude, kCaloAmp);
     calotriggers->GetTime(calotrigger.fL0Time);
-    calotrigger.fL0Time = AliMathBase::TruncateFloatFraction(calotrigger.fL0Time, mCaloTime);
+    calotrigger.fL0Time = Truncate(calotrigger.fL0Time, kCaloTime);
     calotriggers->GetTriggerBits(calotrigger.fTriggerBits);
     Int_t nL0times;
     calotriggers->GetNL0Times(nL0times);
@@ -1084,8 +1140,8 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
     
     cells->GetCell(icp, cellNumber, amplitude, time, mclabel, efrac);
     calo.fCellNumber = cellNumber;
-    calo.fAmplitude = AliMathBase::TruncateFloatFraction(amplitude, mCaloAmp);
-    calo.fTime = AliMathBase::TruncateFloatFraction(time, mCaloTime);
+    calo.fAmplitude = Truncate(amplitude, kCaloAmp);
+    calo.fTime = Truncate(time, kCaloTime);
     calo.fCellType = cells->GetHighGain(icp) ? 0. : 1.;     /// @TODO cell type value to be confirmed by PHOS experts
     calo.fCaloType = cells->GetType(); // common for all cells
 
@@ -1111,21 +1167,21 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   for (Int_t imu=0; imu<nmu; ++imu) {
     AliESDMuonTrack* mutrk = fESD->GetMuonTrack(imu);
 
-    muons.fInverseBendingMomentum = AliMathBase::TruncateFloatFraction(mutrk->GetInverseBendingMomentum(), mMuonTr1P);
-    muons.fThetaX = AliMathBase::TruncateFloatFraction(mutrk->GetThetaX(), mMuonTrThetaX);
-    muons.fThetaY = AliMathBase::TruncateFloatFraction(mutrk->GetThetaY(), mMuonTrThetaY);
-    muons.fZMu = AliMathBase::TruncateFloatFraction(mutrk->GetZ(), mMuonTrZmu);
-    muons.fBendingCoor = AliMathBase::TruncateFloatFraction(mutrk->GetBendingCoor(), mMuonTrBend);
-    muons.fNonBendingCoor = AliMathBase::TruncateFloatFraction(mutrk->GetNonBendingCoor(), mMuonTrNonBend);
+    muons.fInverseBendingMomentum = Truncate(mutrk->GetInverseBendingMomentum(), kMuonTr1P);
+    muons.fThetaX = Truncate(mutrk->GetThetaX(), kMuonTrThetaX);
+    muons.fThetaY = Truncate(mutrk->GetThetaY(), kMuonTrThetaY);
+    muons.fZMu = Truncate(mutrk->GetZ(), kMuonTrZmu);
+    muons.fBendingCoor = Truncate(mutrk->GetBendingCoor(), kMuonTrBend);
+    muons.fNonBendingCoor = Truncate(mutrk->GetNonBendingCoor(), kMuonTrNonBend);
 
     TMatrixD cov;
     mutrk->GetCovariances(cov);
     for (Int_t i = 0; i < 5; i++)
       for (Int_t j = 0; j <= i; j++)
-	muons.fCovariances[i*(i+1)/2 + j] = AliMathBase::TruncateFloatFraction(cov(i,j), mMuonTrCov);
+	muons.fCovariances[i*(i+1)/2 + j] = Truncate(cov(i,j), kMuonTrCov);
 
-    muons.fChi2 = AliMathBase::TruncateFloatFraction(mutrk->GetChi2(), mMuonTrCov);
-    muons.fChi2MatchTrigger = AliMathBase::TruncateFloatFraction(mutrk->GetChi2MatchTrigger(), mMuonTrCov);
+    muons.fChi2 = Truncate(mutrk->GetChi2(), kMuonTrCov);
+    muons.fChi2MatchTrigger = Truncate(mutrk->GetChi2MatchTrigger(), kMuonTrCov);
 
     // Now MUON clusters for the current track
     Int_t muTrackID = fOffsetMuTrackID + imu;
@@ -1133,13 +1189,13 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
     for (Int_t imucl=0; imucl<nmucl; ++imucl){
       AliESDMuonCluster *muCluster = fESD->FindMuonCluster(mutrk->GetClusterId(imucl));
       mucls.fMuonsID = muTrackID;
-      mucls.fX = AliMathBase::TruncateFloatFraction(muCluster->GetX(), mMuonCl);
-      mucls.fY = AliMathBase::TruncateFloatFraction(muCluster->GetY(), mMuonCl);
-      mucls.fZ = AliMathBase::TruncateFloatFraction(muCluster->GetZ(), mMuonCl);
-      mucls.fErrX = AliMathBase::TruncateFloatFraction(muCluster->GetErrX(), mMuonClErr);
-      mucls.fErrY = AliMathBase::TruncateFloatFraction(muCluster->GetErrY(), mMuonClErr);
-      mucls.fCharge = AliMathBase::TruncateFloatFraction(muCluster->GetCharge(), mMuonCl);
-      mucls.fChi2   = AliMathBase::TruncateFloatFraction(muCluster->GetChi2(), mMuonClErr);
+      mucls.fX = Truncate(muCluster->GetX(), kMuonCl);
+      mucls.fY = Truncate(muCluster->GetY(), kMuonCl);
+      mucls.fZ = Truncate(muCluster->GetZ(), kMuonCl);
+      mucls.fErrX = Truncate(muCluster->GetErrX(), kMuonClErr);
+      mucls.fErrY = Truncate(muCluster->GetErrY(), kMuonClErr);
+      mucls.fCharge = Truncate(muCluster->GetCharge(), kMuonCl);
+      mucls.fChi2   = Truncate(muCluster->GetChi2(), kMuonClErr);
       FillTree(kMuonCls);
       if (fTreeStatus[kMuonCls]) nmucl_filled++;
     } // End loop on muon clusters for the current muon track
@@ -1237,8 +1293,8 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   // AD (FDD)
   AliESDAD* esdad = fESD->GetADData();
   fdd.fBCsID = eventID;
-  fdd.fTimeA = AliMathBase::TruncateFloatFraction(esdad->GetADATime(),mADTime);
-  fdd.fTimeC = AliMathBase::TruncateFloatFraction(esdad->GetADCTime(),mADTime);
+  fdd.fTimeA = Truncate(esdad->GetADATime(),kADTime);
+  fdd.fTimeC = Truncate(esdad->GetADCTime(),kADTime);
   FillTree(kFDD);
   if (fTreeStatus[kFDD]) eventextra.fNentries[kFDD] = 1;
   
@@ -1335,17 +1391,17 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
       if (mcparticle.fDaughter0 > -1) mcparticle.fDaughter0+=fOffsetLabel;
       mcparticle.fDaughter1 = particle->GetLastDaughter();
       if (mcparticle.fDaughter1 > -1) mcparticle.fDaughter1+=fOffsetLabel;
-      mcparticle.fWeight = AliMathBase::TruncateFloatFraction(particle->GetWeight(), mMcParticleW);
+      mcparticle.fWeight = Truncate(particle->GetWeight(), kMcParticleW);
 
-      mcparticle.fPx = AliMathBase::TruncateFloatFraction(particle->Px(), mMcParticleMom);
-      mcparticle.fPy = AliMathBase::TruncateFloatFraction(particle->Py(), mMcParticleMom);
-      mcparticle.fPz = AliMathBase::TruncateFloatFraction(particle->Pz(), mMcParticleMom);
-      mcparticle.fE  = AliMathBase::TruncateFloatFraction(particle->Energy(), mMcParticleMom);
+      mcparticle.fPx = Truncate(particle->Px(), kMcParticleMom);
+      mcparticle.fPy = Truncate(particle->Py(), kMcParticleMom);
+      mcparticle.fPz = Truncate(particle->Pz(), kMcParticleMom);
+      mcparticle.fE  = Truncate(particle->Energy(), kMcParticleMom);
 
-      mcparticle.fVx = AliMathBase::TruncateFloatFraction(particle->Vx(), mMcParticlePos);
-      mcparticle.fVy = AliMathBase::TruncateFloatFraction(particle->Vy(), mMcParticlePos);
-      mcparticle.fVz = AliMathBase::TruncateFloatFraction(particle->Vz(), mMcParticlePos);
-      mcparticle.fVt = AliMathBase::TruncateFloatFraction(particle->T(), mMcParticlePos);
+      mcparticle.fVx = Truncate(particle->Vx(), kMcParticlePos);
+      mcparticle.fVy = Truncate(particle->Vy(), kMcParticlePos);
+      mcparticle.fVz = Truncate(particle->Vz(), kMcParticlePos);
+      mcparticle.fVt = Truncate(particle->T(), kMcParticlePos);
 
       FillTree(kMcParticle);
       if (fTreeStatus[kMcParticle]) nkine_filled++;
@@ -1362,13 +1418,13 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
 
     mccollision.fBCsID = eventID;
 
-    mccollision.fPosX = AliMathBase::TruncateFloatFraction(MCvtx->GetX(), mCollisionPosition);
-    mccollision.fPosY = AliMathBase::TruncateFloatFraction(MCvtx->GetY(), mCollisionPosition);
-    mccollision.fPosZ = AliMathBase::TruncateFloatFraction(MCvtx->GetZ(), mCollisionPosition);
+    mccollision.fPosX = Truncate(MCvtx->GetX(), kCollisionPosition);
+    mccollision.fPosY = Truncate(MCvtx->GetY(), kCollisionPosition);
+    mccollision.fPosZ = Truncate(MCvtx->GetZ(), kCollisionPosition);
 
     AliGenEventHeader* mcGenH = MCEvt->GenEventHeader();
-    mccollision.fT = AliMathBase::TruncateFloatFraction(mcGenH->InteractionTime(), mCollisionPosition);
-    mccollision.fWeight = AliMathBase::TruncateFloatFraction(mcGenH->EventWeight(), mCollisionPosition);
+    mccollision.fT = Truncate(mcGenH->InteractionTime(), kCollisionPosition);
+    mccollision.fWeight = Truncate(mcGenH->EventWeight(), kCollisionPosition);
 
     // Impact parameter
     AliCollisionGeometry * cGeo = dynamic_cast<AliCollisionGeometry*>(mcGenH);
@@ -1397,7 +1453,7 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
         }
       }
     }
-    mccollision.fImpactParameter = AliMathBase::TruncateFloatFraction(mccollision.fImpactParameter, mCollisionPosition);
+    mccollision.fImpactParameter = Truncate(mccollision.fImpactParameter, kCollisionPosition);
     eventextra.fNentries[kMcCollision] = 1;
   } else {
     eventextra.fNentries[kMcCollision] = 0;
@@ -1427,6 +1483,12 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   fOffsetV0ID += nv0_filled;
 }
 
+void AliAnalysisTaskAO2Dconverter::FinishTaskOutput()
+{
+  if (fPrecisionReport)
+    PrintPrecisionReport();
+}
+
 void AliAnalysisTaskAO2Dconverter::Terminate(Option_t *)
 {
   // terminate
@@ -9,6 +9,9 @@
 #include "AliAnalysisTaskSE.h"
 #include "AliEventCuts.h"
 
+#include "AliMathBase.h"
+
+#include <TMath.h>
 #include <TString.h>
 
 #include "TClass.h"
@@ -20,7 +23,7 @@ class AliESDEvent;
 class AliAnalysisTaskAO2Dconverter : public AliAnalysisTaskSE
 {
 public:
-  AliAnalysisTaskAO2Dconverter() = default;
+  AliAnalysisTaskAO2Dconverter();
   AliAnalysisTaskAO2Dconverter(const char *name);
   virtual ~AliAnalysisTaskAO2Dconverter();
 
@@ -34,8 +37,10 @@ public:
   virtual void UserCreateOutputObjects();
   virtual void UserExec(Option_t *option);
   virtual void Terminate(Option_t *option);
+  virtual void FinishTaskOutput();
 
   void SetNumberOfEventsPerCluster(int n) { fNumberOfEventsPerCluster = n; }
+  void SetNumberOfWriterThreads(Int_t n) { fNumberOfWriterThreads = n; } // Threads compressing the baskets (ROOT IMT)
 
   virtual void SetTruncation(Bool_t trunc=kTRUE) {fTruncate = trunc;}
 
@@ -96,9 +101,53 @@ public:
   void PostTree(TreeIndex t);
   void EnableTree(TreeIndex t) { fTreeStatus[t] = kTRUE; };
   void DisableTree(TreeIndex t) { fTreeStatus[t] = kFALSE; };
+  // Per-table output settings, by default the ones of the task and of the output file are used
+  void SetTreeAutoFlush(TreeIndex t, Int_t n) { fTreeAutoFlush[t] = n; }                  // Cluster size (entries if >0, bytes if <0)
+  void SetTreeBasketSize(TreeIndex t, Int_t size) { fTreeBasketSize[t] = size; }          // Basket size in bytes
+  void SetTreeCompression(TreeIndex t, Int_t settings) { fTreeCompression[t] = settings; } // Compression settings (e.g. 505)
   static const TString TreeName[kTrees];  //! Names of the TTree containers
   static const TString TreeTitle[kTrees]; //! Titles of the TTree containers
 
+  enum PrecisionGroup { // Groups of float members sharing the same lossy compression
+    kCollisionPosition = 0, // Position in x,y,z and collision time
+    kCollisionPositionCov, // Covariance matrix, chi2 and time resolution
+    kTrackX,
+    kTrackAlpha,
+    kTrackSnp,
+    kTrackTgl,
+    kTrack1Pt, // Including the momentum at the inner wall of TPC
+    kTrackCovDiag,
+    kTrackCovOffDiag, // Including the chi2
+    kTrackSignal, // PID signals and track length
+    kTracklets, // Tracklet members
+    kMcParticleW, // Weight
+    kMcParticlePos, // (x,y,z,t)
+    kMcParticleMom, // (Px,Py,Pz,E)
+    kCaloAmp,
+    kCaloTime,
+    kMuonTr1P,
+    kMuonTrThetaX,
+    kMuonTrThetaY,
+    kMuonTrZmu,
+    kMuonTrBend,
+    kMuonTrNonBend,
+    kMuonTrCov, // Covariance matrix and chi2
+    kMuonCl, // Position and charge
+    kMuonClErr,
+    kADTime,
+    kPrecisionGroups
+  };
+  static const TString PrecisionName[kPrecisionGroups];      //! Names of the precision groups, used as keys in the profiles
+  static const Int_t DefaultMantissaBits[kPrecisionGroups];  //! Mantissa bits kept by default when the truncation is on
+
+  // Precision profile: each group keeps either a number of mantissa bits (0-23) or is
+  // stored in fixed point with the given number of bits within [min, max]. Groups which are
+  // not set use the default of the truncation mode (SetTruncation).
+  void SetMantissaBits(PrecisionGroup g, Int_t bits) { fMantissaBits[g] = bits; fFixedPointBits[g] = 0; }
+  void SetFixedPoint(PrecisionGroup g, Float_t min, Float_t max, Int_t bits);
+  Bool_t LoadPrecisionProfile(const char* filename); // Read the profile from a TEnv file, e.g. "TrackCovDiag: 12" or "CaloTime: fixed -100 100 12"
+  void SetPrecisionReport(Bool_t report = kTRUE) { fPrecisionReport = report; } // Print the maximum relative error per group at the end
+
   void Prune(TString p) { fPruneList = p; }; // Setter of the pruning list
   void SetMCMode() { fTaskMode = kMC; };     // Setter of the MC running mode
   void SetCentralityMethod(const char *method) { fCentralityMethod = method; } // Settter for centrality method
@@ -119,11 +168,19 @@ private:
   TTree* fTree[kTrees] = { nullptr }; //! Array with all the output trees
   void Prune();                       // Function to perform tree pruning
   void FillTree(TreeIndex t);         // Function to fill the trees (only the active ones)
+  void ConfigureTree(TreeIndex t);    // Function to apply the per-table output settings
+  void InitPrecision();               // Function to set up the masks and steps of the precision groups
+  void PrintPrecisionReport() const;  // Function to print the error introduced by the lossy compression
+  Float_t Truncate(Float_t x, PrecisionGroup g); // Lossy compression of a float member
 
   // Task configuration variables
   TString fPruneList = "";                // Names of the branches that will not be saved to output file
   Bool_t fTreeStatus[kTrees] = { kTRUE }; // Status of the trees i.e. kTRUE (enabled) or kFALSE (disabled)
   int fNumberOfEventsPerCluster = 1000;   // Maximum basket size of the trees
+  Int_t fTreeAutoFlush[kTrees] = { 0 };   // Cluster size of each tree, 0: fNumberOfEventsPerCluster
+  Int_t fTreeBasketSize[kTrees] = { 0 };  // Basket size of each tree, 0: ROOT default
+  Int_t fTreeCompression[kTrees] = { 0 }; // Compression settings of each tree, -1 (set in the constructors): output file settings
+  Int_t fNumberOfWriterThreads = 0;       // Number of threads compressing the baskets, 0: compression on the event loop
 
   TaskModes fTaskMode = kStandard; // Running mode of the task. Useful to set for e.g. MC mode
 
@@ -453,6 +510,15 @@ private:
 
   /// Set truncation
   Bool_t fTruncate = kFALSE;
+  Int_t fMantissaBits[kPrecisionGroups] = { 0 };      /// Mantissa bits of each precision group, -1 (set in the constructors): default
+  Int_t fFixedPointBits[kPrecisionGroups] = { 0 };    /// Bits of the fixed point representation, 0: mantissa truncation
+  Float_t fFixedPointMin[kPrecisionGroups] = { 0 };   /// Lower edge of the fixed point range
+  Float_t fFixedPointMax[kPrecisionGroups] = { 0 };   /// Upper edge of the fixed point range
+  Bool_t fPrecisionReport = kFALSE;                   /// Print the maximum relative error per group
+  UInt_t fPrecisionMask[kPrecisionGroups] = { 0 };    //! Mask applied to the float of each group
+  Float_t fPrecisionStep[kPrecisionGroups] = { 0 };   //! Step of the fixed point representation
+  Double_t fMaxRelError[kPrecisionGroups] = { 0 };    //! Maximum relative error of each group
+  ULong64_t fNTruncated[kPrecisionGroups] = { 0 };    //! Number of truncated values of each group
   Bool_t fSkipPileup = kFALSE;       /// Skip pileup events
   Bool_t fSkipTPCPileup = kFALSE;    /// Skip TPC pileup (SetRejectTPCPileupWithITSTPCnCluCorr)
   TString fCentralityMethod = "V0M"; /// Centrality method
@@ -460,7 +526,25 @@ private:
   TH1F *fCentralityINT7 = nullptr; ///! Centrality histogram for the INT7 triggers
   TH1I *fHistPileupEvents = nullptr; ///! Counter histogram for pileup events
   
-  ClassDef(AliAnalysisTaskAO2Dconverter, 10);
+  ClassDef(AliAnalysisTaskAO2Dconverter, 12);
 };
 
+inline Float_t AliAnalysisTaskAO2Dconverter::Truncate(Float_t x, PrecisionGroup g)
+{
+  Float_t y;
+  if (fPrecisionStep[g] > 0) {
+    // Fixed point: nearest multiple of the step within the range
+    Float_t q = TMath::Nint((TMath::Min(TMath::Max(x, fFixedPointMin[g]), fFixedPointMax[g]) - fFixedPointMin[g]) / fPrecisionStep[g]);
+    y = fFixedPointMin[g] + q * fPrecisionStep[g];
+  } else {
+    y = AliMathBase::TruncateFloatFraction(x, fPrecisionMask[g]);
+  }
+  if (fPrecisionReport) {
+    fNTruncated[g]++;
+    if (x != 0 && TMath::Abs((y - x) / x) > fMaxRelError[g])
+      fMaxRelError[g] = TMath::Abs((y - x) / x);
+  }
+  return y;
+}
+
 #endif